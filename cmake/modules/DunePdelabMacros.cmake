@@ -3,6 +3,28 @@ include(UsePETSc)
 
 find_package(Eigen3)
 
+# The threaded code paths are guarded by _OPENMP. OpenMP is opt-in, and
+# even then only targets passed to add_dune_openmp_flags() are built with it.
+option(DUNE_PDELAB_ENABLE_OPENMP "Build the threaded code paths of dune-pdelab with OpenMP" OFF)
+if(DUNE_PDELAB_ENABLE_OPENMP)
+  find_package(OpenMP)
+endif(DUNE_PDELAB_ENABLE_OPENMP)
+
+# AsyncVTKWriter writes in a background thread and can compress its output
+# with zlib.
+set(THREADS_PREFER_PTHREAD_FLAG TRUE)
+find_package(Threads)
+if(CMAKE_THREAD_LIBS_INIT)
+  dune_register_package_flags(LIBRARIES ${CMAKE_THREAD_LIBS_INIT})
+endif(CMAKE_THREAD_LIBS_INIT)
+
+find_package(ZLIB)
+if(ZLIB_FOUND)
+  set(HAVE_ZLIB 1)
+  dune_register_package_flags(INCLUDE_DIRS ${ZLIB_INCLUDE_DIRS}
+                              LIBRARIES ${ZLIB_LIBRARIES})
+endif(ZLIB_FOUND)
+
 function(add_dune_petsc_flags)
   if(PETSC_FOUND)
     cmake_parse_arguments(ADD_PETSC "SOURCE_ONLY;OBJECT" "" "" ${ARGN})
@@ -29,3 +51,12 @@ function(add_dune_petsc_flags)
 
   endif(PETSC_FOUND)
 endfunction(add_dune_petsc_flags)
+
+function(add_dune_openmp_flags)
+  if(OPENMP_FOUND)
+    foreach(_target ${ARGN})
+      set_property(TARGET ${_target} APPEND_STRING PROPERTY COMPILE_FLAGS " ${OpenMP_CXX_FLAGS}")
+      set_property(TARGET ${_target} APPEND_STRING PROPERTY LINK_FLAGS " ${OpenMP_CXX_FLAGS}")
+    endforeach(_target ${ARGN})
+  endif(OPENMP_FOUND)
+endfunction(add_dune_openmp_flags)
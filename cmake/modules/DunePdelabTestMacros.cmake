@@ -9,6 +9,7 @@
 #                [COMPILE_OPTIONS opt1 [, opt2, ...]]
 #                [ALBERTA_GRIDDIM gdim]
 #                [ALBERTA_WORLDDIM wdim]
+#                [OPENMP]
 #  )
 #
 # The macro will do the following steps:
@@ -20,13 +21,14 @@
 #  * parallel test execution.
 #  * add flags for the alberta grid manager through ALBERTA_{GRID,WORLD}DIM. This is necessary,
 #    as Alberta is the only external package that cannot be handled through dune_enable_all_packages()
+#  * build the test with OpenMP through OPENMP, if it has been enabled with DUNE_PDELAB_ENABLE_OPENMP.
 
 # This target will be used to build all tests
 add_custom_target(build_tests)
 
 function(pdelab_add_test)
   include(CMakeParseArguments)
-  set(OPTIONS)
+  set(OPTIONS OPENMP)
   set(SINGLEARGS NAME MPIRANKS ALBERTA_GRIDDIM ALBERTA_WORLDDIM)
   set(MULTIARGS SOURCES COMPILE_DEFINITIONS COMPILE_OPTIONS COMMAND)
   cmake_parse_arguments(PDELABTEST "${OPTIONS}" "${SINGLEARGS}" "${MULTIARGS}" ${ARGN})
@@ -67,6 +69,10 @@ function(pdelab_add_test)
     add_dune_alberta_flags(${PDELABTEST_NAME} GRIDDIM ${PDELABTEST_ALBERTA_GRIDDIM} WORLDDIM ${PDELABTEST_ALBERTA_WORLDDIM})
   endif()
 
+  if(PDELABTEST_OPENMP)
+    add_dune_openmp_flags(${PDELABTEST_NAME})
+  endif()
+
   if("${PDELABTEST_COMMAND}" STREQUAL "")
     set(PDELABTEST_COMMAND "${PDELABTEST_NAME}")
   endif()
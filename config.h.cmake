@@ -61,4 +61,7 @@
 /* Define to 1 if GCC's __typeof__ extension is supported. */
 #cmakedefine HAVE_GCC___TYPEOF__ 1
 
+/* Define to 1 if zlib is available. */
+#cmakedefine HAVE_ZLIB 1
+
 /* end dune-pdelab */
@@ -6,10 +6,14 @@
 
 #include<dune/common/exceptions.hh>
 
+#include<algorithm>
+#include<cassert>
+#include<cmath>
+#include<cstdint>
 #include<limits>
+#include<utility>
 #include<vector>
 #include<map>
-#include<unordered_map>
 #include<dune/common/dynmatrix.hh>
 #include<dune/geometry/quadraturerules.hh>
 #include<dune/pdelab/gridfunctionspace/genericdatahandle.hh>
@@ -196,6 +200,174 @@ namespace Dune {
     };
 
 
+    //! View of the coefficients of a single element stored in a LocalCoefficientArena
+    template<typename T>
+    class LocalCoefficientBlock
+    {
+    public:
+      typedef std::size_t size_type;
+
+      LocalCoefficientBlock()
+        : _data(nullptr)
+        , _size(0)
+      {}
+
+      LocalCoefficientBlock(T* data, size_type size)
+        : _data(data)
+        , _size(size)
+      {}
+
+      T& operator[](size_type i) const
+      {
+        assert(i < _size);
+        return _data[i];
+      }
+
+      size_type size() const
+      {
+        return _size;
+      }
+
+      T* begin() const
+      {
+        return _data;
+      }
+
+      T* end() const
+      {
+        return _data + _size;
+      }
+
+    private:
+      T* _data;
+      size_type _size;
+    };
+
+
+    /*! @class LocalCoefficientArena
+     *
+     * @brief Storage for the local coefficients of many elements, keyed by entity ID
+     *
+     * All coefficient blocks live in a single contiguous array, and an
+     * offset table maps each ID to its block. Blocks are appended while the
+     * data is collected; after finalize(), the table is sorted by ID and
+     * blocks can be looked up by binary search. Compared to a hash map of
+     * vectors, this needs only a handful of allocations, however many
+     * elements are stored.
+     *
+     * The same ID may be appended more than once, as long as all of its
+     * blocks carry the same data; finalize() keeps only one of them.
+     *
+     * @tparam ID Type of the entity IDs, must be less-than comparable
+     * @tparam T  Type of the coefficients
+     */
+    template<typename ID, typename T>
+    class LocalCoefficientArena
+    {
+
+      struct Entry
+      {
+        ID id;
+        std::size_t offset;
+        std::size_t size;
+
+        bool operator<(const Entry& other) const
+        {
+          return id < other.id;
+        }
+      };
+
+    public:
+
+      typedef ID IdType;
+      typedef T ElementType;
+      typedef std::size_t size_type;
+      typedef LocalCoefficientBlock<T> Block;
+      typedef LocalCoefficientBlock<const T> ConstBlock;
+
+      LocalCoefficientArena()
+        : _finalized(true)
+      {}
+
+      //! reserve space for the given number of blocks and coefficients
+      void reserve(size_type blocks, size_type coefficients)
+      {
+        _entries.reserve(blocks);
+        _data.reserve(coefficients);
+      }
+
+      //! remove all blocks, but keep the allocated memory
+      void clear()
+      {
+        _entries.clear();
+        _data.clear();
+        _finalized = true;
+      }
+
+      //! append a zero initialized block of n coefficients for the given ID and return its index
+      size_type append(const ID& id, size_type n)
+      {
+        Entry entry = { id, _data.size(), n };
+        _data.resize(_data.size() + n, T(0));
+        _entries.push_back(entry);
+        _finalized = false;
+        return _entries.size() - 1;
+      }
+
+      /** \brief access a block by the index returned from append()
+
+          \note The block is invalidated by the next call to append().
+      */
+      Block block(size_type index)
+      {
+        assert(!_finalized);
+        const Entry& entry = _entries[index];
+        return Block(_data.data() + entry.offset, entry.size);
+      }
+
+      //! sort the offset table and drop duplicate IDs; required before find()
+      void finalize()
+      {
+        std::sort(_entries.begin(),_entries.end());
+        _entries.erase(std::unique(_entries.begin(),_entries.end(),
+                                   [](const Entry& a, const Entry& b) { return a.id == b.id; }),
+                       _entries.end());
+        _finalized = true;
+      }
+
+      //! look up the block of an ID, returns false if there is none
+      bool find(const ID& id, ConstBlock& block) const
+      {
+        assert(_finalized);
+        const Entry key = { id, 0, 0 };
+        typename std::vector<Entry>::const_iterator it = std::lower_bound(_entries.begin(),_entries.end(),key);
+        if (it == _entries.end() || !(it->id == id))
+          return false;
+        block = ConstBlock(_data.data() + it->offset, it->size);
+        return true;
+      }
+
+      //! number of stored blocks
+      size_type size() const
+      {
+        return _entries.size();
+      }
+
+      //! total number of stored coefficients
+      size_type coefficients() const
+      {
+        return _data.size();
+      }
+
+    private:
+
+      std::vector<Entry> _entries;
+      std::vector<T> _data;
+      bool _finalized;
+
+    };
+
+
     template<typename GFS, typename DOFVector, typename TransferMap>
     struct backup_visitor
       : public TypeTree::TreeVisitor
@@ -207,12 +379,14 @@ namespace Dune {
       typedef Dune::PDELab::LeafOffsetCache<GFS> LeafOffsetCache;
 
       typedef typename GFS::Traits::GridView::Grid::LocalIdSet IDSet;
+      typedef typename IDSet::IdType ID;
       typedef typename GFS::Traits::GridView::template Codim<0>::Entity Cell;
       typedef typename Cell::Geometry Geometry;
       static const int dim = Geometry::dimension;
       typedef typename Cell::HierarchicIterator HierarchicIterator;
       typedef typename DOFVector::ElementType RF;
-      typedef typename TransferMap::mapped_type LocalDOFVector;
+      typedef std::vector<RF> LocalDOFVector;
+      typedef typename TransferMap::Block Block;
 
 
       typedef L2Projection<typename LFS::Traits::GridFunctionSpace,DOFVector> Projection;
@@ -265,7 +439,7 @@ namespace Dune {
                 Range x(0.0);
                 for (size_type j = 0; j < inverse_mass_matrix.M(); ++j)
                   x.axpy(inverse_mass_matrix[i][j],coarse_phi[j]);
-                (*_u_coarse)[coarse_offset + i] += factor * (x * val);
+                _u_coarse[coarse_offset + i] += factor * (x * val);
               }
           }
 
@@ -279,9 +453,8 @@ namespace Dune {
         _lfs.bind(_element);
         _lfs_cache.update();
         _u_view.bind(_lfs_cache);
-        _u_coarse = &_transfer_map[_id_set.id(_element)];
-        _u_coarse->resize(_lfs.size());
-        _u_view.read(*_u_coarse);
+        _u_coarse = _transfer_map.block(_transfer_map.append(_id_set.id(_element),_lfs.size()));
+        _u_view.read(_u_coarse);
         _u_view.unbind();
 
         _leaf_offset_cache.update(_element);
@@ -297,12 +470,19 @@ namespace Dune {
 
             _ancestor = _ancestor.father();
 
-            _u_coarse = &_transfer_map[_id_set.id(_ancestor)];
-            // don't project more than once
-            if (_u_coarse->size() > 0)
+            // Siblings are visited one after another, so comparing with the
+            // last ancestor projected on this level avoids almost all repeated
+            // projections. The remaining duplicates carry identical data and
+            // are dropped by the transfer map.
+            const ID ancestor_id = _id_set.id(_ancestor);
+            const size_type level = _ancestor.level();
+            if (_projected.size() <= level)
+              _projected.resize(level + 1,std::make_pair(false,ID()));
+            if (_projected[level].first && _projected[level].second == ancestor_id)
               continue;
-            _u_coarse->resize(_leaf_offset_cache[_ancestor.type()].back());
-            std::fill(_u_coarse->begin(),_u_coarse->end(),RF(0));
+            _projected[level] = std::make_pair(true,ancestor_id);
+
+            _u_coarse = _transfer_map.block(_transfer_map.append(ancestor_id,_leaf_offset_cache[_ancestor.type()].back()));
 
             for (const auto& child : descendantElements(_ancestor,max_level))
               {
@@ -339,7 +519,6 @@ namespace Dune {
         , _projection(projection)
         , _u_view(u)
         , _transfer_map(transfer_map)
-        , _u_coarse(nullptr)
         , _leaf_offset_cache(leaf_offset_cache)
         , _int_order(int_order)
         , _leaf_index(0)
@@ -354,11 +533,12 @@ namespace Dune {
       Projection& _projection;
       typename DOFVector::template ConstLocalView<LFSCache> _u_view;
       TransferMap& _transfer_map;
-      LocalDOFVector* _u_coarse;
+      Block _u_coarse;
       LeafOffsetCache& _leaf_offset_cache;
       size_type _int_order;
       size_type _leaf_index;
       LocalDOFVector _u_fine;
+      std::vector<std::pair<bool,ID> > _projected;
 
     };
 
@@ -378,6 +558,7 @@ namespace Dune {
       typedef typename Cell::Geometry Geometry;
       typedef typename DOFVector::ElementType RF;
       typedef std::vector<RF> LocalDOFVector;
+      typedef LocalCoefficientBlock<const RF> CoarseDOFBlock;
       typedef std::vector<typename CountVector::ElementType> LocalCountVector;
 
       typedef std::size_t size_type;
@@ -396,7 +577,7 @@ namespace Dune {
             y.axpy(_dofs[_offset + i],_phi[i]);
         }
 
-        coarse_function(const FiniteElement& finite_element, Geometry coarse_geometry, Geometry fine_geometry, const LocalDOFVector& dofs, size_type offset)
+        coarse_function(const FiniteElement& finite_element, Geometry coarse_geometry, Geometry fine_geometry, const CoarseDOFBlock& dofs, size_type offset)
           : _finite_element(finite_element)
           , _coarse_geometry(coarse_geometry)
           , _fine_geometry(fine_geometry)
@@ -407,7 +588,7 @@ namespace Dune {
         const FiniteElement& _finite_element;
         Geometry _coarse_geometry;
         Geometry _fine_geometry;
-        const LocalDOFVector& _dofs;
+        CoarseDOFBlock _dofs;
         mutable std::vector<typename FiniteElement::Traits::LocalBasisType::Traits::RangeType> _phi;
         size_type _offset;
 
@@ -423,7 +604,7 @@ namespace Dune {
         size_type element_offset = _leaf_offset_cache[_element.type()][_leaf_index];
         size_type ancestor_offset = _leaf_offset_cache[_ancestor.type()][_leaf_index];
 
-        coarse_function<typename FEM::Traits::FiniteElement> f(fem.find(_ancestor),_ancestor.geometry(),_element.geometry(),*_u_coarse,ancestor_offset);
+        coarse_function<typename FEM::Traits::FiniteElement> f(fem.find(_ancestor),_ancestor.geometry(),_element.geometry(),_u_coarse,ancestor_offset);
         const typename FEM::Traits::FiniteElement& fe = fem.find(_element);
 
         _u_tmp.resize(fe.localBasis().size());
@@ -434,11 +615,11 @@ namespace Dune {
         ++_leaf_index;
       }
 
-      void operator()(const Cell& element, const Cell& ancestor, const LocalDOFVector& u_coarse)
+      void operator()(const Cell& element, const Cell& ancestor, const CoarseDOFBlock& u_coarse)
       {
         _element = element;
         _ancestor = ancestor;
-        _u_coarse = &u_coarse;
+        _u_coarse = u_coarse;
         _lfs.bind(_element);
         _leaf_offset_cache.update(_element);
         _lfs_cache.update();
@@ -449,7 +630,7 @@ namespace Dune {
             _lfs.gridFunctionSpace().gridView().grid().localIdSet().id(ancestor))
           {
             // no interpolation necessary, just copy the saved data
-            _u_view.add(*_u_coarse);
+            _u_view.add(_u_coarse);
           }
         else
           {
@@ -482,7 +663,7 @@ namespace Dune {
       Cell _ancestor;
       typename DOFVector::template LocalView<LFSCache> _u_view;
       typename CountVector::template LocalView<LFSCache> _uc_view;
-      const LocalDOFVector* _u_coarse;
+      CoarseDOFBlock _u_coarse;
       LeafOffsetCache& _leaf_offset_cache;
       size_type _leaf_index;
       LocalDOFVector _u_fine;
@@ -516,7 +697,7 @@ namespace Dune {
       typedef typename IDSet::IdType ID;
 
     public:
-      typedef std::unordered_map<ID,std::vector<typename U::ElementType> > MapType;
+      typedef LocalCoefficientArena<ID,typename U::ElementType> MapType;
 
 
       /*! @brief The constructor.
@@ -536,11 +717,18 @@ namespace Dune {
       {
         typedef backup_visitor<GFSU,U,MapType> Visitor;
 
+        // one block per leaf element plus some room for the vanishing ancestors
+        const std::size_t blocks = grid.leafGridView().size(0) * 3 / 2;
+        transfer_map.clear();
+        transfer_map.reserve(blocks,blocks * gfsu.maxLocalSize());
+
         Visitor visitor(gfsu,projection,u,_leaf_offset_cache,transfer_map);
 
         // iterate over all elems
         for(const auto& cell : elements(grid.leafGridView(),Partitions::interior))
           visitor(cell);
+
+        transfer_map.finalize();
       }
 
       /* @brief @todo
@@ -550,7 +738,7 @@ namespace Dune {
        */
       void replayData(Grid& grid, GFSU& gfsu, Projection& projection, U& u, const MapType& transfer_map)
       {
-        const IDSet& id_set = grid.globalIdSet();
+        const IDSet& id_set = grid.localIdSet();
 
         typedef typename BackendVectorSelector<GFSU,int>::Type CountVector;
         CountVector uc(gfsu,0);
@@ -564,8 +752,8 @@ namespace Dune {
           {
             Element ancestor = cell;
 
-            typename MapType::const_iterator map_it;
-            while ((map_it = transfer_map.find(id_set.id(ancestor))) == transfer_map.end())
+            typename MapType::ConstBlock block;
+            while (!transfer_map.find(id_set.id(ancestor),block))
               {
                 if (!ancestor.hasFather())
                   DUNE_THROW(Exception,
@@ -573,7 +761,7 @@ namespace Dune {
                 ancestor = ancestor.father();
               }
 
-            visitor(cell,ancestor,map_it->second);
+            visitor(cell,ancestor,block);
           }
 
         typedef Dune::PDELab::AddDataHandle<GFSU,U> DOFHandle;
@@ -703,54 +891,254 @@ namespace Dune {
 
 
 
+#ifndef DOXYGEN
+    namespace impl {
+
+      //! Collect the indicator values of all interior elements
+      template<typename X>
+      void interior_indicator_values(const X& x, std::vector<typename X::ElementType>& values)
+      {
+        typedef typename X::GridFunctionSpace GFS;
+        typedef LocalFunctionSpace<GFS> LFS;
+        typedef LFSIndexCache<LFS> LFSCache;
+        typedef typename X::template ConstLocalView<LFSCache> XView;
+
+        LFS lfs(x.gridFunctionSpace());
+        LFSCache lfs_cache(lfs);
+        XView x_view(x);
+
+        values.clear();
+        values.reserve(x.N());
+        for(const auto& cell : elements(x.gridFunctionSpace().gridView(),Partitions::interior))
+          {
+            lfs.bind(cell);
+            lfs_cache.update();
+            x_view.bind(lfs_cache);
+            values.push_back(x_view[0]);
+            x_view.unbind();
+          }
+      }
+
+    } // namespace impl
+#endif // DOXYGEN
+
+    /** \brief Distributed selection of marking thresholds for an error indicator
+
+        The indicator values of the interior elements are mapped to integer
+        keys relative to the global maximum, i.e. the values are resolved up
+        to \f$2^{-32}\f$ times the largest indicator. All sums are computed
+        on these keys in 64 bit integers, so they are exact for up to
+        \f$2^{32}\f$ elements and do not depend on the order of summation.
+        Thresholds are found by a fixed number of rounds of global
+        histograms, each of which resolves another 8 bits of the key with a
+        single allreduce. No sorting and no bisection is needed, and the
+        resulting thresholds are identical on all ranks and independent of
+        the number of processes.
+
+        \tparam X backend vector of a grid function space with one indicator per element
+    */
+    template<typename X>
+    class ErrorIndicatorSelection
+    {
+      typedef typename X::GridFunctionSpace::Traits::GridViewType GV;
+      typedef typename GV::CollectiveCommunication Comm;
+
+    public:
+      typedef typename X::ElementType NumberType;
+      typedef std::uint64_t Key;
+
+      //! gather the interior indicator values and compute the global maximum
+      explicit ErrorIndicatorSelection(const X& x)
+        : comm(x.gridFunctionSpace().gridView().comm())
+      {
+        std::vector<NumberType> values;
+        impl::interior_indicator_values(x,values);
+
+        NumberType local_max = 0.0;
+        for (const auto& v : values)
+          local_max = std::max(local_max,v);
+        max_value = comm.max(local_max);
+
+        const NumberType scale = max_value > 0.0 ? std::ldexp(NumberType(1.0),key_bits)/max_value : 0.0;
+        keys.resize(values.size());
+        Key local_sum = 0;
+        for (std::size_t i=0; i<values.size(); ++i)
+          {
+            keys[i] = values[i] > 0.0 ? std::min(Key(values[i]*scale),maxKey()) : 0;
+            local_sum += keys[i];
+          }
+        total[0] = keys.size();
+        total[1] = local_sum;
+        comm.sum(total,2);
+      }
+
+      //! global number of interior elements
+      Key size() const
+      {
+        return total[0];
+      }
+
+      //! global maximum of the indicator
+      NumberType maximum() const
+      {
+        return max_value;
+      }
+
+      /** \brief smallest indicator value such that the elements at or above it carry the given fraction
+
+          With weighted=true the fraction refers to the sum of the
+          indicators (bulk or Dörfler criterion), otherwise to the number of
+          elements. A fraction of zero selects no element.
+      */
+      NumberType upper(NumberType fraction, bool weighted=true) const
+      {
+        if (fraction <= 0.0 || !(max_value > 0.0))
+          return std::numeric_limits<NumberType>::max();
+        const NumberType target = fraction * (weighted ? total[1] : total[0]);
+        Key lo = 0;
+        Key above = 0;
+        int shift = key_bits;
+        std::vector<Key> hist(bins);
+        for (int round=0; round<rounds; ++round)
+          {
+            shift -= bits_per_round;
+            histogram(lo,shift,weighted,hist);
+            int b = bins-1;
+            for (; b>0; --b)
+              {
+                if (NumberType(above + hist[b]) >= target)
+                  break;
+                above += hist[b];
+              }
+            lo += Key(b) << shift;
+          }
+        return value(lo);
+      }
+
+      /** \brief largest indicator value such that the elements below it carry at most the given fraction
+
+          With weighted=true the fraction refers to the sum of the
+          indicators, otherwise to the number of elements.
+      */
+      NumberType lower(NumberType fraction, bool weighted=true) const
+      {
+        const NumberType target = fraction * (weighted ? total[1] : total[0]);
+        Key lo = 0;
+        Key below = 0;
+        int shift = key_bits;
+        bool fits = false;
+        std::vector<Key> hist(bins);
+        for (int round=0; round<rounds; ++round)
+          {
+            shift -= bits_per_round;
+            histogram(lo,shift,weighted,hist);
+            int b = 0;
+            for (; b<bins-1; ++b)
+              {
+                if (NumberType(below + hist[b]) > target)
+                  break;
+                below += hist[b];
+              }
+            fits = b == bins-1 && NumberType(below + hist[b]) <= target;
+            lo += Key(b) << shift;
+          }
+        // the last key itself does not exceed the target, include it
+        return value(fits ? lo+1 : lo);
+      }
+
+      //! global number and indicator sum of the elements with indicator in [from,to)
+      std::pair<Key,NumberType> count(NumberType from, NumberType to) const
+      {
+        const Key kfrom = key(from);
+        const Key kto = key(to);
+        Key result[2] = {0,0};
+        for (const auto& k : keys)
+          if (k >= kfrom && k < kto)
+            {
+              result[0] += 1;
+              result[1] += k;
+            }
+        comm.sum(result,2);
+        return std::make_pair(result[0],max_value * std::ldexp(NumberType(result[1]),-key_bits));
+      }
+
+    private:
+
+      enum { rounds = 4, bits_per_round = 8 };
+      enum { bins = 1 << bits_per_round, key_bits = rounds * bits_per_round };
+
+      static Key maxKey()
+      {
+        return (Key(1) << key_bits) - 1;
+      }
+
+      //! global histogram of the keys in [lo, lo + bins << shift)
+      void histogram(Key lo, int shift, bool weighted, std::vector<Key>& hist) const
+      {
+        std::fill(hist.begin(),hist.end(),Key(0));
+        const Key hi = lo + (Key(bins) << shift);
+        for (const auto& k : keys)
+          if (k >= lo && k < hi)
+            hist[(k - lo) >> shift] += weighted ? k : 1;
+        comm.sum(hist.data(),bins);
+      }
+
+      NumberType value(Key k) const
+      {
+        if (k > maxKey())
+          return std::numeric_limits<NumberType>::max();
+        return max_value * std::ldexp(NumberType(k),-key_bits);
+      }
+
+      Key key(NumberType v) const
+      {
+        if (v >= std::numeric_limits<NumberType>::max())
+          return maxKey()+1;
+        if (!(max_value > 0.0) || v <= 0.0)
+          return 0;
+        const NumberType k = std::ceil(v / max_value * std::ldexp(NumberType(1.0),key_bits));
+        return k > NumberType(maxKey()) ? maxKey()+1 : Key(k);
+      }
+
+      const Comm& comm;
+      std::vector<Key> keys;
+      NumberType max_value;
+      Key total[2];
+    };
+
+
+    /** \brief Compute marking thresholds from a fraction of the total error (bulk or Dörfler criterion)
+
+        On return, the elements with indicator >= eta_alpha carry at least
+        the fraction alpha of the total error, and the elements with
+        indicator < eta_beta carry at most the fraction beta. The thresholds
+        are computed globally and are identical on all ranks.
+    */
     template<typename T>
     void error_fraction(const T& x, typename T::ElementType alpha, typename T::ElementType beta,
                         typename T::ElementType& eta_alpha, typename T::ElementType& eta_beta, int verbose=0)
     {
-      if (verbose>0)
+      const bool root = x.gridFunctionSpace().gridView().comm().rank() == 0;
+      if (verbose>0 && root)
         std::cout << "+++ error fraction: alpha=" << alpha << " beta=" << beta << std::endl;
-      const int steps=20; // max number of bisection steps
-      typedef typename T::ElementType NumberType;
-      NumberType total_error = x.one_norm();
-      NumberType max_error = x.infinity_norm();
-      NumberType eta_alpha_left = 0.0;
-      NumberType eta_alpha_right = max_error;
-      NumberType eta_beta_left = 0.0;
-      NumberType eta_beta_right = max_error;
-      for (int j=1; j<=steps; j++)
+      ErrorIndicatorSelection<T> selection(x);
+      eta_alpha = selection.upper(alpha);
+      eta_beta = selection.lower(beta);
+      if (verbose>1)
         {
-          eta_alpha = 0.5*(eta_alpha_left+eta_alpha_right);
-          eta_beta = 0.5*(eta_beta_left+eta_beta_right);
-          NumberType sum_alpha=0.0;
-          NumberType sum_beta=0.0;
-          unsigned int alpha_count = 0;
-          unsigned int beta_count = 0;
-          for (typename T::const_iterator it = x.begin(),
-                 end = x.end();
-               it != end;
-               ++it)
-            {
-              if (*it >=eta_alpha) { sum_alpha += *it; alpha_count++;}
-              if (*it < eta_beta) { sum_beta += *it; beta_count++;}
-            }
-          if (verbose>1)
+          typedef typename T::ElementType NumberType;
+          const NumberType total_error = selection.count(0.0,std::numeric_limits<NumberType>::max()).second;
+          const auto refine = selection.count(eta_alpha,std::numeric_limits<NumberType>::max());
+          const auto coarsen = selection.count(0.0,eta_beta);
+          if (root)
             {
-              std::cout << "+++ " << j << " eta_alpha=" << eta_alpha << " alpha_fraction=" << sum_alpha/total_error
-                        << " elements: " << alpha_count << " of " << x.N() << std::endl;
-              std::cout << "+++ " << j << " eta_beta=" << eta_beta << " beta_fraction=" << sum_beta/total_error
-                        << " elements: " << beta_count << " of " << x.N() << std::endl;
+              std::cout << "+++ eta_alpha=" << eta_alpha << " alpha_fraction=" << refine.second/total_error
+                        << " elements: " << refine.first << " of " << selection.size() << std::endl;
+              std::cout << "+++ eta_beta=" << eta_beta << " beta_fraction=" << coarsen.second/total_error
+                        << " elements: " << coarsen.first << " of " << selection.size() << std::endl;
             }
-          if (std::abs(alpha-sum_alpha/total_error) <= 0.01 && std::abs(beta-sum_beta/total_error) <= 0.01) break;
-          if (sum_alpha>alpha*total_error)
-            eta_alpha_left = eta_alpha;
-          else
-            eta_alpha_right = eta_alpha;
-          if (sum_beta>beta*total_error)
-            eta_beta_right = eta_beta;
-          else
-            eta_beta_left = eta_beta;
         }
-      if (verbose>0)
+      if (verbose>0 && root)
         {
           std::cout << "+++ refine_threshold=" << eta_alpha
                     << " coarsen_threshold=" << eta_beta << std::endl;
@@ -758,121 +1146,97 @@ namespace Dune {
     }
 
 
+    /** \brief Compute marking thresholds from a fraction of the number of elements
+
+        Like error_fraction(), but alpha and beta refer to the global
+        number of elements instead of the total error.
+    */
     template<typename T>
     void element_fraction(const T& x, typename T::ElementType alpha, typename T::ElementType beta,
                           typename T::ElementType& eta_alpha, typename T::ElementType& eta_beta, int verbose=0)
     {
-      const int steps=20; // max number of bisection steps
-      typedef typename T::ElementType NumberType;
-      NumberType total_error =x.N();
-      NumberType max_error = x.infinity_norm();
-      NumberType eta_alpha_left = 0.0;
-      NumberType eta_alpha_right = max_error;
-      NumberType eta_beta_left = 0.0;
-      NumberType eta_beta_right = max_error;
-      for (int j=1; j<=steps; j++)
+      const bool root = x.gridFunctionSpace().gridView().comm().rank() == 0;
+      ErrorIndicatorSelection<T> selection(x);
+      eta_alpha = selection.upper(alpha,false);
+      eta_beta = selection.lower(beta,false);
+      if (verbose>1)
         {
-          eta_alpha = 0.5*(eta_alpha_left+eta_alpha_right);
-          eta_beta = 0.5*(eta_beta_left+eta_beta_right);
-          NumberType sum_alpha=0.0;
-          NumberType sum_beta=0.0;
-          unsigned int alpha_count = 0;
-          unsigned int beta_count = 0;
-
-          for (typename T::const_iterator it = x.begin(),
-                 end = x.end();
-               it != end;
-               ++it)
-            {
-              if (*it>=eta_alpha) { sum_alpha += 1.0; alpha_count++;}
-              if (*it< eta_beta) { sum_beta +=1.0; beta_count++;}
-            }
-          if (verbose>1)
+          typedef typename T::ElementType NumberType;
+          const auto refine = selection.count(eta_alpha,std::numeric_limits<NumberType>::max());
+          const auto coarsen = selection.count(0.0,eta_beta);
+          if (root)
             {
-              std::cout << j << " eta_alpha=" << eta_alpha << " alpha_fraction=" << sum_alpha/total_error
-                        << " elements: " << alpha_count << " of " << x.N() << std::endl;
-              std::cout << j << " eta_beta=" << eta_beta << " beta_fraction=" << sum_beta/total_error
-                        << " elements: " << beta_count << " of " << x.N() << std::endl;
+              std::cout << "+++ eta_alpha=" << eta_alpha << " elements: " << refine.first
+                        << " of " << selection.size() << std::endl;
+              std::cout << "+++ eta_beta=" << eta_beta << " elements: " << coarsen.first
+                        << " of " << selection.size() << std::endl;
             }
-          if (std::abs(alpha-sum_alpha/total_error) <= 0.01 && std::abs(beta-sum_beta/total_error) <= 0.01) break;
-          if (sum_alpha>alpha*total_error)
-            eta_alpha_left = eta_alpha;
-          else
-            eta_alpha_right = eta_alpha;
-          if (sum_beta>beta*total_error)
-            eta_beta_right = eta_beta;
-          else
-            eta_beta_left = eta_beta;
         }
-      if (verbose>0)
+      if (verbose>0 && root)
         {
           std::cout << "+++ refine_threshold=" << eta_alpha
                     << " coarsen_threshold=" << eta_beta << std::endl;
         }
     }
 
+
+    /** \brief Compute marking thresholds relative to the maximal indicator (maximum strategy)
+
+        Elements with indicator >= alpha times the global maximum are marked
+        for refinement, those with indicator <= beta times the global
+        maximum for coarsening.
+    */
+    template<typename T>
+    void max_fraction(const T& x, typename T::ElementType alpha, typename T::ElementType beta,
+                      typename T::ElementType& eta_alpha, typename T::ElementType& eta_beta, int verbose=0)
+    {
+      typedef typename T::ElementType NumberType;
+      const auto& comm = x.gridFunctionSpace().gridView().comm();
+      std::vector<NumberType> values;
+      impl::interior_indicator_values(x,values);
+      NumberType max_error = 0.0;
+      for (const auto& v : values)
+        max_error = std::max(max_error,v);
+      max_error = comm.max(max_error);
+      eta_alpha = alpha * max_error;
+      eta_beta = beta * max_error;
+      if (verbose>0 && comm.rank() == 0)
+        {
+          std::cout << "+++ max fraction: max_error=" << max_error
+                    << " refine_threshold=" << eta_alpha
+                    << " coarsen_threshold=" << eta_beta << std::endl;
+        }
+    }
+
+
     /** Compute error distribution
+
+        The bins are equidistant with respect to the fraction of the total
+        error. The output is written on rank 0 only.
      */
     template<typename T>
     void error_distribution(const T& x, int bins)
     {
-      const int steps=30; // max number of bisection steps
       typedef typename T::ElementType NumberType;
-      NumberType total_error = x.one_norm();
-      NumberType total_elements = x.N();
-      NumberType max_error = x.infinity_norm();
-      std::vector<NumberType> left(bins,0.0);
-      std::vector<NumberType> right(bins,max_error*(1.0+1e-8));
+      ErrorIndicatorSelection<T> selection(x);
+      const NumberType inf = std::numeric_limits<NumberType>::max();
+      const NumberType total_error = selection.count(0.0,inf).second;
       std::vector<NumberType> eta(bins);
-      std::vector<NumberType> target(bins);
-      for (unsigned int k=0; k<bins; k++)
-        target[k]= (k+1)/((NumberType)bins);
-      for (int j=1; j<=steps; j++)
+      std::vector<std::pair<typename ErrorIndicatorSelection<T>::Key,NumberType> > sum(bins);
+      for (int k=0; k<bins; k++)
         {
-          for (unsigned int k=0; k<bins; k++)
-            eta[k]= 0.5*(left[k]+right[k]);
-          std::vector<NumberType> sum(bins,0.0);
-          std::vector<int> count(bins,0);
-
-          for (typename T::const_iterator it = x.begin(),
-                 end = x.end();
-               it != end;
-               ++it)
-            {
-              for (unsigned int k=0; k<bins; k++)
-                if (*it<=eta[k])
-                  {
-                    sum[k] += *it;
-                    count[k] += 1;
-                  }
-            }
-          // std::cout << std::endl;
-          // std::cout << "// step " << j << std::endl;
-          // for (unsigned int k=0; k<bins; k++)
-          //    std::cout << k+1 << " " << count[k] << " " << eta[k] << " " << right[k]-left[k]
-          //          << " " << sum[k]/total_error << " " << target[k] << std::endl;
-          for (unsigned int k=0; k<bins; k++)
-            if (sum[k]<=target[k]*total_error)
-              left[k] = eta[k];
-            else
-              right[k] = eta[k];
+          eta[k] = selection.lower((k+1)/((NumberType)bins));
+          sum[k] = selection.count(0.0,eta[k]);
         }
-      std::vector<NumberType> sum(bins,0.0);
-      std::vector<int> count(bins,0);
-      for (unsigned int i=0; i<x.N(); i++)
-        for (unsigned int k=0; k<bins; k++)
-          if (x[i]<=eta[k])
-            {
-              sum[k] += x[i];
-              count[k] += 1;
-            }
+      if (x.gridFunctionSpace().gridView().comm().rank() != 0)
+        return;
       std::cout << "+++ error distribution" << std::endl;
-      std::cout << "+++ number of elements: " << x.N() << std::endl;
-      std::cout << "+++ max element error:  " << max_error << std::endl;
+      std::cout << "+++ number of elements: " << selection.size() << std::endl;
+      std::cout << "+++ max element error:  " << selection.maximum() << std::endl;
       std::cout << "+++ total error:        " << total_error << std::endl;
       std::cout << "+++ bin #elements eta sum/total " << std::endl;
-      for (unsigned int k=0; k<bins; k++)
-        std::cout << "+++ " << k+1 << " " << count[k] << " " << eta[k] << " " << sum[k]/total_error << std::endl;
+      for (int k=0; k<bins; k++)
+        std::cout << "+++ " << k+1 << " " << sum[k].first << " " << eta[k] << " " << sum[k].second/total_error << std::endl;
     }
 
     template<typename Grid, typename X>
@@ -223,6 +223,14 @@ namespace Dune
         std::shared_ptr< Container > _container;
       };
 
+      //! Approximate memory footprint of the compressed sparse matrix, see MultiStepCache
+      template<typename GFSV, typename GFSU, typename ET, int _Options>
+      std::size_t multiStepCacheBytes(const MatrixContainer<GFSV,GFSU,ET,_Options>& m)
+      {
+        typedef typename MatrixContainer<GFSV,GFSU,ET,_Options>::index_type Index;
+        return m.base().nonZeros() * (sizeof(ET) + sizeof(Index)) + (m.base().outerSize() + 1) * sizeof(Index);
+      }
+
     } // end namespace EIGEN
   } // namespace PDELab
 } // namespace Dune
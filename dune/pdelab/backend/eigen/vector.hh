@@ -274,6 +274,13 @@ namespace Dune {
 
       };
 
+      //! Approximate memory footprint of the coefficients, see MultiStepCache
+      template<typename GFS, typename ET>
+      std::size_t multiStepCacheBytes(const VectorContainer<GFS,ET>& v)
+      {
+        return v.base().size() * sizeof(ET);
+      }
+
     } // end namespace EIGEN
 
 
@@ -2,6 +2,8 @@
 #ifndef DUNE_PDELAB_BACKEND_ISTL_BCRSMATRIXBACKEND_HH
 #define DUNE_PDELAB_BACKEND_ISTL_BCRSMATRIXBACKEND_HH
 
+#include <dune/common/exceptions.hh>
+
 #include <dune/pdelab/backend/istlmatrixbackend.hh>
 #include <dune/pdelab/backend/istl/bcrspattern.hh>
 #include <dune/pdelab/backend/istl/patternstatistics.hh>
@@ -182,6 +184,25 @@ namespace Dune {
        * does after pattern construction and runs a lot faster, as long as it is provided with a
        * reasonable estimate for the number of non-zero entries per row.
        *
+       * A default constructed backend determines the space required for each row automatically:
+       * The pattern is filled twice, first only counting the links of each row and then storing
+       * them into rows of exactly the counted size, so the pattern construction never has to fall
+       * back to the slow overflow storage. This costs a second traversal of the grid, and as the
+       * counts include the links that neighbouring elements share, the rows are oversized during
+       * the second traversal (about 1.7 to 2.4 times the final column index array for Q1 and Q2
+       * elements in 3D). The padding is released before the matrix is allocated.
+       *
+       * With PatternConstruction::sortedLinks, the pattern is filled only once: all links are
+       * collected into a flat buffer, which is deduplicated in batches while the grid is traversed
+       * and then sorted and deduplicated row by row (in parallel if PDELab is compiled with OpenMP,
+       * see DUNE_PDELAB_ENABLE_OPENMP; otherwise serially). Only this sorting is parallelized: The
+       * grid traversal that calls add_link() stays serial, so the pattern construction as a whole
+       * is only partly parallel. This trades memory against the second pass over the grid: The peak
+       * memory of the pattern construction is about 3*sizeof(size_type) bytes per collected link
+       * (see BCRSPattern), i.e. about three times the column index array of the finished matrix,
+       * compared to about one column index array for PatternConstruction::countedRows. This mode is
+       * opt-in; use it when the second traversal is expensive and the memory is available.
+       *
        */
       template<typename EntriesPerRow = std::size_t>
       struct BCRSMatrixBackend
@@ -193,6 +214,18 @@ namespace Dune {
         //! The type of the object holding the statistics generated during pattern construction.
         typedef PatternStatistics<size_type> Statistics;
 
+        //! How the space for the matrix rows is determined during pattern construction.
+        struct PatternConstruction {
+          enum type {
+            //! reserve the user-provided number of entries per row
+            fixedEstimate,
+            //! fill the pattern twice, counting the links of each row in the first pass
+            countedRows,
+            //! fill the pattern once into a buffer of links that is sorted afterwards
+            sortedLinks
+          };
+        };
+
 #if HAVE_TEMPLATE_ALIASES || DOXYGEN
 
         //! The type of the pattern object passed to the GridOperator for pattern construction.
@@ -263,20 +296,32 @@ namespace Dune {
         template<typename GridOperator, typename Matrix>
         std::vector<Statistics> buildPattern(const GridOperator& grid_operator, Matrix& matrix) const
         {
-          Pattern<
+          typedef Pattern<
             Matrix,
             typename GridOperator::Traits::TestGridFunctionSpace,
             typename GridOperator::Traits::TrialGridFunctionSpace
-            > pattern(grid_operator.testGridFunctionSpace().ordering(),grid_operator.trialGridFunctionSpace().ordering(),_entries_per_row);
+            > PatternType;
+          if (_construction == PatternConstruction::countedRows)
+            {
+              PatternType pattern(grid_operator.testGridFunctionSpace().ordering(),grid_operator.trialGridFunctionSpace().ordering(),size_type(0));
+              pattern.beginRowCounting();
+              grid_operator.fill_pattern(pattern);
+              pattern.endRowCounting();
+              grid_operator.fill_pattern(pattern);
+              pattern.compact();
+              return allocateMatrix(grid_operator,pattern,matrix);
+            }
+          if (_construction == PatternConstruction::sortedLinks)
+            {
+              PatternType pattern(grid_operator.testGridFunctionSpace().ordering(),grid_operator.trialGridFunctionSpace().ordering(),size_type(0));
+              pattern.beginLinkCollection();
+              grid_operator.fill_pattern(pattern);
+              pattern.endLinkCollection();
+              return allocateMatrix(grid_operator,pattern,matrix);
+            }
+          PatternType pattern(grid_operator.testGridFunctionSpace().ordering(),grid_operator.trialGridFunctionSpace().ordering(),_entries_per_row);
           grid_operator.fill_pattern(pattern);
-          std::vector<Statistics> stats;
-          allocate_bcrs_matrix(grid_operator.testGridFunctionSpace().ordering(),
-                               grid_operator.trialGridFunctionSpace().ordering(),
-                               pattern,
-                               istl::raw(matrix),
-                               stats
-                               );
-          return std::move(stats);
+          return allocateMatrix(grid_operator,pattern,matrix);
         }
 
         //! Constructs a BCRSMatrixBackend.
@@ -287,11 +332,61 @@ namespace Dune {
          */
         BCRSMatrixBackend(const EntriesPerRow& entries_per_row)
           : _entries_per_row(entries_per_row)
+          , _construction(PatternConstruction::fixedEstimate)
         {}
 
+        //! Constructs a BCRSMatrixBackend that sizes the matrix rows automatically.
+        /**
+         * Uses PatternConstruction::countedRows, which traverses the grid twice and temporarily
+         * reserves space for every counted link including duplicates, see above.
+         */
+        BCRSMatrixBackend()
+          : _entries_per_row()
+          , _construction(PatternConstruction::countedRows)
+        {}
+
+        //! Constructs a BCRSMatrixBackend that sizes the matrix rows automatically with the given method.
+        /**
+         * \param construction  Either PatternConstruction::countedRows or PatternConstruction::sortedLinks.
+         */
+        explicit BCRSMatrixBackend(typename PatternConstruction::type construction)
+          : _entries_per_row()
+          , _construction(construction)
+        {
+          if (construction == PatternConstruction::fixedEstimate)
+            DUNE_THROW(InvalidStateException,"PatternConstruction::fixedEstimate requires the number of entries per row");
+        }
+
+        //! Returns whether the number of entries per row is determined automatically.
+        bool automaticEntriesPerRow() const
+        {
+          return _construction != PatternConstruction::fixedEstimate;
+        }
+
+        //! Returns how the space for the matrix rows is determined.
+        typename PatternConstruction::type patternConstruction() const
+        {
+          return _construction;
+        }
+
       private:
 
+        // initializes the matrix with the filled pattern
+        template<typename GridOperator, typename PatternType, typename Matrix>
+        std::vector<Statistics> allocateMatrix(const GridOperator& grid_operator, PatternType& pattern, Matrix& matrix) const
+        {
+          std::vector<Statistics> stats;
+          allocate_bcrs_matrix(grid_operator.testGridFunctionSpace().ordering(),
+                               grid_operator.trialGridFunctionSpace().ordering(),
+                               pattern,
+                               istl::raw(matrix),
+                               stats
+                               );
+          return std::move(stats);
+        }
+
         EntriesPerRow _entries_per_row;
+        typename PatternConstruction::type _construction;
 
       };
 
@@ -5,6 +5,7 @@
 #include <utility>
 #include <vector>
 #include <algorithm>
+#include <numeric>
 #include <set>
 
 #include <dune/common/iteratorfacades.hh>
@@ -38,6 +39,25 @@ namespace Dune {
        * too low nor retain excess memory if it was set too high after the pattern construction
        * is complete. Performance will degrade if the user-provided estimate is too far away
        * from the real value.
+       *
+       * Alternatively, the space for each row can be sized automatically: Links added between
+       * beginRowCounting() and endRowCounting() are only counted, and endRowCounting() reserves
+       * that many entries (including duplicates) for each row. Adding the same links again then
+       * never spills into the overflow area. As links shared by neighbouring elements are counted
+       * once per element, this reserves about 1.7 to 2.4 times the final number of entries for
+       * Q1 and Q2 elements in 3D; compact() releases the unused space afterwards.
+       *
+       * Links added between beginLinkCollection() and endLinkCollection() are only appended to a
+       * flat buffer of (row,column) pairs, which is deduplicated batch by batch while it grows, so
+       * that links shared by neighbouring elements are only kept once. endLinkCollection() then
+       * buckets the pairs by row, sorts and deduplicates every row and stores the rows without any
+       * padding, so a single pass over the grid suffices. If PDELab is compiled with OpenMP, these
+       * steps run in parallel, otherwise they run serially. add_link() itself is not thread safe,
+       * so the grid traversal feeding it stays serial in either case. Note that this trades memory
+       * for the second pass over the grid: The buffer needs 2*sizeof(size_type) bytes per collected
+       * pair (up to twice that while the vector grows), and endLinkCollection() temporarily needs
+       * another sizeof(size_type) bytes per pair, while the counting mode above only ever needs the
+       * final column index array.
        */
       template<typename RowOrdering, typename ColOrdering>
       class BCRSPattern
@@ -99,9 +119,23 @@ namespace Dune {
           size_type i = ri.back();
           size_type j = ci.back();
 
+          if (_mode == Mode::counting)
+            {
+              ++_row_offsets[i+1];
+              return;
+            }
+
+          if (_mode == Mode::collecting)
+            {
+              _links.push_back(std::make_pair(i,j));
+              if (_links.size() - _batch_begin >= link_batch_size)
+                compactLinkBatch();
+              return;
+            }
+
           IndicesIterator start = _indices.begin();
-          IndicesIterator begin = start + _entries_per_row*i;
-          IndicesIterator end = start + _entries_per_row*(i+1);
+          IndicesIterator begin = start + _row_offsets[i];
+          IndicesIterator end = start + _row_offsets[i+1];
 
           // Does the entry (i,j) already exist?
           IndicesIterator it = std::find_if(begin,end,PaddedColumnCriterion(j));
@@ -134,11 +168,11 @@ namespace Dune {
         void sizes(I rit) const
         {
           ConstIndicesIterator it = _indices.begin();
-          ConstIndicesIterator end = _indices.begin() + _entries_per_row;
           ConstOverflowIterator oit = _overflow.begin();
           ConstOverflowIterator oend = _overflow.end();
-          for (size_type i = 0; i < _row_ordering.blockCount(); ++i, ++rit, end+=_entries_per_row)
+          for (size_type i = 0; i < _row_ordering.blockCount(); ++i, ++rit)
             {
+              ConstIndicesIterator end = _indices.begin() + _row_offsets[i+1];
               size_type s = 0;
               // count non-empty column entries, break when first empty one is found.
               for (; it != end; ++it)
@@ -219,8 +253,8 @@ namespace Dune {
             : _row(row)
             , _in_overflow(false)
             , _at_end(at_end)
-            , _it(p._indices.begin() + row * p._entries_per_row)
-            , _end(p._indices.begin() + (row+1) * p._entries_per_row)
+            , _it(p._indices.begin() + p._row_offsets[row])
+            , _end(p._indices.begin() + p._row_offsets[row+1])
             , _oit(p._overflow.lower_bound(std::make_pair(row,0)))
             , _oend(p._overflow.end())
           {
@@ -265,9 +299,148 @@ namespace Dune {
         BCRSPattern(const RowOrdering& row_ordering, const ColOrdering& col_ordering, size_type entries_per_row)
           : _row_ordering(row_ordering)
           , _col_ordering(col_ordering)
-          , _entries_per_row(entries_per_row)
+          , _mode(Mode::storing)
+          , _row_offsets(row_ordering.blockCount()+1)
           , _indices(row_ordering.blockCount()*entries_per_row,size_type(empty))
-        {}
+          , _batch_begin(0)
+        {
+          for (size_type i = 0; i < _row_offsets.size(); ++i)
+            _row_offsets[i] = i * entries_per_row;
+        }
+
+        //! Start counting the links per row instead of storing them.
+        /**
+         * Discards all stored links. Links added until the next call to endRowCounting()
+         * only determine how much space is reserved for each row.
+         */
+        void beginRowCounting()
+        {
+          _indices = std::vector<size_type>();
+          _overflow = std::set<std::pair<size_type,size_type> >();
+          std::fill(_row_offsets.begin(),_row_offsets.end(),0);
+          _mode = Mode::counting;
+        }
+
+        //! Reserve space for the counted links and switch back to storing links.
+        void endRowCounting()
+        {
+          // a row can never contain more entries than there are columns
+          const size_type columns = _col_ordering.blockCount();
+          for (size_type i = 1; i < _row_offsets.size(); ++i)
+            _row_offsets[i] = std::min(_row_offsets[i],columns);
+          std::partial_sum(_row_offsets.begin(),_row_offsets.end(),_row_offsets.begin());
+          _indices.assign(_row_offsets.back(),size_type(empty));
+          _mode = Mode::storing;
+        }
+
+        //! Release the space reserved for entries that were never used.
+        /**
+         * Moves the entries of every row to the front of the index array and shrinks it to the
+         * number of stored links, so that the padding reserved by endRowCounting() or the
+         * estimate does not stay alive while the matrix is allocated. Links added afterwards
+         * end up in the overflow area.
+         */
+        void compact()
+        {
+          size_type k = 0;
+          size_type begin = 0;
+          for (size_type i = 1; i < _row_offsets.size(); ++i)
+            {
+              const size_type end = _row_offsets[i];
+              for (size_type l = begin; l < end && _indices[l] != empty; ++l)
+                _indices[k++] = _indices[l];
+              begin = end;
+              _row_offsets[i] = k;
+            }
+          std::vector<size_type>(_indices.begin(),_indices.begin() + k).swap(_indices);
+        }
+
+        //! Start collecting links into a flat buffer instead of storing them.
+        /**
+         * Discards all stored links. The links added until the next call to endLinkCollection()
+         * may contain duplicates.
+         */
+        void beginLinkCollection()
+        {
+          _indices = std::vector<size_type>();
+          _overflow = std::set<std::pair<size_type,size_type> >();
+          _links.clear();
+          _batch_begin = 0;
+          _mode = Mode::collecting;
+        }
+
+        //! Build the rows from the collected links and switch back to storing links.
+        /**
+         * The collected pairs are bucketed by row with a counting sort, after which every row
+         * is sorted and deduplicated independently. The resulting rows have exactly the size
+         * of their column set.
+         */
+        void endLinkCollection()
+        {
+          compactLinkBatch();
+          const std::ptrdiff_t rows = _row_ordering.blockCount();
+          const std::ptrdiff_t links = _links.size();
+
+          // count the links of each row
+          std::vector<size_type> bucket_offsets(rows+1,0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+          for (std::ptrdiff_t l = 0; l < links; ++l)
+            {
+              size_type& count = bucket_offsets[_links[l].first+1];
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+              ++count;
+            }
+          std::partial_sum(bucket_offsets.begin(),bucket_offsets.end(),bucket_offsets.begin());
+
+          // scatter the columns into their row buckets
+          std::vector<size_type> columns(links);
+          {
+            std::vector<size_type> position(bucket_offsets.begin(),bucket_offsets.end()-1);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (std::ptrdiff_t l = 0; l < links; ++l)
+              {
+                size_type p;
+                size_type& next = position[_links[l].first];
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+                p = next++;
+                columns[p] = _links[l].second;
+              }
+          }
+          std::vector<std::pair<size_type,size_type> >().swap(_links);
+
+          // sort and deduplicate each row
+          std::fill(_row_offsets.begin(),_row_offsets.end(),0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1024)
+#endif
+          for (std::ptrdiff_t i = 0; i < rows; ++i)
+            {
+              IndicesIterator begin = columns.begin() + bucket_offsets[i];
+              IndicesIterator end = columns.begin() + bucket_offsets[i+1];
+              std::sort(begin,end);
+              _row_offsets[i+1] = std::unique(begin,end) - begin;
+            }
+          std::partial_sum(_row_offsets.begin(),_row_offsets.end(),_row_offsets.begin());
+
+          // compact the rows
+          _indices.resize(_row_offsets.back());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+          for (std::ptrdiff_t i = 0; i < rows; ++i)
+            std::copy(columns.begin() + bucket_offsets[i],
+                      columns.begin() + bucket_offsets[i] + (_row_offsets[i+1] - _row_offsets[i]),
+                      _indices.begin() + _row_offsets[i]);
+          _mode = Mode::storing;
+        }
 
         const RowOrdering& rowOrdering() const
         {
@@ -292,9 +465,11 @@ namespace Dune {
           _overflow = std::set<std::pair<size_type,size_type> >();
         }
 
+        //! Returns the average number of entries reserved per row, rounded up.
         size_type entriesPerRow() const
         {
-          return _entries_per_row;
+          const size_type rows = _row_offsets.size() - 1;
+          return rows > 0 ? (_row_offsets.back() + rows - 1) / rows : 0;
         }
 
         size_type overflowCount() const
@@ -304,12 +479,36 @@ namespace Dune {
 
       private:
 
+        //! Number of links collected before the most recent ones are deduplicated.
+        static const size_type link_batch_size = size_type(1) << 18;
+
+        //! Remove the duplicates among the links collected since the last call.
+        /**
+         * Consecutive elements share most of their links, so this keeps the buffer close to the
+         * number of distinct links without a global sort.
+         */
+        void compactLinkBatch()
+        {
+          typedef typename std::vector<std::pair<size_type,size_type> >::iterator LinkIterator;
+          LinkIterator begin = _links.begin() + _batch_begin;
+          std::sort(begin,_links.end());
+          _links.erase(std::unique(begin,_links.end()),_links.end());
+          _batch_begin = _links.size();
+        }
+
+        struct Mode {
+          enum type { storing, counting, collecting };
+        };
+
         const RowOrdering& _row_ordering;
         const ColOrdering& _col_ordering;
-        const size_type _entries_per_row;
+        typename Mode::type _mode;
 
+        std::vector<size_type> _row_offsets;
         std::vector<size_type> _indices;
         std::set<std::pair<size_type,size_type> > _overflow;
+        std::vector<std::pair<size_type,size_type> > _links;
+        size_type _batch_begin;
 
       };
 
@@ -394,6 +593,41 @@ namespace Dune {
           return _sub_patterns[i * _col_ordering.blockCount() + j];
         }
 
+        //! Start counting the links per row in all subpatterns.
+        void beginRowCounting()
+        {
+          for (SubPattern& p : _sub_patterns)
+            p.beginRowCounting();
+        }
+
+        //! Reserve space for the counted links in all subpatterns.
+        void endRowCounting()
+        {
+          for (SubPattern& p : _sub_patterns)
+            p.endRowCounting();
+        }
+
+        //! Release the unused space of all subpatterns.
+        void compact()
+        {
+          for (SubPattern& p : _sub_patterns)
+            p.compact();
+        }
+
+        //! Start collecting the links in all subpatterns.
+        void beginLinkCollection()
+        {
+          for (SubPattern& p : _sub_patterns)
+            p.beginLinkCollection();
+        }
+
+        //! Build the rows of all subpatterns from the collected links.
+        void endLinkCollection()
+        {
+          for (SubPattern& p : _sub_patterns)
+            p.endLinkCollection();
+        }
+
       private:
 
         const RowOrdering& _row_ordering;
@@ -241,6 +241,13 @@ namespace Dune {
             diagonal::mv(container_tag(_container),_container,raw(x),raw(y));
           }
 
+          //! apply a single diagonal block of the outermost level, y[i] = A[i][i] x[i]
+          template<typename X, typename Y>
+          void mv_block(std::size_t i, const X& x, Y& y) const
+          {
+            diagonal::mv(container_tag(_container[i]),_container[i],raw(x)[i],raw(y)[i]);
+          }
+
           template<typename ContainerIndex>
           std::size_t row_size(const ContainerIndex& ci) const
           {
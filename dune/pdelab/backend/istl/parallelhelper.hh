@@ -4,6 +4,7 @@
 #define DUNE_PDELAB_BACKEND_ISTL_PARALLELHELPER_HH
 
 #include <limits>
+#include <type_traits>
 
 #include <dune/common/deprecated.hh>
 #include <dune/common/parallel/mpihelper.hh>
@@ -20,6 +21,7 @@
 #include <dune/istl/io.hh>
 #include <dune/istl/superlu.hh>
 
+#include <dune/pdelab/common/reproduciblesum.hh>
 #include <dune/pdelab/constraints/common/constraints.hh>
 #include <dune/pdelab/gridfunctionspace/genericdatahandle.hh>
 #include <dune/pdelab/backend/istlvectorbackend.hh>
@@ -63,6 +65,7 @@ namespace Dune {
           , _ranks(gfs,_rank)
           , _ghosts(gfs,false)
           , _verbose(verbose)
+          , _reproducible(false)
         {
 
           // Let's try to be clever and reduce the communication overhead by picking the smallest
@@ -163,8 +166,94 @@ namespace Dune {
                              );
         }
 
+        //! Compute the global scalar product of x and y over all ranks.
+        /**
+         * Sums up disjointDot() over all ranks. If reproducible reductions
+         * are enabled and the field type is real, the products are
+         * accumulated exactly with ReproducibleSum, so the result does not
+         * depend on the number of processes.
+         */
+        template<typename X, typename Y>
+        typename PromotionTraits<
+          typename X::field_type,
+          typename Y::field_type
+          >::PromotedType
+        globalDot(const X& x, const Y& y) const
+        {
+          typedef typename PromotionTraits<
+            typename X::field_type,
+            typename Y::field_type
+            >::PromotedType result_type;
+          return globalDot(x,y,std::integral_constant<bool,std::is_floating_point<result_type>::value>());
+        }
+
+        //! Enable or disable exact, reproducible accumulation in globalDot().
+        void setReproducibleReductions(bool reproducible)
+        {
+          _reproducible = reproducible;
+        }
+
+        //! Returns whether globalDot() uses reproducible reductions.
+        bool reproducibleReductions() const
+        {
+          return _reproducible;
+        }
+
       private:
 
+        // Reproducible reductions are only available for real field types.
+        template<typename X, typename Y>
+        typename PromotionTraits<
+          typename X::field_type,
+          typename Y::field_type
+          >::PromotedType
+        globalDot(const X& x, const Y& y, std::false_type) const
+        {
+          return _gfs.gridView().comm().sum(disjointDot(x,y));
+        }
+
+        template<typename X, typename Y>
+        typename PromotionTraits<
+          typename X::field_type,
+          typename Y::field_type
+          >::PromotedType
+        globalDot(const X& x, const Y& y, std::true_type) const
+        {
+          if (!_reproducible)
+            return globalDot(x,y,std::false_type());
+          ReproducibleSum sum;
+          disjointDot(istl::container_tag(istl::raw(x)),istl::raw(x),istl::raw(y),istl::raw(_ranks),sum);
+          sum.allreduce(_gfs.gridView().comm());
+          return sum.value();
+        }
+
+        // Implementation for BlockVector, accumulates the products of all blocks into sum.
+        template<typename X, typename Y, typename Mask>
+        void disjointDot(istl::tags::block_vector, const X& x, const Y& y, const Mask& mask, ReproducibleSum& sum) const
+        {
+          typename Y::const_iterator y_it = y.begin();
+          typename Mask::const_iterator mask_it = mask.begin();
+          for (typename X::const_iterator x_it = x.begin(),
+                 end_it = x.end();
+               x_it != end_it;
+               ++x_it, ++y_it,  ++mask_it)
+            disjointDot(istl::container_tag(*x_it),*x_it,*y_it,*mask_it,sum);
+        }
+
+        // Implementation for FieldVector, accumulates the products of the owned DOFs into sum.
+        template<typename X, typename Y, typename Mask>
+        void disjointDot(istl::tags::field_vector, const X& x, const Y& y, const Mask& mask, ReproducibleSum& sum) const
+        {
+          typename Y::const_iterator y_it = y.begin();
+          typename Mask::const_iterator mask_it = mask.begin();
+          for (typename X::const_iterator x_it = x.begin(),
+                 end_it = x.end();
+               x_it != end_it;
+               ++x_it, ++y_it, ++mask_it)
+            if (*mask_it == _rank)
+              sum += Dune::dot(*x_it,*y_it);
+        }
+
         // Implementation for BlockVector, collects the result of recursively
         // invoking the algorithm on the vector blocks.
         template<typename X, typename Y, typename Mask>
@@ -276,6 +365,7 @@ namespace Dune {
         RankVector _ranks; // vector to identify unique decomposition
         GhostVector _ghosts; //vector to identify ghost dofs
         int _verbose; //verbosity
+        bool _reproducible; // use exact accumulation in globalDot()
 
         //! The actual communication interface used when algorithm requires InteriorBorder_All_Interface.
         InterfaceType _interiorBorder_all_interface;
@@ -284,6 +374,32 @@ namespace Dune {
         InterfaceType _all_all_interface;
       };
 
+      //! Base class for the parallel solver backends that own a ParallelHelper
+      template<typename GFS>
+      class ParallelHelperStorage
+      {
+      public:
+
+        ParallelHelperStorage (const GFS& gfs, int verbose = 1)
+          : phelper(gfs,verbose)
+        {}
+
+        //! The ParallelHelper used by the solver, e.g. to enable reproducible reductions.
+        const ParallelHelper<GFS>& parallelHelper() const
+        {
+          return phelper;
+        }
+
+        //! \copydoc parallelHelper() const
+        ParallelHelper<GFS>& parallelHelper()
+        {
+          return phelper;
+        }
+
+      protected:
+        ParallelHelper<GFS> phelper;
+      };
+
 #if HAVE_MPI
 
       template<typename GFS>
@@ -258,6 +258,14 @@ namespace Dune {
 
     };
 
+    //! Approximate memory footprint of the matrix entries and the sparsity pattern, see MultiStepCache
+    template<typename GFSV, typename GFSU, typename C, typename Stats>
+    std::size_t multiStepCacheBytes(const ISTLMatrixContainer<GFSV,GFSU,C,Stats>& m)
+    {
+      return m.base().nonzeroes() * (sizeof(typename C::block_type) + sizeof(typename C::size_type))
+        + m.base().N() * sizeof(typename C::row_type);
+    }
+
   } // namespace PDELab
 } // namespace Dune
 
@@ -302,6 +302,13 @@ namespace Dune {
       std::shared_ptr<Container> _container;
     };
 
+    //! Approximate memory footprint of the coefficients, see MultiStepCache
+    template<typename GFS, typename C>
+    std::size_t multiStepCacheBytes(const ISTLBlockVectorContainer<GFS,C>& v)
+    {
+      return v.base().dim() * sizeof(typename C::field_type);
+    }
+
 
 
 
@@ -150,11 +150,8 @@ namespace Dune {
       */
       virtual field_type dot (const X& x, const X& y)
       {
-        // do local scalar product on unique partition
-        field_type sum = helper.disjointDot(x,y);
-
-        // do global communication
-        return gfs.gridView().comm().sum(sum);
+        // do local scalar product on unique partition and global communication
+        return helper.globalDot(x,y);
       }
 
       /*! \brief Norm of a right-hand side vector.
@@ -320,9 +317,8 @@ namespace Dune {
     //! \brief Nonoverlapping parallel CG solver without preconditioner
     template<class GFS>
     class ISTLBackend_NOVLP_CG_NOPREC
+      : public istl::ParallelHelperStorage<GFS>
     {
-      typedef istl::ParallelHelper<GFS> PHELPER;
-
     public:
       /*! \brief make a linear solver object
 
@@ -333,7 +329,7 @@ namespace Dune {
       explicit ISTLBackend_NOVLP_CG_NOPREC (const GFS& gfs_,
                                             unsigned maxiter_=5000,
                                             int verbose_=1)
-        : gfs(gfs_), phelper(gfs,verbose_), maxiter(maxiter_), verbose(verbose_)
+        : istl::ParallelHelperStorage<GFS>(gfs_,verbose_), gfs(gfs_), maxiter(maxiter_), verbose(verbose_)
       {}
 
       /*! \brief compute global norm of a vector
@@ -345,7 +341,7 @@ namespace Dune {
       {
         V x(v); // make a copy because it has to be made consistent
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
         psp.make_consistent(x);
         return psp.norm(x);
       }
@@ -363,9 +359,9 @@ namespace Dune {
         typedef Dune::PDELab::NonoverlappingOperator<GFS,M,V,W> POP;
         POP pop(gfs,A);
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
         typedef Dune::PDELab::NonoverlappingRichardson<GFS,V,W> PRICH;
-        PRICH prich(gfs,phelper);
+        PRICH prich(gfs,this->phelper);
         int verb=0;
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         Dune::CGSolver<V> solver(pop,psp,prich,reduction,maxiter,verb);
@@ -386,7 +382,6 @@ namespace Dune {
 
     private:
       const GFS& gfs;
-      PHELPER phelper;
       Dune::PDELab::LinearSolverResult<double> res;
       unsigned maxiter;
       int verbose;
@@ -395,11 +390,9 @@ namespace Dune {
     //! \brief Nonoverlapping parallel CG solver with Jacobi preconditioner
     template<class GFS>
     class ISTLBackend_NOVLP_CG_Jacobi
+      : public istl::ParallelHelperStorage<GFS>
     {
-      typedef istl::ParallelHelper<GFS> PHELPER;
-
       const GFS& gfs;
-      PHELPER phelper;
       LinearSolverResult<double> res;
       unsigned maxiter;
       int verbose;
@@ -414,7 +407,7 @@ namespace Dune {
       explicit ISTLBackend_NOVLP_CG_Jacobi(const GFS& gfs_,
                                            unsigned maxiter_ = 5000,
                                            int verbose_ = 1) :
-        gfs(gfs_), phelper(gfs,verbose_), maxiter(maxiter_), verbose(verbose_)
+        istl::ParallelHelperStorage<GFS>(gfs_,verbose_), gfs(gfs_), maxiter(maxiter_), verbose(verbose_)
       {}
 
       //! compute global norm of a vector
@@ -428,7 +421,7 @@ namespace Dune {
       {
         V x(v); // make a copy because it has to be made consistent
         typedef NonoverlappingScalarProduct<GFS,V> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
         psp.make_consistent(x);
         return psp.norm(x);
       }
@@ -452,7 +445,7 @@ namespace Dune {
         typedef NonoverlappingOperator<GFS,M,V,W> POP;
         POP pop(gfs,A);
         typedef NonoverlappingScalarProduct<GFS,V> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
 
         typedef NonoverlappingJacobi<M,V,W> PPre;
         PPre ppre(gfs,istl::raw(A));
@@ -477,9 +470,8 @@ namespace Dune {
     //! \brief Nonoverlapping parallel BiCGStab solver without preconditioner
     template<class GFS>
     class ISTLBackend_NOVLP_BCGS_NOPREC
+      : public istl::ParallelHelperStorage<GFS>
     {
-      typedef istl::ParallelHelper<GFS> PHELPER;
-
     public:
       /*! \brief make a linear solver object
 
@@ -488,7 +480,7 @@ namespace Dune {
         \param[in] verbose_ print messages if true
       */
       explicit ISTLBackend_NOVLP_BCGS_NOPREC (const GFS& gfs_, unsigned maxiter_=5000, int verbose_=1)
-        : gfs(gfs_), phelper(gfs,verbose_), maxiter(maxiter_), verbose(verbose_)
+        : istl::ParallelHelperStorage<GFS>(gfs_,verbose_), gfs(gfs_), maxiter(maxiter_), verbose(verbose_)
       {}
 
       /*! \brief compute global norm of a vector
@@ -500,7 +492,7 @@ namespace Dune {
       {
         V x(v); // make a copy because it has to be made consistent
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
         psp.make_consistent(x);
         return psp.norm(x);
       }
@@ -518,9 +510,9 @@ namespace Dune {
         typedef Dune::PDELab::NonoverlappingOperator<GFS,M,V,W> POP;
         POP pop(gfs,A);
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
         typedef Dune::PDELab::NonoverlappingRichardson<GFS,V,W> PRICH;
-        PRICH prich(gfs,phelper);
+        PRICH prich(gfs,this->phelper);
         int verb=0;
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         Dune::BiCGSTABSolver<V> solver(pop,psp,prich,reduction,maxiter,verb);
@@ -541,7 +533,6 @@ namespace Dune {
 
     private:
       const GFS& gfs;
-      PHELPER phelper;
       Dune::PDELab::LinearSolverResult<double> res;
       unsigned maxiter;
       int verbose;
@@ -551,9 +542,8 @@ namespace Dune {
     //! \brief Nonoverlapping parallel BiCGStab solver with Jacobi preconditioner
     template<class GFS>
     class ISTLBackend_NOVLP_BCGS_Jacobi
+      : public istl::ParallelHelperStorage<GFS>
     {
-      typedef istl::ParallelHelper<GFS> PHELPER;
-
     public:
       /*! \brief make a linear solver object
 
@@ -562,7 +552,7 @@ namespace Dune {
         \param[in] verbose_ print messages if true
       */
       explicit ISTLBackend_NOVLP_BCGS_Jacobi (const GFS& gfs_, unsigned maxiter_=5000, int verbose_=1)
-        : gfs(gfs_), phelper(gfs,verbose_), maxiter(maxiter_), verbose(verbose_)
+        : istl::ParallelHelperStorage<GFS>(gfs_,verbose_), gfs(gfs_), maxiter(maxiter_), verbose(verbose_)
       {}
 
       /*! \brief compute global norm of a vector
@@ -574,7 +564,7 @@ namespace Dune {
       {
         V x(v); // make a copy because it has to be made consistent
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
         psp.make_consistent(x);
         return psp.norm(x);
       }
@@ -592,7 +582,7 @@ namespace Dune {
         typedef Dune::PDELab::NonoverlappingOperator<GFS,M,V,W> POP;
         POP pop(gfs,A);
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
 
         typedef NonoverlappingJacobi<M,V,W> PPre;
         PPre ppre(gfs,A);
@@ -617,7 +607,6 @@ namespace Dune {
 
     private:
       const GFS& gfs;
-      PHELPER phelper;
       Dune::PDELab::LinearSolverResult<double> res;
       unsigned maxiter;
       int verbose;
@@ -626,11 +615,9 @@ namespace Dune {
     //! Solver to be used for explicit time-steppers with (block-)diagonal mass matrix
     template<typename GFS>
     class ISTLBackend_NOVLP_ExplicitDiagonal
+      : public istl::ParallelHelperStorage<GFS>
     {
-      typedef istl::ParallelHelper<GFS> PHELPER;
-
       const GFS& gfs;
-      PHELPER phelper;
       Dune::PDELab::LinearSolverResult<double> res;
 
     public:
@@ -640,7 +627,7 @@ namespace Dune {
         communication
       */
       explicit ISTLBackend_NOVLP_ExplicitDiagonal(const GFS& gfs_)
-        : gfs(gfs_), phelper(gfs)
+        : istl::ParallelHelperStorage<GFS>(gfs_), gfs(gfs_)
       {}
 
       /*! \brief compute global norm of a vector
@@ -652,7 +639,7 @@ namespace Dune {
       {
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
         V x(v); // make a copy because it has to be made consistent
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
         psp.make_consistent(x);
         return psp.norm(x);
       }
@@ -696,9 +683,9 @@ namespace Dune {
              template<class,class,class,int> class Preconditioner,
              template<class> class Solver>
     class ISTLBackend_NOVLP_BASE_PREC
+      : public istl::ParallelHelperStorage<typename GO::Traits::TrialGridFunctionSpace>
     {
       typedef typename GO::Traits::TrialGridFunctionSpace GFS;
-      typedef istl::ParallelHelper<GFS> PHELPER;
 
     public:
       /*! \brief Constructor.
@@ -709,9 +696,9 @@ namespace Dune {
         \param[in] verbose_ print messages if true
       */
       explicit ISTLBackend_NOVLP_BASE_PREC (const GO& grid_operator, unsigned maxiter_ = 5000, unsigned steps_ = 5, int verbose_ = 1)
-        : _grid_operator(grid_operator)
+        : istl::ParallelHelperStorage<GFS>(grid_operator.trialGridFunctionSpace(),verbose_)
+        , _grid_operator(grid_operator)
         , gfs(grid_operator.trialGridFunctionSpace())
-        , phelper(gfs,verbose_)
         , maxiter(maxiter_)
         , steps(steps_)
         , verbose(verbose_)
@@ -726,7 +713,7 @@ namespace Dune {
       {
         Vector x(v); // make a copy because it has to be made consistent
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,Vector> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
         psp.make_consistent(x);
         return psp.norm(x);
       }
@@ -748,7 +735,7 @@ namespace Dune {
         typedef typename istl::CommSelector<96,Dune::MPIHelper::isFake>::type Comm;
         _grid_operator.make_consistent(A);
         Comm oocc(gfs.gridView().comm(),Dune::SolverCategory::nonoverlapping);
-        phelper.createIndexSetAndProjectForAMG(mat, oocc);
+        this->phelper.createIndexSetAndProjectForAMG(mat, oocc);
         typedef Preconditioner<MatrixType,VectorType,VectorType,1> Smoother;
         Smoother smoother(mat, steps, 1.0);
         typedef Dune::NonoverlappingSchwarzScalarProduct<VectorType,Comm> PSP;
@@ -794,7 +781,6 @@ namespace Dune {
     private:
       const GO& _grid_operator;
       const GFS& gfs;
-      PHELPER phelper;
       Dune::PDELab::LinearSolverResult<double> res;
       unsigned maxiter;
       unsigned steps;
@@ -860,10 +846,10 @@ namespace Dune {
 
     template<class GO,int s, template<class,class,class,int> class Preconditioner,
              template<class> class Solver>
-    class ISTLBackend_AMG_NOVLP : public LinearResultStorage
+    class ISTLBackend_AMG_NOVLP
+      : public LinearResultStorage, public istl::ParallelHelperStorage<typename GO::Traits::TrialGridFunctionSpace>
     {
       typedef typename GO::Traits::TrialGridFunctionSpace GFS;
-      typedef typename istl::ParallelHelper<GFS> PHELPER;
       typedef typename GO::Traits::Jacobian M;
       typedef typename M::BaseT MatrixType;
       typedef typename GO::Traits::Domain V;
@@ -885,9 +871,9 @@ namespace Dune {
       ISTLBackend_AMG_NOVLP(const GO& grid_operator, unsigned maxiter_=5000,
                             int verbose_=1, bool reuse_=false,
                             bool usesuperlu_=true)
-        : _grid_operator(grid_operator)
+        : istl::ParallelHelperStorage<GFS>(grid_operator.trialGridFunctionSpace(),verbose_)
+        , _grid_operator(grid_operator)
         , gfs(grid_operator.trialGridFunctionSpace())
-        , phelper(gfs,verbose_)
         , maxiter(maxiter_)
         , params(15,2000,1.2,1.6,Dune::Amg::atOnceAccu)
         , verbose(verbose_)
@@ -898,7 +884,7 @@ namespace Dune {
         params.setDefaultValuesIsotropic(GFS::Traits::GridViewType::Traits::Grid::dimension);
         params.setDebugLevel(verbose_);
 #if !HAVE_SUPERLU
-        if (phelper.rank() == 0 && usesuperlu == true)
+        if (this->phelper.rank() == 0 && usesuperlu == true)
           {
             std::cout << "WARNING: You are using AMG without SuperLU!"
                       << " Please consider installing SuperLU,"
@@ -934,6 +920,22 @@ namespace Dune {
         return params;
       }
 
+      /*! \brief Set whether the AMG should be reused again in call to apply().
+
+        \param[in] reuse_ if true, the hierarchy of the last call is used for
+        the next solve; it is always built on the first call
+      */
+      void setReuse(bool reuse_)
+      {
+        reuse = reuse_;
+      }
+
+      //! Return whether the AMG is reused during call to apply()
+      bool getReuse() const
+      {
+        return reuse;
+      }
+
       /*! \brief compute global norm of a vector
 
         \param[in] v the given vector
@@ -942,7 +944,7 @@ namespace Dune {
       {
         V x(v); // make a copy because it has to be made consistent
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
         psp.make_consistent(x);
         return psp.norm(x);
       }
@@ -956,7 +958,7 @@ namespace Dune {
 #if HAVE_MPI
         Comm oocc(gfs.gridView().comm(),Dune::SolverCategory::nonoverlapping);
         _grid_operator.make_consistent(A);
-        phelper.createIndexSetAndProjectForAMG(A, oocc);
+        this->phelper.createIndexSetAndProjectForAMG(A, oocc);
         Dune::NonoverlappingSchwarzScalarProduct<VectorType,Comm> sp(oocc);
         Operator oop(mat, oocc);
 #else
@@ -1014,7 +1016,6 @@ namespace Dune {
     private:
       const GO& _grid_operator;
       const GFS& gfs;
-      PHELPER phelper;
       unsigned maxiter;
       Parameters params;
       int verbose;
@@ -107,11 +107,8 @@ namespace Dune {
       */
       virtual field_type dot (const X& x, const X& y)
       {
-        // do local scalar product on unique partition
-        field_type sum = helper.disjointDot(x,y);
-
-        // do global communication
-        return gfs.gridView().comm().sum(sum);
+        // do local scalar product on unique partition and global communication
+        return helper.globalDot(x,y);
       }
 
       /*! \brief Norm of a right-hand side vector.
@@ -333,11 +330,8 @@ namespace Dune {
       template<typename X>
       typename X::ElementType dot (const X& x, const X& y) const
       {
-        // do local scalar product on unique partition
-        typename X::ElementType sum = helper.disjointDot(x,y);
-
-        // do global communication
-        return gfs.gridView().comm().sum(sum);
+        // do local scalar product on unique partition and global communication
+        return helper.globalDot(x,y);
       }
 
       /*! \brief Norm of a right-hand side vector.
@@ -894,10 +888,10 @@ namespace Dune {
 
     template<class GO, int s, template<class,class,class,int> class Preconditioner,
              template<class> class Solver>
-    class ISTLBackend_AMG : public LinearResultStorage
+    class ISTLBackend_AMG
+      : public LinearResultStorage, public istl::ParallelHelperStorage<typename GO::Traits::TrialGridFunctionSpace>
     {
       typedef typename GO::Traits::TrialGridFunctionSpace GFS;
-      typedef istl::ParallelHelper<GFS> PHELPER;
       typedef typename GO::Traits::Jacobian M;
       typedef typename M::BaseT MatrixType;
       typedef typename GO::Traits::Domain V;
@@ -927,7 +921,7 @@ namespace Dune {
       ISTLBackend_AMG(const GFS& gfs_, unsigned maxiter_=5000,
                       int verbose_=1, bool reuse_=false,
                       bool usesuperlu_=true)
-        : gfs(gfs_), phelper(gfs,verbose_), maxiter(maxiter_), params(15,2000),
+        : istl::ParallelHelperStorage<GFS>(gfs_,verbose_), gfs(gfs_), maxiter(maxiter_), params(15,2000),
           verbose(verbose_), reuse(reuse_), firstapply(true),
           usesuperlu(usesuperlu_)
       {
@@ -970,6 +964,22 @@ namespace Dune {
         return params;
       }
 
+      /*! \brief Set whether the AMG should be reused again in call to apply().
+
+        \param[in] reuse_ if true, the hierarchy of the last call is used for
+        the next solve; it is always built on the first call
+      */
+      void setReuse(bool reuse_)
+      {
+        reuse = reuse_;
+      }
+
+      //! Return whether the AMG is reused during call to apply()
+      bool getReuse() const
+      {
+        return reuse;
+      }
+
       /*! \brief compute global norm of a vector
 
         \param[in] v the given vector
@@ -977,7 +987,7 @@ namespace Dune {
       typename V::ElementType norm (const V& v) const
       {
         typedef OverlappingScalarProduct<GFS,V> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,this->phelper);
         return psp.norm(v);
       }
 
@@ -996,7 +1006,7 @@ namespace Dune {
         typedef Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<MatrixType,
           Dune::Amg::FirstDiagonal> > Criterion;
 #if HAVE_MPI
-        phelper.createIndexSetAndProjectForAMG(A, oocc);
+        this->phelper.createIndexSetAndProjectForAMG(A, oocc);
         Operator oop(mat, oocc);
         Dune::OverlappingSchwarzScalarProduct<VectorType,Comm> sp(oocc);
 #else
@@ -1044,7 +1054,6 @@ namespace Dune {
 
     private:
       const GFS& gfs;
-      PHELPER phelper;
       unsigned maxiter;
       Parameters params;
       int verbose;
@@ -584,6 +584,22 @@ namespace Dune {
         params = params_;
       }
 
+      /*! \brief Set whether the AMG should be reused again in call to apply().
+
+        \param[in] reuse_ if true, the hierarchy of the last call is used for
+        the next solve; it is always built on the first call
+      */
+      void setReuse(bool reuse_)
+      {
+        reuse = reuse_;
+      }
+
+      //! Return whether the AMG is reused during call to apply()
+      bool getReuse() const
+      {
+        return reuse;
+      }
+
       /*! \brief compute global norm of a vector
 
         \param[in] v the given vector
@@ -839,6 +855,96 @@ namespace Dune {
       int restart, maxiter, verbose;
     };
 
+    /** \brief Linear solver backend for Jacobian-free Newton-Krylov methods
+
+        Solves with restarted GMRes on an arbitrary linear operator (e.g. a
+        finite difference approximation of the Jacobian action), preconditioned
+        by a preconditioner built from an assembled matrix which may be lagged
+        or stem from a simplified linearization. When called with a matrix
+        only, it behaves like an ordinary matrix-based backend.
+
+        \tparam Preconditioner ISTL preconditioner template taking (matrix, steps, relaxation)
+    */
+    template<template<class,class,class,int> class Preconditioner>
+    class ISTLBackend_SEQ_JacobianFree_GMRES
+      : public SequentialNorm, public LinearResultStorage
+    {
+    public :
+
+      /** \brief make linear solver object
+
+          \param[in] restart_ number of iterations when GMRes has to be restarted
+          \param[in] maxiter_ maximum number of iterations to do
+          \param[in] verbose_ print messages if true
+          \param[in] steps_ number of preconditioner sweeps
+      */
+      explicit ISTLBackend_SEQ_JacobianFree_GMRES(int restart_ = 100, int maxiter_ = 5000, int verbose_ = 1,
+                                                  int steps_ = 1)
+        : restart(restart_), maxiter(maxiter_), verbose(verbose_), steps(steps_)
+      {}
+
+      /** \brief solve the given linear system
+
+          \param[in] A the given matrix
+          \param[out] z the solution vector to be computed
+          \param[in] r right hand side
+          \param[in] reduction to be achieved
+      */
+      template<class M, class V, class W>
+      void apply(M& A, V& z, W& r, typename Dune::template FieldTraits<typename W::ElementType>::real_type reduction)
+      {
+        Dune::MatrixAdapter<
+          typename istl::raw_type<M>::type,
+          typename istl::raw_type<V>::type,
+          typename istl::raw_type<W>::type> opa(istl::raw(A));
+        apply(opa, A, z, r, reduction);
+      }
+
+      /** \brief solve a linear system given by an operator, preconditioned by a matrix
+
+          \param[in] op the operator of the linear system, acting on the raw vectors
+          \param[in] P the matrix to build the preconditioner from
+          \param[out] z the solution vector to be computed
+          \param[in] r right hand side
+          \param[in] reduction to be achieved
+      */
+      template<class Op, class M, class V, class W>
+      void apply(Op& op, M& P, V& z, W& r, typename Dune::template FieldTraits<typename W::ElementType>::real_type reduction)
+      {
+        Preconditioner<
+          typename istl::raw_type<M>::type,
+          typename istl::raw_type<V>::type,
+          typename istl::raw_type<W>::type,1> prec(istl::raw(P), steps, 1.0);
+        Dune::RestartedGMResSolver<typename istl::raw_type<V>::type> solver(op,prec,reduction,restart,maxiter,verbose);
+        Dune::InverseOperatorResult stat;
+        solver.apply(istl::raw(z), istl::raw(r), stat);
+        res.converged  = stat.converged;
+        res.iterations = stat.iterations;
+        res.elapsed    = stat.elapsed;
+        res.reduction  = stat.reduction;
+        res.conv_rate  = stat.conv_rate;
+      }
+
+    private :
+      int restart, maxiter, verbose, steps;
+    };
+
+    //! \brief Jacobian-free GMRes backend preconditioned with SSOR of the assembled matrix
+    class ISTLBackend_SEQ_JacobianFree_GMRES_SSOR
+      : public ISTLBackend_SEQ_JacobianFree_GMRES<Dune::SeqSSOR>
+    {
+    public:
+      /** \brief make linear solver object
+
+          \param[in] restart_ number of iterations when GMRes has to be restarted
+          \param[in] maxiter_ maximum number of iterations to do
+          \param[in] verbose_ print messages if true
+      */
+      explicit ISTLBackend_SEQ_JacobianFree_GMRES_SSOR(int restart_ = 100, int maxiter_ = 5000, int verbose_ = 1)
+        : ISTLBackend_SEQ_JacobianFree_GMRES<Dune::SeqSSOR>(restart_, maxiter_, verbose_)
+      {}
+    };
+
     //! \} group Sequential Solvers
     //! \} group Backend
 
@@ -0,0 +1,337 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_BACKEND_SIMPLE_MAPPEDVECTOR_HH
+#define DUNE_PDELAB_BACKEND_SIMPLE_MAPPEDVECTOR_HH
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <dune/common/exceptions.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    namespace simple {
+
+      //! A std::vector replacement whose storage is a memory mapped file
+      /**
+       * MappedVector can be used as the container of the simple vector
+       * backend, i.e. SimpleVectorBackend<simple::MappedVector>, or be
+       * attached to a single simple::VectorContainer with the constructor
+       * that takes an explicit container.
+       *
+       * A MappedVector opened with a file name maps that file, so its data
+       * is written back by the page cache of the operating system without
+       * an explicit copy, and an existing file is loaded lazily when its
+       * pages are accessed. Vectors created without a file name (e.g. by
+       * the vector backend) are backed by an unlinked temporary file in
+       * $TMPDIR, so their pages can be evicted from memory as well.
+       * evict() writes the data back and releases the resident pages,
+       * which keeps the memory usage bounded when storing many snapshots.
+       *
+       * Requires POSIX memory mapping, so this header is not included by
+       * backend/simple.hh.
+       *
+       * \tparam E The entry type, which must be trivially copyable.
+       */
+      template<typename E>
+      class MappedVector
+      {
+
+        static_assert(std::is_trivially_copyable<E>::value,
+                      "MappedVector can only store trivially copyable types");
+
+      public:
+
+        typedef E value_type;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef E& reference;
+        typedef const E& const_reference;
+        typedef E* iterator;
+        typedef const E* const_iterator;
+
+        //! How a named file is mapped
+        struct Mode {
+          enum type {
+            //! create the file or truncate an existing one
+            create,
+            //! map an existing file for reading and writing
+            open,
+            //! map an existing file read only, writing the vector is an error
+            readOnly
+          };
+        };
+
+        MappedVector()
+          : _fd(-1)
+          , _data(nullptr)
+          , _size(0)
+          , _read_only(false)
+        {
+          createTemporary();
+        }
+
+        explicit MappedVector(size_type n)
+          : MappedVector()
+        {
+          resize(n);
+        }
+
+        MappedVector(size_type n, const E& e)
+          : MappedVector()
+        {
+          resize(n);
+          std::fill(begin(),end(),e);
+        }
+
+        //! Map the file filename
+        /**
+         * Opening an existing file makes the vector as large as the file.
+         */
+        MappedVector(const std::string& filename, typename Mode::type mode)
+          : _filename(filename)
+          , _fd(-1)
+          , _data(nullptr)
+          , _size(0)
+          , _read_only(mode == Mode::readOnly)
+        {
+          int flags = _read_only ? O_RDONLY : O_RDWR;
+          if (mode == Mode::create)
+            flags |= O_CREAT | O_TRUNC;
+          _fd = ::open(filename.c_str(),flags,0644);
+          if (_fd < 0)
+            DUNE_THROW(IOError,"could not open " << filename << ": " << std::strerror(errno));
+
+          // the destructor does not run if the constructor throws
+          try
+            {
+              struct stat status;
+              if (::fstat(_fd,&status) != 0)
+                DUNE_THROW(IOError,"could not stat " << filename << ": " << std::strerror(errno));
+              if (status.st_size % sizeof(E) != 0)
+                DUNE_THROW(IOError,"size of " << filename << " is not a multiple of the entry size");
+              _size = status.st_size / sizeof(E);
+              map();
+            }
+          catch (...)
+            {
+              ::close(_fd);
+              throw;
+            }
+        }
+
+        //! Creates a copy in a new temporary file
+        MappedVector(const MappedVector& rhs)
+          : MappedVector(rhs.size())
+        {
+          std::copy(rhs.begin(),rhs.end(),begin());
+        }
+
+        MappedVector(MappedVector&& rhs)
+          : _filename(std::move(rhs._filename))
+          , _fd(rhs._fd)
+          , _data(rhs._data)
+          , _size(rhs._size)
+          , _read_only(rhs._read_only)
+        {
+          rhs._fd = -1;
+          rhs._data = nullptr;
+          rhs._size = 0;
+        }
+
+        ~MappedVector()
+        {
+          unmap();
+          if (_fd >= 0)
+            ::close(_fd);
+        }
+
+        //! Copies the data of rhs into the file of this vector
+        MappedVector& operator=(const MappedVector& rhs)
+        {
+          if (this == &rhs)
+            return *this;
+          resize(rhs.size());
+          std::copy(rhs.begin(),rhs.end(),begin());
+          return *this;
+        }
+
+        MappedVector& operator=(MappedVector&& rhs)
+        {
+          std::swap(_filename,rhs._filename);
+          std::swap(_fd,rhs._fd);
+          std::swap(_data,rhs._data);
+          std::swap(_size,rhs._size);
+          std::swap(_read_only,rhs._read_only);
+          return *this;
+        }
+
+        //! Change the size of the vector and of the underlying file
+        /**
+         * New entries are zero, existing pointers and iterators become invalid.
+         */
+        void resize(size_type n)
+        {
+          if (n == _size)
+            return;
+          if (_read_only)
+            DUNE_THROW(InvalidStateException,"cannot resize read only mapping of " << _filename);
+          unmap();
+          if (::ftruncate(_fd,n * sizeof(E)) != 0)
+            {
+              const int error = errno;
+              // keep the old data accessible
+              map();
+              DUNE_THROW(IOError,"could not resize " << name() << ": " << std::strerror(error));
+            }
+          _size = n;
+          map();
+        }
+
+        //! Start writing modified pages back to the file
+        /**
+         * \param wait Block until the data has been written.
+         */
+        void sync(bool wait = false)
+        {
+          if (_data && !_read_only && ::msync(_data,bytes(),wait ? MS_SYNC : MS_ASYNC) != 0)
+            DUNE_THROW(IOError,"could not sync " << name() << ": " << std::strerror(errno));
+        }
+
+        //! Write the data back and release the resident pages
+        /**
+         * The data stays accessible and is read back from the file on the
+         * next access.
+         */
+        void evict()
+        {
+          if (!_data)
+            return;
+          sync(true);
+          ::madvise(_data,bytes(),MADV_DONTNEED);
+        }
+
+        //! The mapped file, empty for temporary storage
+        const std::string& filename() const
+        {
+          return _filename;
+        }
+
+        size_type size() const
+        {
+          return _size;
+        }
+
+        bool empty() const
+        {
+          return _size == 0;
+        }
+
+        E* data()
+        {
+          return _data;
+        }
+
+        const E* data() const
+        {
+          return _data;
+        }
+
+        E& operator[](size_type i)
+        {
+          return _data[i];
+        }
+
+        const E& operator[](size_type i) const
+        {
+          return _data[i];
+        }
+
+        iterator begin()
+        {
+          return _data;
+        }
+
+        const_iterator begin() const
+        {
+          return _data;
+        }
+
+        iterator end()
+        {
+          return _data + _size;
+        }
+
+        const_iterator end() const
+        {
+          return _data + _size;
+        }
+
+      private:
+
+        std::string name() const
+        {
+          return _filename.empty() ? std::string("temporary vector storage") : _filename;
+        }
+
+        std::size_t bytes() const
+        {
+          return _size * sizeof(E);
+        }
+
+        void createTemporary()
+        {
+          const char* dir = std::getenv("TMPDIR");
+          std::string pattern = std::string(dir && *dir ? dir : "/tmp") + "/pdelab-vector-XXXXXX";
+          std::vector<char> buffer(pattern.begin(),pattern.end());
+          buffer.push_back('\0');
+          _fd = ::mkstemp(buffer.data());
+          if (_fd < 0)
+            DUNE_THROW(IOError,"could not create temporary file " << pattern << ": " << std::strerror(errno));
+          // the storage is released together with the file descriptor
+          ::unlink(buffer.data());
+        }
+
+        void map()
+        {
+          if (_size == 0)
+            return;
+          void* p = ::mmap(nullptr,bytes(),_read_only ? PROT_READ : PROT_READ | PROT_WRITE,MAP_SHARED,_fd,0);
+          if (p == MAP_FAILED)
+            DUNE_THROW(IOError,"could not map " << name() << ": " << std::strerror(errno));
+          _data = static_cast<E*>(p);
+        }
+
+        void unmap()
+        {
+          if (_data)
+            ::munmap(_data,bytes());
+          _data = nullptr;
+        }
+
+        std::string _filename;
+        int _fd;
+        E* _data;
+        size_type _size;
+        bool _read_only;
+
+      };
+
+    } // namespace simple
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_BACKEND_SIMPLE_MAPPEDVECTOR_HH
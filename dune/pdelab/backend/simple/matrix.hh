@@ -201,6 +201,13 @@ namespace Dune {
         std::shared_ptr<Container> _container;
       };
 
+      //! Approximate memory footprint of the dense matrix, see MultiStepCache
+      template<typename GFSV, typename GFSU, typename C>
+      std::size_t multiStepCacheBytes(const MatrixContainer<GFSV,GFSU,C>& m)
+      {
+        return m.N() * m.M() * sizeof(typename MatrixContainer<GFSV,GFSU,C>::ElementType);
+      }
+
     } // namespace simple
 
   } // namespace PDELab
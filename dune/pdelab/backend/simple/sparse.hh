@@ -323,6 +323,13 @@ namespace Dune {
         std::shared_ptr< Container > _container;
       };
 
+      //! Approximate memory footprint of the CSR arrays, see MultiStepCache
+      template<typename GFSV, typename GFSU, template<typename> class C, typename ET, typename I>
+      std::size_t multiStepCacheBytes(const SparseMatrixContainer<GFSV,GFSU,C,ET,I>& m)
+      {
+        return m.base()._non_zeros * (sizeof(ET) + sizeof(I)) + (m.N() + 1) * sizeof(I);
+      }
+
     } // namespace simple
   } // namespace PDELab
 } // namespace Dune
@@ -303,6 +303,13 @@ namespace Dune {
         std::shared_ptr<Container> _container;
       };
 
+      //! Approximate memory footprint of the coefficients, see MultiStepCache
+      template<typename GFS, typename C>
+      std::size_t multiStepCacheBytes(const VectorContainer<GFS,C>& v)
+      {
+        return v.N() * sizeof(typename VectorContainer<GFS,C>::ElementType);
+      }
+
 
     }
 
@@ -52,6 +52,39 @@ namespace Dune {
       Dune::PDELab::LinearSolverResult<double> res;
     };
 
+    namespace impl {
+
+      template<typename LS>
+      auto setLinearSolverReuse(LS& ls, bool reuse, int)
+        -> decltype(ls.setReuse(reuse), bool())
+      {
+        const bool old = ls.getReuse();
+        ls.setReuse(reuse);
+        return old;
+      }
+
+      template<typename LS>
+      bool setLinearSolverReuse(LS& ls, bool reuse, long)
+      {
+        return false;
+      }
+
+    } // namespace impl
+
+    //! Tell a solver backend whether it may reuse its preconditioner
+    /**
+     * Calls ls.setReuse() for backends that support keeping their
+     * preconditioner between calls to apply(), like the AMG backends, and
+     * does nothing for all other backends.
+     *
+     * \return the previous setting, false if the backend does not support reuse
+     */
+    template<typename LS>
+    bool setLinearSolverReuse(LS& ls, bool reuse)
+    {
+      return impl::setLinearSolverReuse(ls,reuse,0);
+    }
+
     //! \} group Backend
 
   } // end namespace PDELab
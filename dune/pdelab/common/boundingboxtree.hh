@@ -0,0 +1,355 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_COMMON_BOUNDINGBOXTREE_HH
+#define DUNE_PDELAB_COMMON_BOUNDINGBOXTREE_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/grid/common/gridenums.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup PDELab_Function Function
+    //! \ingroup PDELab
+    //! \{
+
+    //! Bounding volume hierarchy over the elements of a GridView for point location
+    /**
+     * The tree stores the axis aligned bounding box and the seed of every
+     * element of the grid view. It is built by recursive median splits of
+     * the element centers along the longest extent. The nodes are stored in
+     * depth first order, so the left child of a node directly follows it,
+     * and the elements are stored in leaf order, so each leaf covers a
+     * contiguous range of boxes and seeds. A point is located by descending
+     * into all nodes whose box contains it and checking the candidate
+     * elements with their geometry.
+     *
+     * If PDELab is compiled with OpenMP, the bounding boxes are computed
+     * in parallel and the subtrees are built as parallel tasks.
+     *
+     * Adapting or load balancing the grid invalidates the tree. A change of
+     * the number of elements or of the maximum level is detected
+     * automatically, any other change has to be announced with
+     * invalidate(). Queries on an invalid tree throw an
+     * InvalidStateException; call update() to rebuild it.
+     *
+     * \tparam GV Type of the GridView. The grid must have dim == dimworld.
+     */
+    template<typename GV>
+    class ElementBoundingBoxTree
+    {
+
+    public:
+
+      typedef typename GV::template Codim<0>::Entity Entity;
+      typedef typename Entity::EntitySeed EntitySeed;
+      typedef typename GV::ctype ctype;
+      static const int dim = GV::dimension;
+      typedef FieldVector<ctype,GV::dimensionworld> GlobalCoordinate;
+      typedef FieldVector<ctype,dim> LocalCoordinate;
+      typedef std::size_t size_type;
+
+      //! Build the tree over all elements of gv
+      /**
+       * \param gv        The GridView.
+       * \param leaf_size Maximal number of elements in a leaf of the tree.
+       */
+      explicit ElementBoundingBoxTree(const GV& gv, size_type leaf_size = 8)
+        : _gv(gv)
+        , _leaf_size(std::max(leaf_size,size_type(1)))
+        , _valid(false)
+        , _element_count(0)
+        , _max_level(0)
+      {
+        update();
+      }
+
+      //! Rebuild the tree from the current state of the grid view
+      void update()
+      {
+        _seeds.clear();
+        _partitions.clear();
+        _boxes.clear();
+        _nodes.clear();
+
+        const size_type n = _gv.size(0);
+        _seeds.reserve(n);
+        _partitions.reserve(n);
+        for (const auto& element : elements(_gv))
+          {
+            _seeds.push_back(element.seed());
+            _partitions.push_back(element.partitionType());
+          }
+
+        _boxes.resize(_seeds.size());
+        const std::ptrdiff_t count = _seeds.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (std::ptrdiff_t i = 0; i < count; ++i)
+          {
+            const Entity element = _gv.grid().entity(_seeds[i]);
+            const auto geometry = element.geometry();
+            Box& box = _boxes[i];
+            box.lower = box.upper = geometry.corner(0);
+            for (int c = 1; c < geometry.corners(); ++c)
+              box.expand(geometry.corner(c));
+          }
+
+        if (!_boxes.empty())
+          {
+            _order.resize(_boxes.size());
+            for (size_type i = 0; i < _order.size(); ++i)
+              _order[i] = i;
+            _nodes.resize(nodeCount(_boxes.size()));
+#ifdef _OPENMP
+#pragma omp parallel
+#pragma omp single
+#endif
+            build(0,0,_boxes.size());
+
+            // store the element data in leaf order
+            std::vector<EntitySeed> seeds;
+            std::vector<PartitionType> partitions;
+            std::vector<Box> boxes;
+            seeds.reserve(_order.size());
+            partitions.reserve(_order.size());
+            boxes.reserve(_order.size());
+            for (size_type i : _order)
+              {
+                seeds.push_back(_seeds[i]);
+                partitions.push_back(_partitions[i]);
+                boxes.push_back(_boxes[i]);
+              }
+            _seeds.swap(seeds);
+            _partitions.swap(partitions);
+            _boxes.swap(boxes);
+            std::vector<size_type>().swap(_order);
+          }
+
+        _element_count = n;
+        _max_level = _gv.grid().maxLevel();
+        _valid = true;
+      }
+
+      //! Mark the tree as outdated, e.g. after the grid has been load balanced
+      void invalidate()
+      {
+        _valid = false;
+      }
+
+      //! Whether the tree still matches the grid view
+      bool valid() const
+      {
+        return _valid
+          && size_type(_gv.size(0)) == _element_count
+          && _gv.grid().maxLevel() == _max_level;
+      }
+
+      //! The grid view the tree has been built for
+      const GV& gridView() const
+      {
+        return _gv;
+      }
+
+      //! Number of elements in the tree
+      size_type size() const
+      {
+        return _seeds.size();
+      }
+
+      //! Find an element containing the global coordinate x
+      /**
+       * \param x             The global coordinate.
+       * \param entity        On success, the element containing x.
+       * \param local         On success, the local coordinate of x in entity.
+       * \param interior_only Only accept elements of the interior partition.
+       * \return whether an element has been found.
+       */
+      bool findEntity(const GlobalCoordinate& x, Entity& entity, LocalCoordinate& local,
+                      bool interior_only = false) const
+      {
+        if (!valid())
+          DUNE_THROW(InvalidStateException,"ElementBoundingBoxTree is outdated, call update() after changing the grid");
+        if (_nodes.empty())
+          return false;
+
+        // stack of nodes to visit, the depth of the tree is logarithmic
+        size_type stack[2 * std::numeric_limits<size_type>::digits];
+        size_type top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+          {
+            const size_type index = stack[--top];
+            const Node& node = _nodes[index];
+            if (!node.box.contains(x,tolerance()))
+              continue;
+            if (node.right == none)
+              {
+                for (size_type i = node.begin; i < node.end; ++i)
+                  {
+                    if (interior_only && _partitions[i] != InteriorEntity)
+                      continue;
+                    if (!_boxes[i].contains(x,tolerance()))
+                      continue;
+                    Entity candidate = _gv.grid().entity(_seeds[i]);
+                    const auto geometry = candidate.geometry();
+                    const LocalCoordinate candidate_local = geometry.local(x);
+                    if (ReferenceElements<ctype,dim>::general(geometry.type()).checkInside(candidate_local))
+                      {
+                        entity = candidate;
+                        local = candidate_local;
+                        return true;
+                      }
+                  }
+              }
+            else
+              {
+                // the left child directly follows its parent
+                stack[top++] = node.right;
+                stack[top++] = index + 1;
+              }
+          }
+        return false;
+      }
+
+    private:
+
+      static const size_type none = std::numeric_limits<size_type>::max();
+
+      // subtrees with fewer elements are built without spawning tasks
+      static const size_type parallel_threshold = 4096;
+
+      static ctype tolerance()
+      {
+        return 1e-8;
+      }
+
+      struct Box
+      {
+        GlobalCoordinate lower;
+        GlobalCoordinate upper;
+
+        void expand(const GlobalCoordinate& x)
+        {
+          for (int i = 0; i < GlobalCoordinate::dimension; ++i)
+            {
+              lower[i] = std::min(lower[i],x[i]);
+              upper[i] = std::max(upper[i],x[i]);
+            }
+        }
+
+        void expand(const Box& box)
+        {
+          expand(box.lower);
+          expand(box.upper);
+        }
+
+        bool contains(const GlobalCoordinate& x, ctype tol) const
+        {
+          for (int i = 0; i < GlobalCoordinate::dimension; ++i)
+            {
+              const ctype eps = tol * (1.0 + upper[i] - lower[i]);
+              if (x[i] < lower[i] - eps || x[i] > upper[i] + eps)
+                return false;
+            }
+          return true;
+        }
+
+        GlobalCoordinate center() const
+        {
+          GlobalCoordinate c(lower);
+          c += upper;
+          c *= 0.5;
+          return c;
+        }
+      };
+
+      struct Node
+      {
+        Box box;
+        size_type begin, end;
+        size_type right;
+      };
+
+      // number of nodes of the subtree over n elements
+      size_type nodeCount(size_type n) const
+      {
+        if (n <= _leaf_size)
+          return 1;
+        return 1 + nodeCount(n / 2) + nodeCount(n - n / 2);
+      }
+
+      // build the subtree rooted at node over _order[begin,end)
+      void build(size_type node, size_type begin, size_type end)
+      {
+        Node& n = _nodes[node];
+        n.begin = begin;
+        n.end = end;
+        n.right = none;
+        n.box = _boxes[_order[begin]];
+        Box centers;
+        centers.lower = centers.upper = n.box.center();
+        for (size_type i = begin + 1; i < end; ++i)
+          {
+            n.box.expand(_boxes[_order[i]]);
+            centers.expand(_boxes[_order[i]].center());
+          }
+
+        if (end - begin <= _leaf_size)
+          return;
+
+        int axis = 0;
+        for (int i = 1; i < GlobalCoordinate::dimension; ++i)
+          if (centers.upper[i] - centers.lower[i] > centers.upper[axis] - centers.lower[axis])
+            axis = i;
+        const size_type middle = begin + (end - begin) / 2;
+        std::nth_element(_order.begin() + begin,_order.begin() + middle,_order.begin() + end,
+                         [this,axis](size_type a, size_type b) {
+                           return _boxes[a].lower[axis] + _boxes[a].upper[axis]
+                             < _boxes[b].lower[axis] + _boxes[b].upper[axis];
+                         });
+        const size_type left = node + 1;
+        const size_type right = left + nodeCount(middle - begin);
+        n.right = right;
+
+#ifdef _OPENMP
+#pragma omp task if(end - begin > parallel_threshold)
+#endif
+        build(left,begin,middle);
+        build(right,middle,end);
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
+      }
+
+      GV _gv;
+      size_type _leaf_size;
+      bool _valid;
+      size_type _element_count;
+      int _max_level;
+      std::vector<Node> _nodes;
+      std::vector<EntitySeed> _seeds;
+      std::vector<PartitionType> _partitions;
+      std::vector<Box> _boxes;
+      std::vector<size_type> _order;
+
+    };
+
+    //! \} Function
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_COMMON_BOUNDINGBOXTREE_HH
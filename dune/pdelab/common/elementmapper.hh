@@ -155,6 +155,12 @@ namespace Dune {
         return BaseT::map(e);
       }
 
+      //! Recompute the index offsets after the GridView has changed.
+      void update()
+      {
+        BaseT::update();
+      }
+
     };
 
   } // namespace PDELab
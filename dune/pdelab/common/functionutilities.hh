@@ -4,9 +4,11 @@
 #ifndef DUNE_PDELAB_COMMON_FUNCTIONUTILITIES_HH
 #define DUNE_PDELAB_COMMON_FUNCTIONUTILITIES_HH
 
+#include <cstddef>
 #include <limits>
 #include <ostream>
 #include <memory>
+#include <vector>
 
 #include <dune/common/debugstream.hh>
 
@@ -16,6 +18,9 @@
 #include <dune/grid/common/gridenums.hh>
 #include <dune/grid/utility/hierarchicsearch.hh>
 
+#include <dune/pdelab/common/boundingboxtree.hh>
+#include <dune/pdelab/common/reproduciblesum.hh>
+
 namespace Dune {
   namespace PDELab {
 
@@ -84,6 +89,129 @@ sum = gf.getGridView().comm().sum(sum);
       }
     }
 
+    //! Integrate a GridFunction using multiple threads
+    /**
+     * \code
+#include <dune/pdelab/common/functionutilities.hh>
+     * \endcode
+     *
+     * Like integrateGridFunction(), but if PDELab is compiled with OpenMP,
+     * the elements are integrated by multiple threads. The elements are
+     * processed in batches; the integrals over the elements of a batch are
+     * computed in parallel and then summed up in the element order, so the
+     * result does not depend on the number of threads. The GridFunction
+     * must support concurrent calls to evaluate(), which is not the case
+     * for functions with mutable state like DiscreteGridFunction.
+     *
+     * \tparam GF Type of the GridFunction.
+     * \param gf     The GridFunction object.
+     * \param sum    Resulting integral.
+     * \param qorder Quadrature order to use.
+     */
+    template<typename GF>
+    void threadedIntegrateGridFunction(const GF& gf,
+                                       typename GF::Traits::RangeType& sum,
+                                       unsigned qorder = 1) {
+      typedef typename GF::Traits::GridViewType GV;
+      typedef typename GV::template Codim<0>::Entity Element;
+      typedef typename Element::EntitySeed EntitySeed;
+      typedef typename GF::Traits::RangeType Range;
+      typedef typename GF::Traits::DomainFieldType DF;
+      static const int dimD = GF::Traits::dimDomain;
+      typedef Dune::QuadratureRules<DF,dimD> QRs;
+
+      // number of elements integrated between two summations
+      const std::size_t batch_size = 16384;
+
+      const GV& gv = gf.getGridView();
+      std::vector<EntitySeed> seeds;
+      std::vector<Range> element_sums;
+      seeds.reserve(batch_size);
+
+      sum = 0;
+      const auto range = elements(gv,Partitions::interior);
+      auto it = range.begin();
+      const auto end = range.end();
+      while (it != end)
+        {
+          seeds.clear();
+          for (; it != end && seeds.size() < batch_size; ++it)
+            seeds.push_back(it->seed());
+          element_sums.resize(seeds.size());
+
+          const std::ptrdiff_t count = seeds.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+          for (std::ptrdiff_t i = 0; i < count; ++i)
+            {
+              const Element element = gv.grid().entity(seeds[i]);
+              const auto geo = element.geometry();
+              Range& element_sum = element_sums[i];
+              element_sum = 0;
+              Range val;
+              for (const auto& qp : QRs::rule(geo.type(),qorder))
+                {
+                  gf.evaluate(element,qp.position(),val);
+                  val *= qp.weight() * geo.integrationElement(qp.position());
+                  element_sum += val;
+                }
+            }
+
+          for (const Range& element_sum : element_sums)
+            sum += element_sum;
+        }
+    }
+
+    //! Integrate a GridFunction over all ranks with a reproducible result
+    /**
+     * \code
+#include <dune/pdelab/common/functionutilities.hh>
+     * \endcode
+     *
+     * Like integrateGridFunction() followed by a global sum, but the
+     * contributions of all quadrature points are accumulated exactly with
+     * ReproducibleSum, so the result is the same bit by bit for any number
+     * of processes and any order of the elements. This function is
+     * collective and returns the integral over the whole domain on all
+     * ranks.
+     *
+     * \tparam GF Type of the GridFunction, its RangeType has to be a
+     *            FieldVector of a real type.
+     * \param gf     The GridFunction object.
+     * \param sum    Resulting integral.
+     * \param qorder Quadrature order to use.
+     */
+    template<typename GF>
+    void reproducibleIntegrateGridFunction(const GF& gf,
+                                           typename GF::Traits::RangeType& sum,
+                                           unsigned qorder = 1) {
+      typedef typename GF::Traits::RangeType Range;
+      typedef typename GF::Traits::DomainFieldType DF;
+      static const int dimD = GF::Traits::dimDomain;
+      typedef Dune::QuadratureRules<DF,dimD> QRs;
+
+      std::vector<ReproducibleSum> sums(Range::dimension);
+      Range val;
+      for (const auto& element : elements(gf.getGridView(),Partitions::interior))
+        {
+          const auto geo = element.geometry();
+          for (const auto& qp : QRs::rule(geo.type(),qorder))
+            {
+              gf.evaluate(element,qp.position(),val);
+              val *= qp.weight() * geo.integrationElement(qp.position());
+              for (int i = 0; i < Range::dimension; ++i)
+                sums[i] += val[i];
+            }
+        }
+
+      for (int i = 0; i < Range::dimension; ++i)
+        {
+          sums[i].allreduce(gf.getGridView().comm());
+          sum[i] = sums[i].value();
+        }
+    }
+
     //! Evaluate a GridFunction at a certain global coordinate
     /**
      * This class should work correctly even in a parallel setup.  We look for
@@ -139,6 +267,42 @@ sum = gf.getGridView().comm().sum(sum);
                 << "the grid" << std::endl;
       }
 
+      //! Constructor locating the point with a bounding box tree
+      /**
+       * Like the constructor above, but the entity containing \c xg is
+       * looked up in \c tree instead of by a hierarchic search from the
+       * macro grid. The tree can be shared by many probes on the same grid
+       * view.
+       *
+       * \param gf   The GridFunction to probe, either as a reference, a
+       *             pointer, or a shared_ptr.
+       * \param xg   The global coordinate the evaluate at.
+       * \param tree Bounding box tree over the elements of the grid view.
+       */
+      template<class GFHandle>
+      GridFunctionProbe(const GFHandle& gf, const Domain& xg,
+                        const ElementBoundingBoxTree<GV>& tree)
+      {
+        setGridFunction(gf);
+        xl = 0;
+        evalRank = gfp->getGridView().comm().size();
+        int myRank = gfp->getGridView().comm().rank();
+        typename GV::template Codim<0>::Entity entity;
+        typename ElementBoundingBoxTree<GV>::LocalCoordinate local;
+        if(tree.findEntity(xg, entity, local, true)) {
+          e.reset(new EPtr(entity));
+          evalRank = myRank;
+        }
+        evalRank = gfp->getGridView().comm().min(evalRank);
+        if(myRank == evalRank)
+          xl = local;
+        else
+          e.reset();
+        if(myRank == 0 && evalRank == gfp->getGridView().comm().size())
+          dwarn << "Warning: GridFunctionProbe at (" << xg << ") is outside "
+                << "the grid" << std::endl;
+      }
+
       //! Set a new GridFunction
       /**
        * This takes the GridFunction as a refence.  The referenced object must
@@ -219,6 +383,194 @@ sum = gf.getGridView().comm().sum(sum);
       int evalRank;
     };
 
+    //! Evaluate a GridFunction at many global coordinates at once
+    /**
+     * This is the batched counterpart of GridFunctionProbe. All points are
+     * located with a bounding box tree over the elements of the grid view,
+     * and the owner of each point is the lowest rank with an interior
+     * element containing it, determined for all points in a single
+     * collective. Each rank evaluates the points it owns, and all values
+     * are gathered in one collective per evaluation. The location of the
+     * points is kept across evaluations; call relocate() after the grid has
+     * been adapted or load balanced. The bounding box tree can be shared
+     * with other probes on the same grid view.
+     *
+     * \tparam GF Type of the GridFunction to evaluate.
+     */
+    template<typename GF>
+    class GridFunctionProbeSet {
+      typedef typename GF::Traits::GridViewType GV;
+      typedef typename GV::template Codim<0>::Entity Entity;
+      typedef typename Entity::EntitySeed EntitySeed;
+      typedef typename GF::Traits::DomainType Domain;
+      typedef typename GF::Traits::RangeType Range;
+      typedef typename GF::Traits::RangeFieldType RF;
+
+    public:
+      //! The bounding box tree used to locate the points
+      typedef ElementBoundingBoxTree<GV> Tree;
+
+    private:
+      typedef typename Tree::LocalCoordinate LocalCoordinate;
+
+    public:
+      //! Constructor
+      /**
+       * \param gf     The GridFunction to probe, either as a reference, a
+       *               pointer, or a shared_ptr.
+       * \param points The global coordinates to evaluate at.
+       */
+      template<class GFHandle>
+      GridFunctionProbeSet(const GFHandle& gf, const std::vector<Domain>& points)
+        : xg(points)
+        , ownTree(true)
+      {
+        setGridFunction(gf);
+        relocate();
+      }
+
+      //! Constructor using a shared bounding box tree
+      /**
+       * \param gf     The GridFunction to probe, either as a reference, a
+       *               pointer, or a shared_ptr.
+       * \param points The global coordinates to evaluate at.
+       * \param tree_  Bounding box tree over the elements of the grid view.
+       *               relocate() rebuilds it only if it is no longer valid().
+       */
+      template<class GFHandle>
+      GridFunctionProbeSet(const GFHandle& gf, const std::vector<Domain>& points,
+                           const std::shared_ptr<Tree>& tree_)
+        : tree(tree_)
+        , xg(points)
+        , ownTree(false)
+      {
+        setGridFunction(gf);
+        relocate();
+      }
+
+      //! Set a new GridFunction on the same grid view, see GridFunctionProbe
+      void setGridFunction(const GF &gf) {
+        gfsp.reset();
+        gfp = &gf;
+      }
+
+      //! Set a new GridFunction on the same grid view, see GridFunctionProbe
+      void setGridFunction(const GF *gf) {
+        gfsp.reset(gf);
+        gfp = gf;
+      }
+
+      //! Set a new GridFunction on the same grid view, see GridFunctionProbe
+      void setGridFunction(const std::shared_ptr<const GF> &gf) {
+        gfsp = gf;
+        gfp = &*gf;
+      }
+
+      //! Replace the probe points and locate them
+      void setPoints(const std::vector<Domain>& points) {
+        xg = points;
+        relocate();
+      }
+
+      //! The probe points
+      const std::vector<Domain>& points() const {
+        return xg;
+      }
+
+      //! Number of probe points
+      std::size_t size() const {
+        return xg.size();
+      }
+
+      //! Locate all points again, e.g. after the grid has changed
+      void relocate() {
+        const GV& gv = gfp->getGridView();
+        const int size = gv.comm().size();
+        const int myRank = gv.comm().rank();
+        if (!tree)
+          tree.reset(new Tree(gv));
+        else if (ownTree || !tree->valid())
+          tree->update();
+
+        std::vector<int> owner(xg.size(),size);
+        std::vector<Entity> entities(xg.size());
+        std::vector<LocalCoordinate> local(xg.size());
+        for (std::size_t i = 0; i < xg.size(); ++i)
+          if (tree->findEntity(xg[i],entities[i],local[i],true))
+            owner[i] = myRank;
+        if (!owner.empty())
+          gv.comm().min(owner.data(),owner.size());
+
+        localIndex.clear();
+        seeds.clear();
+        xl.clear();
+        outside.clear();
+        for (std::size_t i = 0; i < xg.size(); ++i) {
+          if (owner[i] == myRank) {
+            localIndex.push_back(i);
+            seeds.push_back(entities[i].seed());
+            xl.push_back(local[i]);
+          }
+          else if (owner[i] == size) {
+            outside.push_back(i);
+            if (myRank == 0)
+              dwarn << "Warning: GridFunctionProbeSet point " << i << " at ("
+                    << xg[i] << ") is outside the grid" << std::endl;
+          }
+        }
+      }
+
+      //! evaluate the GridFunction at all points and make the results available on all ranks
+      /**
+       * \param values Store the results here, in the order of the points.
+       *
+       * \note Points outside the grid get the value NaN.
+       */
+      void eval_all(std::vector<Range>& values) const {
+        static const std::size_t m = Range::dimension;
+        const GV& gv = gfp->getGridView();
+        std::vector<RF> buffer(xg.size() * m, RF(0));
+        Range val;
+        for (std::size_t k = 0; k < localIndex.size(); ++k) {
+          const Entity e = gv.grid().entity(seeds[k]);
+          gfp->evaluate(e, xl[k], val);
+          for (std::size_t j = 0; j < m; ++j)
+            buffer[localIndex[k] * m + j] = val[j];
+        }
+        if (!buffer.empty())
+          gv.comm().sum(buffer.data(),buffer.size());
+
+        values.resize(xg.size());
+        for (std::size_t i = 0; i < xg.size(); ++i)
+          for (std::size_t j = 0; j < m; ++j)
+            values[i][j] = buffer[i * m + j];
+        for (std::size_t i : outside)
+          values[i] = std::numeric_limits<RF>::quiet_NaN();
+      }
+
+      //! evaluate the GridFunction at all points and communicate the results to the given rank
+      /**
+       * \note As for GridFunctionProbe::eval(), this is currently identical
+       *       with eval_all(), with the \c rank parameter ignored.
+       */
+      void eval(std::vector<Range>& values, int rank = 0) const {
+        eval_all(values);
+      }
+
+    private:
+      std::shared_ptr<const GF> gfsp;
+      const GF *gfp;
+      std::shared_ptr<Tree> tree;
+      std::vector<Domain> xg;
+      bool ownTree;
+      // points owned by this rank
+      std::vector<std::size_t> localIndex;
+      std::vector<EntitySeed> seeds;
+      std::vector<LocalCoordinate> xl;
+      // points not contained in any interior element
+      std::vector<std::size_t> outside;
+    };
+
     //! \} Function
 
   } // namespace PDELab
@@ -0,0 +1,181 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_COMMON_REPRODUCIBLESUM_HH
+#define DUNE_PDELAB_COMMON_REPRODUCIBLESUM_HH
+
+#include <cmath>
+#include <cstdint>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup PDELab_Function Function
+    //! \ingroup PDELab
+    //! \{
+
+    //! Exact, order independent accumulator for sums of doubles
+    /**
+     * The summands are added to a fixed point number that covers the whole
+     * range of double, so the accumulation is exact and the result does not
+     * depend on the order of the summands. Partial sums of several threads
+     * can be combined with operator+=(const ReproducibleSum&) and partial
+     * sums of several ranks with allreduce(); the final value() is the same
+     * bit by bit for any number of threads and processes.
+     *
+     * Adding a summand costs a few integer operations, which is negligible
+     * compared to evaluating a function at a quadrature point.
+     */
+    class ReproducibleSum
+    {
+
+    public:
+
+      ReproducibleSum()
+      {
+        clear();
+      }
+
+      //! Reset the sum to zero
+      void clear()
+      {
+        for (int i = 0; i < limbCount; ++i)
+          _limbs[i] = 0;
+        _special = 0.0;
+        _pending = 0;
+      }
+
+      //! Add a summand
+      ReproducibleSum& operator+=(double x)
+      {
+        if (!std::isfinite(x))
+          {
+            // infinities and NaNs are propagated by ordinary summation
+            _special += x;
+            return *this;
+          }
+        if (x == 0.0)
+          return *this;
+
+        int exponent;
+        const double fraction = std::frexp(x,&exponent);
+        const bool negative = fraction < 0;
+        std::uint64_t magnitude = std::uint64_t(std::ldexp(std::fabs(fraction),mantissaBits));
+        int position = exponent - mantissaBits + exponentBias;
+        if (position < 0)
+          {
+            // subnormal numbers have trailing zero bits below the smallest position
+            magnitude >>= -position;
+            position = 0;
+          }
+
+        const int limb = position / limbBits;
+        const int shift = position % limbBits;
+        const std::uint64_t mask = (std::uint64_t(1) << limbBits) - 1;
+        std::int64_t chunks[3];
+        chunks[0] = (magnitude << shift) & mask;
+        chunks[1] = shift == 0 ? magnitude >> limbBits : (magnitude >> (limbBits - shift)) & mask;
+        chunks[2] = shift == 0 ? 0 : magnitude >> (2 * limbBits - shift);
+        for (int i = 0; i < 3; ++i)
+          _limbs[limb + i] += negative ? -chunks[i] : chunks[i];
+
+        if (++_pending == normalizeInterval)
+          normalize();
+        return *this;
+      }
+
+      //! Add the summands of another accumulator, e.g. of another thread
+      ReproducibleSum& operator+=(const ReproducibleSum& other)
+      {
+        ReproducibleSum o(other);
+        o.normalize();
+        normalize();
+        for (int i = 0; i < limbCount; ++i)
+          _limbs[i] += o._limbs[i];
+        _special += o._special;
+        _pending = 2;
+        return *this;
+      }
+
+      //! Combine the sums of all ranks of the collective communication comm
+      template<typename CollectiveCommunication>
+      void allreduce(const CollectiveCommunication& comm)
+      {
+        normalize();
+        comm.sum(_limbs,limbCount);
+        _special = comm.sum(_special);
+        // every limb is now bounded by the number of ranks times 2^32
+        _pending = normalizeInterval - 1;
+        normalize();
+      }
+
+      //! The sum, rounded to double
+      double value() const
+      {
+        if (_special != 0.0)
+          return _special;
+
+        ReproducibleSum s(*this);
+        s.normalize();
+        // after normalization, the sign of the sum is the sign of the top limb
+        const bool negative = s._limbs[limbCount - 1] < 0;
+        if (negative)
+          {
+            for (int i = 0; i < limbCount; ++i)
+              s._limbs[i] = -s._limbs[i];
+            s._pending = 1;
+            s.normalize();
+          }
+        double result = 0.0;
+        for (int i = limbCount - 1; i >= 0; --i)
+          if (s._limbs[i] != 0)
+            result += std::ldexp(double(s._limbs[i]),i * limbBits - exponentBias);
+        return negative ? -result : result;
+      }
+
+    private:
+
+      enum {
+        limbBits = 32,
+        mantissaBits = 53,
+        // position of the smallest subnormal number
+        exponentBias = 1074,
+        // positions up to 1024 - 53 + 1074, plus the three chunks and room for carries
+        limbCount = 68,
+        // each summand adds less than 2^32 to a limb, so 2^30 summands fit into 63 bits
+        normalizeInterval = 1 << 30
+      };
+
+      //! Propagate carries, so that all but the top limb are in [0,2^32)
+      void normalize()
+      {
+        if (_pending == 0)
+          return;
+        const std::int64_t base = std::int64_t(1) << limbBits;
+        for (int i = 0; i < limbCount - 1; ++i)
+          {
+            std::int64_t carry = _limbs[i] / base;
+            std::int64_t rest = _limbs[i] - carry * base;
+            if (rest < 0)
+              {
+                rest += base;
+                --carry;
+              }
+            _limbs[i] = rest;
+            _limbs[i + 1] += carry;
+          }
+        _pending = 0;
+      }
+
+      std::int64_t _limbs[limbCount];
+      double _special;
+      std::int64_t _pending;
+
+    };
+
+    //! \} Function
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_COMMON_REPRODUCIBLESUM_HH
@@ -0,0 +1,519 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_GRIDFUNCTIONSPACE_ASYNCVTKWRITER_HH
+#define DUNE_PDELAB_GRIDFUNCTIONSPACE_ASYNCVTKWRITER_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/grid/common/gridenums.hh>
+#include <dune/grid/io/file/vtk/common.hh>
+#include <dune/grid/io/file/vtk/function.hh>
+
+#include <dune/pdelab/gridfunctionspace/vtk.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup PDELab_Function Function
+    //! \ingroup PDELab
+    //! \{
+
+    //! VTK writer that overlaps the file output with the computation
+    /**
+     * AsyncVTKWriter offers the interface of Dune::VTKWriter that is used
+     * by addSolutionToVTKWriter(), so all components of a GridFunctionSpace
+     * tree can be registered with it in the usual way.
+     *
+     * On write(), all registered functions are evaluated in a single pass
+     * over the interior elements. As the functions created by
+     * addSolutionToVTKWriter() share their local function space, each
+     * element is bound only once for the whole tree. The resulting snapshot
+     * of the mesh and the data is handed to a background thread, which
+     * writes it as binary appended VTK data, so the caller can modify the
+     * solution vector and continue with the next time step right away.
+     * A write waits for the output of the previous one to complete; wait()
+     * does so explicitly and rethrows any error that occurred during the
+     * output. Call wait() after the last write(), the destructor can only
+     * report such an error.
+     *
+     * The output is nonconforming, i.e. every element has its own corners,
+     * which makes it suitable for discontinuous solutions. In parallel,
+     * every rank writes its own piece and rank 0 writes the .pvtu file
+     * referencing them. If PDELab has been configured with zlib, the data
+     * arrays can be compressed.
+     *
+     * \tparam GV Type of the GridView.
+     */
+    template<typename GV>
+    class AsyncVTKWriter
+    {
+
+    public:
+
+      typedef GV GridView;
+      typedef Dune::VTKFunction<GV> VTKFunction;
+      typedef std::shared_ptr<const VTKFunction> VTKFunctionPtr;
+
+      //! Construct a writer for the grid view gv
+      /**
+       * \param gv               The GridView.
+       * \param single_precision Write coordinates and data as Float32 instead of Float64.
+       */
+      explicit AsyncVTKWriter(const GV& gv, bool single_precision = true)
+        : _gv(gv)
+        , _single_precision(single_precision)
+        , _compress(false)
+      {}
+
+      //! Wait for the pending output
+      /**
+       * A destructor must not throw, so an error of the pending output is
+       * only reported on std::cerr. Call wait() before destroying the writer
+       * to handle such errors.
+       */
+      ~AsyncVTKWriter()
+      {
+        try
+          {
+            wait();
+          }
+        catch (Dune::Exception& e)
+          {
+            std::cerr << "AsyncVTKWriter: writing the last snapshot failed: " << e << std::endl;
+          }
+        catch (std::exception& e)
+          {
+            std::cerr << "AsyncVTKWriter: writing the last snapshot failed: " << e.what() << std::endl;
+          }
+        catch (...)
+          {
+            std::cerr << "AsyncVTKWriter: writing the last snapshot failed with an unknown error" << std::endl;
+          }
+      }
+
+      AsyncVTKWriter(const AsyncVTKWriter&) = delete;
+      AsyncVTKWriter& operator=(const AsyncVTKWriter&) = delete;
+
+      //! Add a function to be evaluated at the element corners
+      void addVertexData(const VTKFunctionPtr& f)
+      {
+        _vertex_functions.push_back(f);
+      }
+
+      //! Add a function to be evaluated at the element centers
+      void addCellData(const VTKFunctionPtr& f)
+      {
+        _cell_functions.push_back(f);
+      }
+
+      //! Remove all registered functions
+      void clear()
+      {
+        _vertex_functions.clear();
+        _cell_functions.clear();
+      }
+
+      //! Enable zlib compression of the data arrays
+      /**
+       * Has no effect if PDELab has been configured without zlib.
+       */
+      void setCompression(bool compress)
+      {
+        _compress = compress;
+      }
+
+      //! Whether the data arrays are compressed
+      bool compression() const
+      {
+#if HAVE_ZLIB
+        return _compress;
+#else
+        return false;
+#endif
+      }
+
+      //! Evaluate all functions and write them to name.vtu (or name.pvtu) in the background
+      /**
+       * The functions are evaluated before this method returns, the file is
+       * written by a background thread.
+       *
+       * \param name The base name of the file.
+       * \param path Optional directory for the files, which must exist.
+       */
+      void write(const std::string& name, const std::string& path = "")
+      {
+        std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+        snapshot->compress = compression();
+        snapshot->rank = _gv.comm().rank();
+        snapshot->size = _gv.comm().size();
+        snapshot->directory = path.empty() ? std::string() : path + "/";
+        snapshot->name = name;
+        collect(*snapshot);
+
+        wait();
+        _error = nullptr;
+        _worker = std::thread([this,snapshot]() {
+            try
+              {
+                writeFiles(*snapshot);
+              }
+            catch (...)
+              {
+                _error = std::current_exception();
+              }
+          });
+      }
+
+      //! Wait until the output of the last write() has been completed
+      /**
+       * Rethrows an exception that occurred while writing the files.
+       */
+      void wait()
+      {
+        if (_worker.joinable())
+          _worker.join();
+        if (_error)
+          {
+            std::exception_ptr error = _error;
+            _error = nullptr;
+            std::rethrow_exception(error);
+          }
+      }
+
+    private:
+
+      typedef typename GV::ctype ctype;
+      static const int dim = GV::dimension;
+      static const int dimworld = GV::dimensionworld;
+
+      //! A data array, stored in its binary representation
+      struct Array
+      {
+        std::string name;
+        std::string type;
+        int components;
+        std::vector<char> data;
+
+        template<typename T>
+        void append(T value)
+        {
+          const char* p = reinterpret_cast<const char*>(&value);
+          data.insert(data.end(),p,p + sizeof(T));
+        }
+      };
+
+      //! Everything the background thread needs to write the files
+      struct Snapshot
+      {
+        bool compress;
+        int rank;
+        int size;
+        std::string directory;
+        std::string name;
+        std::size_t points;
+        std::size_t cells;
+        std::vector<Array> point_data;
+        std::vector<Array> cell_data;
+        Array coordinates;
+        Array connectivity;
+        Array offsets;
+        Array types;
+      };
+
+      std::string floatType() const
+      {
+        return _single_precision ? "Float32" : "Float64";
+      }
+
+      void appendFloat(Array& array, double value) const
+      {
+        if (_single_precision)
+          array.append(float(value));
+        else
+          array.append(value);
+      }
+
+      void initArray(Array& array, const std::string& name, const std::string& type, int components) const
+      {
+        array.name = name;
+        array.type = type;
+        array.components = components;
+      }
+
+      //! Evaluate all functions in a single pass over the interior elements
+      void collect(Snapshot& snapshot) const
+      {
+        snapshot.points = 0;
+        snapshot.cells = 0;
+
+        std::size_t corner_count = 0;
+        for (const auto& element : elements(_gv,Partitions::interior))
+          {
+            corner_count += element.geometry().corners();
+            ++snapshot.cells;
+          }
+        const std::size_t float_size = _single_precision ? sizeof(float) : sizeof(double);
+
+        initArray(snapshot.coordinates,"Coordinates",floatType(),3);
+        snapshot.coordinates.data.reserve(3 * corner_count * float_size);
+        initArray(snapshot.connectivity,"connectivity","Int64",1);
+        snapshot.connectivity.data.reserve(corner_count * sizeof(std::int64_t));
+        initArray(snapshot.offsets,"offsets","Int64",1);
+        snapshot.offsets.data.reserve(snapshot.cells * sizeof(std::int64_t));
+        initArray(snapshot.types,"types","UInt8",1);
+        snapshot.types.data.reserve(snapshot.cells);
+
+        snapshot.point_data.resize(_vertex_functions.size());
+        for (std::size_t f = 0; f < _vertex_functions.size(); ++f)
+          {
+            Array& array = snapshot.point_data[f];
+            initArray(array,_vertex_functions[f]->name(),floatType(),_vertex_functions[f]->ncomps());
+            array.data.reserve(array.components * corner_count * float_size);
+          }
+        snapshot.cell_data.resize(_cell_functions.size());
+        for (std::size_t f = 0; f < _cell_functions.size(); ++f)
+          {
+            Array& array = snapshot.cell_data[f];
+            initArray(array,_cell_functions[f]->name(),floatType(),_cell_functions[f]->ncomps());
+            array.data.reserve(array.components * snapshot.cells * float_size);
+          }
+
+        for (const auto& element : elements(_gv,Partitions::interior))
+          {
+            const auto geometry = element.geometry();
+            const GeometryType gt = geometry.type();
+            const auto& refelem = ReferenceElements<ctype,dim>::general(gt);
+            const int corners = geometry.corners();
+
+            for (int i = 0; i < corners; ++i)
+              {
+                // VTK and Dune number the corners of cubes differently
+                const int c = VTK::renumber(gt,i);
+                const auto x = geometry.corner(c);
+                for (int d = 0; d < 3; ++d)
+                  appendFloat(snapshot.coordinates,d < dimworld ? double(x[d]) : 0.0);
+                snapshot.connectivity.append(std::int64_t(snapshot.points++));
+
+                const auto xi = refelem.position(c,dim);
+                for (std::size_t f = 0; f < _vertex_functions.size(); ++f)
+                  for (int comp = 0; comp < snapshot.point_data[f].components; ++comp)
+                    appendFloat(snapshot.point_data[f],_vertex_functions[f]->evaluate(comp,element,xi));
+              }
+            snapshot.offsets.append(std::int64_t(snapshot.points));
+            snapshot.types.append(std::uint8_t(VTK::geometryType(gt)));
+
+            const auto center = refelem.position(0,0);
+            for (std::size_t f = 0; f < _cell_functions.size(); ++f)
+              for (int comp = 0; comp < snapshot.cell_data[f].components; ++comp)
+                appendFloat(snapshot.cell_data[f],_cell_functions[f]->evaluate(comp,element,center));
+          }
+      }
+
+      static std::string byteOrder()
+      {
+        const std::uint16_t probe = 1;
+        return *reinterpret_cast<const unsigned char*>(&probe) == 1 ? "LittleEndian" : "BigEndian";
+      }
+
+      static std::string pieceName(const Snapshot& snapshot, int rank)
+      {
+        if (snapshot.size == 1)
+          return snapshot.name + ".vtu";
+        char prefix[16];
+        std::snprintf(prefix,sizeof(prefix),"p%04d-",rank);
+        return prefix + snapshot.name + ".vtu";
+      }
+
+      //! Compress an array in blocks as expected by vtkZLibDataCompressor
+      static std::vector<char> compressArray(const Array& array)
+      {
+        std::vector<char> result;
+#if HAVE_ZLIB
+        const std::uint64_t block_size = 1 << 20;
+        const std::uint64_t size = array.data.size();
+        const std::uint64_t blocks = (size + block_size - 1) / block_size;
+        std::vector<std::uint64_t> header(3 + blocks);
+        header[0] = blocks;
+        header[1] = block_size;
+        header[2] = size % block_size;
+
+        std::vector<char> payload;
+        std::vector<Bytef> buffer(compressBound(block_size));
+        for (std::uint64_t b = 0; b < blocks; ++b)
+          {
+            const std::uint64_t begin = b * block_size;
+            const std::uint64_t length = std::min(block_size,size - begin);
+            uLongf compressed = buffer.size();
+            if (compress2(buffer.data(),&compressed,
+                          reinterpret_cast<const Bytef*>(array.data.data() + begin),length,
+                          Z_DEFAULT_COMPRESSION) != Z_OK)
+              DUNE_THROW(IOError,"zlib failed to compress VTK data array " << array.name);
+            header[3 + b] = compressed;
+            payload.insert(payload.end(),buffer.begin(),buffer.begin() + compressed);
+          }
+
+        const char* h = reinterpret_cast<const char*>(header.data());
+        result.assign(h,h + header.size() * sizeof(std::uint64_t));
+        result.insert(result.end(),payload.begin(),payload.end());
+#endif
+        return result;
+      }
+
+      static void writeDataArray(std::ostream& s, const Array& array, std::uint64_t offset)
+      {
+        s << "<DataArray type=\"" << array.type << "\" Name=\"" << array.name
+          << "\" NumberOfComponents=\"" << array.components
+          << "\" format=\"appended\" offset=\"" << offset << "\"/>\n";
+      }
+
+      static void writePDataArray(std::ostream& s, const Array& array)
+      {
+        s << "<PDataArray type=\"" << array.type << "\" Name=\"" << array.name
+          << "\" NumberOfComponents=\"" << array.components << "\"/>\n";
+      }
+
+      static std::string fileHeader(const Snapshot& snapshot, const std::string& type)
+      {
+        std::string header = "<?xml version=\"1.0\"?>\n<VTKFile type=\"" + type
+          + "\" version=\"1.0\" byte_order=\"" + byteOrder() + "\" header_type=\"UInt64\"";
+        if (snapshot.compress)
+          header += " compressor=\"vtkZLibDataCompressor\"";
+        return header + ">\n";
+      }
+
+      //! Write the piece of this rank and, on rank 0, the parallel header file
+      static void writeFiles(const Snapshot& snapshot)
+      {
+        std::vector<const Array*> arrays;
+        for (const Array& array : snapshot.point_data)
+          arrays.push_back(&array);
+        for (const Array& array : snapshot.cell_data)
+          arrays.push_back(&array);
+        arrays.push_back(&snapshot.coordinates);
+        arrays.push_back(&snapshot.connectivity);
+        arrays.push_back(&snapshot.offsets);
+        arrays.push_back(&snapshot.types);
+
+        std::vector<std::vector<char> > compressed;
+        std::vector<std::uint64_t> offsets;
+        std::uint64_t offset = 0;
+        for (const Array* array : arrays)
+          {
+            offsets.push_back(offset);
+            if (snapshot.compress)
+              {
+                compressed.push_back(compressArray(*array));
+                offset += compressed.back().size();
+              }
+            else
+              offset += sizeof(std::uint64_t) + array->data.size();
+          }
+
+        const std::string filename = snapshot.directory + pieceName(snapshot,snapshot.rank);
+        std::ofstream s(filename.c_str(),std::ios::binary);
+        if (!s)
+          DUNE_THROW(IOError,"could not open VTK output file " << filename);
+
+        s << fileHeader(snapshot,"UnstructuredGrid") << "<UnstructuredGrid>\n"
+          << "<Piece NumberOfPoints=\"" << snapshot.points << "\" NumberOfCells=\"" << snapshot.cells << "\">\n";
+        std::size_t a = 0;
+        s << "<PointData>\n";
+        for (const Array& array : snapshot.point_data)
+          writeDataArray(s,array,offsets[a++]);
+        s << "</PointData>\n<CellData>\n";
+        for (const Array& array : snapshot.cell_data)
+          writeDataArray(s,array,offsets[a++]);
+        s << "</CellData>\n<Points>\n";
+        writeDataArray(s,snapshot.coordinates,offsets[a++]);
+        s << "</Points>\n<Cells>\n";
+        writeDataArray(s,snapshot.connectivity,offsets[a++]);
+        writeDataArray(s,snapshot.offsets,offsets[a++]);
+        writeDataArray(s,snapshot.types,offsets[a++]);
+        s << "</Cells>\n</Piece>\n</UnstructuredGrid>\n<AppendedData encoding=\"raw\">\n_";
+
+        for (std::size_t i = 0; i < arrays.size(); ++i)
+          if (snapshot.compress)
+            s.write(compressed[i].data(),compressed[i].size());
+          else
+            {
+              const std::uint64_t size = arrays[i]->data.size();
+              s.write(reinterpret_cast<const char*>(&size),sizeof(size));
+              s.write(arrays[i]->data.data(),size);
+            }
+        s << "\n</AppendedData>\n</VTKFile>\n";
+        if (!s)
+          DUNE_THROW(IOError,"failed to write VTK output file " << filename);
+
+        if (snapshot.size > 1 && snapshot.rank == 0)
+          {
+            const std::string pfilename = snapshot.directory + snapshot.name + ".pvtu";
+            std::ofstream p(pfilename.c_str());
+            if (!p)
+              DUNE_THROW(IOError,"could not open VTK output file " << pfilename);
+            p << fileHeader(snapshot,"PUnstructuredGrid") << "<PUnstructuredGrid GhostLevel=\"0\">\n";
+            p << "<PPointData>\n";
+            for (const Array& array : snapshot.point_data)
+              writePDataArray(p,array);
+            p << "</PPointData>\n<PCellData>\n";
+            for (const Array& array : snapshot.cell_data)
+              writePDataArray(p,array);
+            p << "</PCellData>\n<PPoints>\n";
+            writePDataArray(p,snapshot.coordinates);
+            p << "</PPoints>\n";
+            for (int rank = 0; rank < snapshot.size; ++rank)
+              p << "<Piece Source=\"" << pieceName(snapshot,rank) << "\"/>\n";
+            p << "</PUnstructuredGrid>\n</VTKFile>\n";
+            if (!p)
+              DUNE_THROW(IOError,"failed to write VTK output file " << pfilename);
+          }
+      }
+
+      GV _gv;
+      bool _single_precision;
+      bool _compress;
+      std::vector<VTKFunctionPtr> _vertex_functions;
+      std::vector<VTKFunctionPtr> _cell_functions;
+      std::thread _worker;
+      std::exception_ptr _error;
+
+    };
+
+    namespace vtk {
+
+      namespace {
+
+        template<typename GV>
+        struct vtk_writer_traits<AsyncVTKWriter<GV> >
+        {
+          typedef GV GridView;
+        };
+
+      }
+
+    } // namespace vtk
+
+    //! \} Function
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDFUNCTIONSPACE_ASYNCVTKWRITER_HH
@@ -0,0 +1,553 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_GRIDFUNCTIONSPACE_CHECKPOINT_HH
+#define DUNE_PDELAB_GRIDFUNCTIONSPACE_CHECKPOINT_HH
+
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup GridFunctionSpace grid function space
+    //! \ingroup PDELab
+    //! \{
+
+    namespace checkpoint {
+
+      //! Type codes of the data stored in a checkpoint record
+      struct DataType {
+        enum type {
+          int32 = 1,
+          uint32 = 2,
+          int64 = 3,
+          uint64 = 4,
+          float32 = 5,
+          float64 = 6,
+          complex64 = 7,
+          complex128 = 8
+        };
+      };
+
+      template<typename T>
+      struct data_type;
+
+#ifndef DOXYGEN
+
+      template<> struct data_type<std::int32_t> { static DataType::type value() { return DataType::int32; } };
+      template<> struct data_type<std::uint32_t> { static DataType::type value() { return DataType::uint32; } };
+      template<> struct data_type<std::int64_t> { static DataType::type value() { return DataType::int64; } };
+      template<> struct data_type<std::uint64_t> { static DataType::type value() { return DataType::uint64; } };
+      template<> struct data_type<float> { static DataType::type value() { return DataType::float32; } };
+      template<> struct data_type<double> { static DataType::type value() { return DataType::float64; } };
+      template<> struct data_type<std::complex<float> > { static DataType::type value() { return DataType::complex64; } };
+      template<> struct data_type<std::complex<double> > { static DataType::type value() { return DataType::complex128; } };
+
+#endif // DOXYGEN
+
+      //! Alignment of the records in the file, chosen to allow mapping them into memory
+      inline std::uint64_t alignment()
+      {
+        return 4096;
+      }
+
+      inline const char* magic()
+      {
+        return "PDLBCKPT";
+      }
+
+      inline std::uint32_t version()
+      {
+        return 1;
+      }
+
+      //! Fixed size header at the beginning of a checkpoint file
+      struct FileHeader
+      {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byte_order;
+        std::uint64_t ranks;
+        std::uint64_t rank;
+        std::uint64_t directory_offset;
+        std::uint64_t record_count;
+        char reserved[16];
+      };
+
+      //! Directory entry of a record, stored at the end of the file
+      struct Record
+      {
+        char name[80];
+        std::uint32_t type;
+        std::uint32_t element_size;
+        std::uint64_t count;
+        std::uint64_t offset;
+        char reserved[24];
+      };
+
+      //! Value used to detect files written on machines with a different byte order
+      inline std::uint32_t byteOrderMark()
+      {
+        return 0x01020304;
+      }
+
+      //! The name of the file written by the given rank
+      inline std::string fileName(const std::string& name, int rank, int ranks)
+      {
+        if (ranks == 1)
+          return name + ".ckpt";
+        char suffix[16];
+        std::snprintf(suffix,sizeof(suffix),"-p%04d",rank);
+        return name + suffix + ".ckpt";
+      }
+
+      //! Description of the DOF layout of a GridFunctionSpace
+      /**
+       * Contains the number of DOFs attached to each element, stored as
+       * offsets in element iteration order, and a hash of the container
+       * indices of all element DOFs. A vector can only be restored if the
+       * layout of the checkpoint matches the layout of the target space.
+       */
+      struct Layout
+      {
+        std::vector<std::uint64_t> element_offsets;
+        std::uint64_t size;
+        std::uint64_t block_count;
+        std::uint64_t hash;
+
+        template<typename GFS>
+        explicit Layout(const GFS& gfs)
+          : element_offsets(1,0)
+          , size(gfs.size())
+          , block_count(gfs.blockCount())
+          , hash(14695981039346656037ULL)
+        {
+          typedef LocalFunctionSpace<GFS> LFS;
+          LFS lfs(gfs);
+          LFSIndexCache<LFS> lfs_cache(lfs);
+
+          element_offsets.reserve(gfs.gridView().size(0) + 1);
+          for (const auto& cell : elements(gfs.gridView()))
+            {
+              lfs.bind(cell);
+              lfs_cache.update();
+              for (std::size_t i = 0; i < lfs_cache.size(); ++i)
+                {
+                  const auto& ci = lfs_cache.containerIndex(i);
+                  for (std::size_t j = 0; j < ci.size(); ++j)
+                    combine(ci[j]);
+                  combine(~std::uint64_t(0));
+                }
+              element_offsets.push_back(element_offsets.back() + lfs_cache.size());
+            }
+          combine(size);
+          combine(block_count);
+        }
+
+        //! The signature stored alongside the vector data
+        std::vector<std::uint64_t> signature() const
+        {
+          std::vector<std::uint64_t> s(4);
+          s[0] = size;
+          s[1] = block_count;
+          s[2] = element_offsets.size() - 1;
+          s[3] = hash;
+          return s;
+        }
+
+      private:
+
+        // FNV-1a
+        void combine(std::uint64_t value)
+        {
+          for (int i = 0; i < 8; ++i)
+            {
+              hash ^= (value >> (8 * i)) & 0xff;
+              hash *= 1099511628211ULL;
+            }
+        }
+
+      };
+
+    } // namespace checkpoint
+
+    //! Writes solution vectors and scalar state into a binary checkpoint
+    /**
+     * Every rank writes its own file name.ckpt (name-pXXXX.ckpt in
+     * parallel), which consists of a header, the raw data of the records,
+     * each aligned to a page boundary so they can be mapped into memory,
+     * and a directory of the records at the end of the file. Vectors are
+     * stored as their flat container data together with the DOF layout
+     * of their GridFunctionSpace, so CheckpointReader can restore them
+     * without interpolation.
+     *
+     * Time stepping state like the current time, the step size or the
+     * old solutions of a multistep method is stored as additional named
+     * records:
+     * \code
+     * CheckpointWriter<GV> checkpoint(gv,"run");
+     * checkpoint.write("solution",gfs,x);
+     * checkpoint.write("time",time);
+     * checkpoint.write("dt",dt);
+     * checkpoint.close();
+     * \endcode
+     *
+     * \tparam GV Type of the GridView, which provides the communication.
+     */
+    template<typename GV>
+    class CheckpointWriter
+    {
+
+    public:
+
+      //! Open the checkpoint file of this rank
+      CheckpointWriter(const GV& gv, const std::string& name)
+        : _gv(gv)
+        , _filename(checkpoint::fileName(name,gv.comm().rank(),gv.comm().size()))
+        , _stream(_filename.c_str(),std::ios::binary | std::ios::trunc)
+        , _offset(sizeof(checkpoint::FileHeader))
+      {
+        if (!_stream)
+          DUNE_THROW(IOError,"could not open checkpoint file " << _filename);
+        const checkpoint::FileHeader header = fileHeader(0);
+        _stream.write(reinterpret_cast<const char*>(&header),sizeof(header));
+      }
+
+      ~CheckpointWriter()
+      {
+        if (_stream.is_open())
+          finish();
+      }
+
+      CheckpointWriter(const CheckpointWriter&) = delete;
+      CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+      //! Store a scalar value
+      template<typename T>
+      void write(const std::string& name, const T& value)
+      {
+        writeRecord(name,&value,1);
+      }
+
+      //! Store an array of values
+      template<typename T>
+      void write(const std::string& name, const std::vector<T>& values)
+      {
+        writeRecord(name,values.data(),values.size());
+      }
+
+      //! Store the coefficient vector x of the GridFunctionSpace gfs
+      /**
+       * Besides the container data, the records name/layout and
+       * name/signature describe the DOF layout of gfs.
+       */
+      template<typename GFS, typename X>
+      void write(const std::string& name, const GFS& gfs, const X& x)
+      {
+        const checkpoint::Layout layout(gfs);
+        write(name + "/layout",layout.element_offsets);
+        write(name + "/signature",layout.signature());
+
+        typedef typename X::ElementType E;
+        beginRecord(name,checkpoint::data_type<E>::value(),sizeof(E),x.flatsize());
+        std::vector<E> buffer;
+        buffer.reserve(chunkSize());
+        for (auto it = x.begin(); it != x.end(); ++it)
+          {
+            buffer.push_back(*it);
+            if (buffer.size() == chunkSize())
+              {
+                writeData(buffer.data(),buffer.size());
+                buffer.clear();
+              }
+          }
+        writeData(buffer.data(),buffer.size());
+        endRecord();
+      }
+
+      //! Write the directory and close the file
+      /**
+       * Collective: throws an IOError on all ranks if any rank failed to
+       * write its file.
+       */
+      void close()
+      {
+        const bool ok = finish();
+        if (_gv.comm().min(int(ok)) == 0)
+          DUNE_THROW(IOError,"failed to write checkpoint file " << _filename << " on at least one rank");
+      }
+
+    private:
+
+      static std::size_t chunkSize()
+      {
+        return 1 << 16;
+      }
+
+      checkpoint::FileHeader fileHeader(std::uint64_t directory_offset) const
+      {
+        checkpoint::FileHeader header;
+        std::memset(&header,0,sizeof(header));
+        std::memcpy(header.magic,checkpoint::magic(),sizeof(header.magic));
+        header.version = checkpoint::version();
+        header.byte_order = checkpoint::byteOrderMark();
+        header.ranks = _gv.comm().size();
+        header.rank = _gv.comm().rank();
+        header.directory_offset = directory_offset;
+        header.record_count = _records.size();
+        return header;
+      }
+
+      template<typename T>
+      void writeRecord(const std::string& name, const T* data, std::size_t count)
+      {
+        beginRecord(name,checkpoint::data_type<T>::value(),sizeof(T),count);
+        writeData(data,count);
+        endRecord();
+      }
+
+      void beginRecord(const std::string& name, checkpoint::DataType::type type,
+                       std::size_t element_size, std::size_t count)
+      {
+        checkpoint::Record record;
+        if (name.size() >= sizeof(record.name))
+          DUNE_THROW(RangeError,"checkpoint record name too long: " << name);
+        for (const checkpoint::Record& r : _records)
+          if (name == r.name)
+            DUNE_THROW(RangeError,"duplicate checkpoint record " << name);
+
+        std::memset(&record,0,sizeof(record));
+        std::strncpy(record.name,name.c_str(),sizeof(record.name) - 1);
+        record.type = type;
+        record.element_size = element_size;
+        record.count = count;
+        record.offset = align(_offset);
+        pad(record.offset);
+        _records.push_back(record);
+      }
+
+      template<typename T>
+      void writeData(const T* data, std::size_t count)
+      {
+        _stream.write(reinterpret_cast<const char*>(data),count * sizeof(T));
+        _offset += count * sizeof(T);
+      }
+
+      void endRecord()
+      {
+        const checkpoint::Record& record = _records.back();
+        if (_offset != record.offset + record.count * record.element_size)
+          DUNE_THROW(InvalidStateException,"size mismatch in checkpoint record " << record.name);
+        if (!_stream)
+          DUNE_THROW(IOError,"failed to write checkpoint record " << record.name << " to " << _filename);
+      }
+
+      static std::uint64_t align(std::uint64_t offset)
+      {
+        return (offset + checkpoint::alignment() - 1) / checkpoint::alignment() * checkpoint::alignment();
+      }
+
+      void pad(std::uint64_t offset)
+      {
+        const std::vector<char> zeros(offset - _offset,0);
+        _stream.write(zeros.data(),zeros.size());
+        _offset = offset;
+      }
+
+      bool finish()
+      {
+        const std::uint64_t directory_offset = align(_offset);
+        pad(directory_offset);
+        _stream.write(reinterpret_cast<const char*>(_records.data()),_records.size() * sizeof(checkpoint::Record));
+        const checkpoint::FileHeader header = fileHeader(directory_offset);
+        _stream.seekp(0);
+        _stream.write(reinterpret_cast<const char*>(&header),sizeof(header));
+        _stream.close();
+        return !_stream.fail();
+      }
+
+      GV _gv;
+      std::string _filename;
+      std::ofstream _stream;
+      std::uint64_t _offset;
+      std::vector<checkpoint::Record> _records;
+
+    };
+
+    //! Restores solution vectors and scalar state from a checkpoint written by CheckpointWriter
+    /**
+     * The checkpoint has to be read with the same number of ranks and on
+     * the same grid it has been written on. Vectors are copied directly
+     * into the container if the DOF layout of the target GridFunctionSpace
+     * matches the stored one.
+     *
+     * \tparam GV Type of the GridView, which provides the communication.
+     */
+    template<typename GV>
+    class CheckpointReader
+    {
+
+    public:
+
+      //! Open the checkpoint file of this rank and read its directory
+      CheckpointReader(const GV& gv, const std::string& name)
+        : _gv(gv)
+        , _filename(checkpoint::fileName(name,gv.comm().rank(),gv.comm().size()))
+        , _stream(_filename.c_str(),std::ios::binary)
+      {
+        checkpoint::FileHeader header;
+        std::memset(&header,0,sizeof(header));
+        _stream.read(reinterpret_cast<char*>(&header),sizeof(header));
+        bool ok = _stream
+          && std::memcmp(header.magic,checkpoint::magic(),sizeof(header.magic)) == 0
+          && header.version == checkpoint::version()
+          && header.byte_order == checkpoint::byteOrderMark()
+          && header.ranks == std::uint64_t(gv.comm().size())
+          && header.rank == std::uint64_t(gv.comm().rank());
+        if (ok)
+          {
+            _records.resize(header.record_count);
+            _stream.seekg(header.directory_offset);
+            _stream.read(reinterpret_cast<char*>(_records.data()),_records.size() * sizeof(checkpoint::Record));
+            ok = bool(_stream);
+          }
+        if (gv.comm().min(int(ok)) == 0)
+          DUNE_THROW(IOError,"could not open checkpoint " << name << ": missing or incompatible file on at least one rank");
+      }
+
+      //! Whether the checkpoint contains a record of the given name
+      bool has(const std::string& name) const
+      {
+        return findRecord(name) != nullptr;
+      }
+
+      //! Restore a scalar value
+      template<typename T>
+      void read(const std::string& name, T& value)
+      {
+        readRecord(name,&value,1);
+      }
+
+      //! Restore an array of values
+      template<typename T>
+      void read(const std::string& name, std::vector<T>& values)
+      {
+        values.resize(record(name).count);
+        readRecord(name,values.data(),values.size());
+      }
+
+      //! Restore the coefficient vector x of the GridFunctionSpace gfs
+      /**
+       * Collective: throws on all ranks if the record is missing or the DOF
+       * layout of gfs differs from the one stored in the checkpoint on any
+       * rank.
+       */
+      template<typename GFS, typename X>
+      void read(const std::string& name, const GFS& gfs, X& x)
+      {
+        typedef typename X::ElementType E;
+        // all local checks must end up in ok, as an exception thrown on a
+        // single rank would leave the others waiting in the reduction
+        const checkpoint::Record* signature_record = findRecord(name + "/signature");
+        const checkpoint::Record* data_record = findRecord(name);
+        bool ok = signature_record && matches<std::uint64_t>(*signature_record)
+          && data_record && matches<E>(*data_record) && data_record->count == x.flatsize();
+        if (ok)
+          {
+            std::vector<std::uint64_t> signature(signature_record->count);
+            _stream.seekg(signature_record->offset);
+            _stream.read(reinterpret_cast<char*>(signature.data()),signature.size() * sizeof(std::uint64_t));
+            const checkpoint::Layout layout(gfs);
+            ok = _stream && signature == layout.signature();
+          }
+        if (_gv.comm().min(int(ok)) == 0)
+          DUNE_THROW(InvalidStateException,"checkpoint record " << name << " is missing or its DOF layout"
+                     << " does not match the GridFunctionSpace on at least one rank");
+
+        const checkpoint::Record& r = *data_record;
+        _stream.seekg(r.offset);
+        std::vector<E> buffer(std::min<std::size_t>(r.count,1 << 16));
+        auto it = x.begin();
+        for (std::size_t done = 0; done < r.count; )
+          {
+            const std::size_t n = std::min<std::size_t>(buffer.size(),r.count - done);
+            _stream.read(reinterpret_cast<char*>(buffer.data()),n * sizeof(E));
+            for (std::size_t i = 0; i < n; ++i, ++it)
+              *it = buffer[i];
+            done += n;
+          }
+        if (!_stream)
+          DUNE_THROW(IOError,"failed to read checkpoint record " << name << " from " << _filename);
+      }
+
+    private:
+
+      const checkpoint::Record* findRecord(const std::string& name) const
+      {
+        for (const checkpoint::Record& r : _records)
+          if (name == r.name)
+            return &r;
+        return nullptr;
+      }
+
+      const checkpoint::Record& record(const std::string& name) const
+      {
+        const checkpoint::Record* r = findRecord(name);
+        if (!r)
+          DUNE_THROW(RangeError,"checkpoint " << _filename << " has no record " << name);
+        return *r;
+      }
+
+      template<typename T>
+      static bool matches(const checkpoint::Record& r)
+      {
+        return r.type == std::uint32_t(checkpoint::data_type<T>::value()) && r.element_size == sizeof(T);
+      }
+
+      template<typename T>
+      const checkpoint::Record& checkedRecord(const std::string& name, std::size_t count) const
+      {
+        const checkpoint::Record& r = record(name);
+        if (!matches<T>(r))
+          DUNE_THROW(RangeError,"checkpoint record " << name << " has a different data type");
+        if (r.count != count)
+          DUNE_THROW(RangeError,"checkpoint record " << name << " has " << r.count
+                     << " entries instead of " << count);
+        return r;
+      }
+
+      template<typename T>
+      void readRecord(const std::string& name, T* data, std::size_t count)
+      {
+        const checkpoint::Record& r = checkedRecord<T>(name,count);
+        _stream.seekg(r.offset);
+        _stream.read(reinterpret_cast<char*>(data),count * sizeof(T));
+        if (!_stream)
+          DUNE_THROW(IOError,"failed to read checkpoint record " << name << " from " << _filename);
+      }
+
+      GV _gv;
+      std::string _filename;
+      std::ifstream _stream;
+      std::vector<checkpoint::Record> _records;
+
+    };
+
+    //! \} group GridFunctionSpace
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDFUNCTIONSPACE_CHECKPOINT_HH
@@ -22,6 +22,16 @@ namespace Dune {
     template<typename GFS, typename GFSTraits>
     class GridFunctionSpaceBase;
 
+    namespace ordering {
+
+      // Hook for ordering tags that derive data from the updated space, like automatically
+      // computed permutations. Overloads for such tags are found by ADL.
+      template<typename GFS, typename OrderingTag>
+      void update_ordering_tag(const GFS& gfs, OrderingTag& tag)
+      {}
+
+    } // namespace ordering
+
     namespace impl {
 
       struct reset_root_space_flag
@@ -216,6 +226,8 @@ namespace Dune {
         if (!gfs()._ordering)
           gfs().create_ordering();
         update(*gfs()._ordering);
+        using ordering::update_ordering_tag;
+        update_ordering_tag(gfs(),_ordering_tag);
       }
 
       const std::string& name() const
@@ -4,14 +4,19 @@
 #define DUNE_PDELAB_GRIDFUNCTIONSPACEUTILITIES_HH
 
 #include <cstdlib>
+#include <limits>
+#include <memory>
 #include<vector>
 
 #include<dune/common/exceptions.hh>
 #include <dune/common/fvector.hh>
 
+#include <dune/geometry/quadraturerules.hh>
+
 #include <dune/localfunctions/common/interfaceswitch.hh>
 
 #include"../common/function.hh"
+#include <dune/pdelab/common/elementmapper.hh>
 #include <dune/pdelab/common/jacobiantocurl.hh>
 #include"gridfunctionspace.hh"
 #include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
@@ -46,6 +51,14 @@ namespace Dune {
      * spaces, and want to collectively treat them as a vector-valued
      * grid-function, look at VectorDiscreteGridFunction.
      *
+     * By default, every call to evaluate() binds the local function space
+     * and reads the local coefficients. With setCaching(true), the last
+     * bound element is remembered and consecutive evaluations on the same
+     * element only evaluate the basis; call invalidateCache() after
+     * modifying the coefficient vector or the grid. The overloads of
+     * evaluate() for a set of points or a quadrature rule bind the element
+     * once for all points.
+     *
      * \tparam T Type of GridFunctionSpace
      * \tparam X Type of coefficients vector
      */
@@ -106,6 +119,8 @@ namespace Dune {
         , x_view(x_)
         , xl(gfs.maxLocalSize())
         , yb(gfs.maxLocalSize())
+        , caching(false)
+        , bound_element(unbound())
       {
       }
 
@@ -122,7 +137,30 @@ namespace Dune {
         , xl(gfs->maxLocalSize())
         , yb(gfs->maxLocalSize())
         , px(x_) // FIXME: The LocalView should handle a shared_ptr correctly!
+        , caching(false)
+        , bound_element(unbound())
+      {
+      }
+
+      //! Remember the last bound element and its coefficients between evaluations
+      /**
+       * The element mapper used to identify the bound element is only set up
+       * the first time caching is enabled.
+       */
+      void setCaching (bool enable)
       {
+        caching = enable;
+        if (caching && !element_mapper)
+          element_mapper = std::make_shared<ElementMapper<typename Traits::GridViewType> >(pgfs->gridView());
+        invalidateCache();
+      }
+
+      //! Forget the cached element, e.g. after the coefficient vector has changed
+      void invalidateCache ()
+      {
+        bound_element = unbound();
+        if (element_mapper)
+          element_mapper->update();
       }
 
       // Evaluate
@@ -130,20 +168,31 @@ namespace Dune {
                             const typename Traits::DomainType& x,
                             typename Traits::RangeType& y) const
       {
-        typedef FiniteElementInterfaceSwitch<
-          typename Dune::PDELab::LocalFunctionSpace<GFS>::Traits::FiniteElementType
-          > FESwitch;
-        lfs.bind(e);
-        lfs_cache.update();
-        x_view.bind(lfs_cache);
-        x_view.read(xl);
-        x_view.unbind();
-        FESwitch::basis(lfs.finiteElement()).evaluateFunction(x,yb);
-        y = 0;
-        for (unsigned int i=0; i<yb.size(); i++)
-        {
-          y.axpy(xl[i],yb[i]);
-        }
+        bind(e);
+        evaluateBound(x,y);
+      }
+
+      //! Evaluate at all points of x, binding e only once
+      inline void evaluate (const typename Traits::ElementType& e,
+                            const std::vector<typename Traits::DomainType>& x,
+                            std::vector<typename Traits::RangeType>& y) const
+      {
+        bind(e);
+        y.resize(x.size());
+        for (std::size_t q = 0; q < x.size(); ++q)
+          evaluateBound(x[q],y[q]);
+      }
+
+      //! Evaluate at all points of a quadrature rule, binding e only once
+      inline void evaluate (const typename Traits::ElementType& e,
+                            const QuadratureRule<typename Traits::DomainFieldType,Traits::dimDomain>& rule,
+                            std::vector<typename Traits::RangeType>& y) const
+      {
+        bind(e);
+        y.resize(rule.size());
+        std::size_t q = 0;
+        for (const auto& qp : rule)
+          evaluateBound(qp.position(),y[q++]);
       }
 
       //! get a reference to the GridView
@@ -157,6 +206,42 @@ namespace Dune {
       typedef LocalFunctionSpace<GFS> LFS;
       typedef LFSIndexCache<LFS> LFSCache;
       typedef typename X::template ConstLocalView<LFSCache> XView;
+      typedef typename ElementMapper<typename Traits::GridViewType>::size_type ElementIndex;
+
+      static ElementIndex unbound ()
+      {
+        return std::numeric_limits<ElementIndex>::max();
+      }
+
+      void bind (const typename Traits::ElementType& e) const
+      {
+        if (caching)
+          {
+            const ElementIndex index = element_mapper->map(e);
+            if (index == bound_element)
+              return;
+            bound_element = index;
+          }
+        lfs.bind(e);
+        lfs_cache.update();
+        x_view.bind(lfs_cache);
+        x_view.read(xl);
+        x_view.unbind();
+      }
+
+      void evaluateBound (const typename Traits::DomainType& x,
+                          typename Traits::RangeType& y) const
+      {
+        typedef FiniteElementInterfaceSwitch<
+          typename Dune::PDELab::LocalFunctionSpace<GFS>::Traits::FiniteElementType
+          > FESwitch;
+        FESwitch::basis(lfs.finiteElement()).evaluateFunction(x,yb);
+        y = 0;
+        for (unsigned int i=0; i<yb.size(); i++)
+        {
+          y.axpy(xl[i],yb[i]);
+        }
+      }
 
       std::shared_ptr<GFS const> pgfs;
       mutable LFS lfs;
@@ -165,6 +250,9 @@ namespace Dune {
       mutable std::vector<typename Traits::RangeFieldType> xl;
       mutable std::vector<typename Traits::RangeType> yb;
       std::shared_ptr<const X> px; // FIXME: dummy pointer to make sure we take ownership of X
+      std::shared_ptr<ElementMapper<typename Traits::GridViewType> > element_mapper;
+      bool caching;
+      mutable ElementIndex bound_element;
     };
 
     /** \brief convert a grid function space and a coefficient vector into a
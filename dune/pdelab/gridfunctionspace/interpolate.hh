@@ -4,6 +4,8 @@
 #ifndef DUNE_PDELAB_INTERPOLATE_HH
 #define DUNE_PDELAB_INTERPOLATE_HH
 
+#include <cstddef>
+#include <utility>
 #include<vector>
 
 #include<dune/common/exceptions.hh>
@@ -173,6 +175,32 @@ namespace Dune {
         XG& xg;
       };
 
+      // Stands in for the local vector view in threadedInterpolate() and
+      // records the written coefficients with their container indices.
+      template<typename LFSCache, typename E>
+      struct InterpolationRecorder
+      {
+
+        typedef E ElementType;
+        typedef std::vector<std::pair<typename LFSCache::ContainerIndex,E> > Entries;
+
+        template<typename ChildLFS, typename LC>
+        void write_sub_container(const ChildLFS& child_lfs, const LC& local_container)
+        {
+          for (std::size_t i = 0; i < child_lfs.size(); ++i)
+            entries.push_back(std::make_pair(lfs_cache.containerIndex(child_lfs.localIndex(i)),local_container[i]));
+        }
+
+        InterpolationRecorder(const LFSCache& lfs_cache_, Entries& entries_)
+          : lfs_cache(lfs_cache_)
+          , entries(entries_)
+        {}
+
+        const LFSCache& lfs_cache;
+        Entries& entries;
+
+      };
+
     } // anonymous namespace
 
     //! interpolation from a given grid function
@@ -224,6 +252,81 @@ namespace Dune {
       x_view.detach();
     }
 
+    //! interpolation from a given grid function using multiple threads
+    /**
+     * \code
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+     * \endcode
+     *
+     * Like interpolate(), but if PDELab is compiled with OpenMP, the
+     * elements are interpolated by multiple threads, each with its own local
+     * function space. The elements are processed in batches: the local
+     * coefficients of a batch are computed in parallel and then written to
+     * \c xg in the element order, so the result is identical to the one of
+     * interpolate(). The function \c f must support concurrent evaluation,
+     * which is not the case for functions with mutable state like
+     * DiscreteGridFunction.
+     *
+     * \param f   Function to interpolate from.
+     * \param gfs GridFunctionSpace to use for interpolation.
+     * \param xg  Global vector of dofs to interpolate into.
+     */
+    template<typename F, typename GFS, typename XG>
+    void threadedInterpolate (const F& f, const GFS& gfs, XG& xg)
+    {
+      typedef typename GFS::Traits::GridViewType GV;
+      typedef typename GV::Traits::template Codim<0>::Entity Element;
+      typedef typename Element::EntitySeed EntitySeed;
+      typedef LocalFunctionSpace<GFS> LFS;
+      typedef LFSIndexCache<LFS> LFSCache;
+      typedef InterpolationRecorder<LFSCache,typename XG::ElementType> Recorder;
+
+      // number of elements interpolated between two writes into xg
+      const std::size_t batch_size = 16384;
+
+      const GV& gv = gfs.gridView();
+      std::vector<EntitySeed> seeds;
+      std::vector<typename Recorder::Entries> entries;
+      seeds.reserve(batch_size);
+
+      const auto range = elements(gv);
+      auto it = range.begin();
+      const auto end = range.end();
+      while (it != end)
+        {
+          seeds.clear();
+          for (; it != end && seeds.size() < batch_size; ++it)
+            seeds.push_back(it->seed());
+          entries.resize(seeds.size());
+
+          const std::ptrdiff_t count = seeds.size();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+          {
+            LFS lfs(gfs);
+            LFSCache lfs_cache(lfs);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (std::ptrdiff_t i = 0; i < count; ++i)
+              {
+                const Element element = gv.grid().entity(seeds[i]);
+                lfs.bind(element);
+                lfs_cache.update();
+                entries[i].clear();
+                Recorder recorder(lfs_cache,entries[i]);
+                TypeTree::applyToTreePair(f,lfs,InterpolateVisitor<InterpolateBackendStandard,Element,Recorder>(InterpolateBackendStandard(),element,recorder));
+              }
+          }
+
+          // later elements overwrite shared DOFs, as in interpolate()
+          for (const auto& element_entries : entries)
+            for (const auto& entry : element_entries)
+              xg[entry.first] = entry.second;
+        }
+    }
+
     //! \} group GridFunctionSpace
   } // namespace PDELab
 } // namespace Dune
@@ -52,6 +52,68 @@ namespace Dune {
       virtual ~TimeSteppingParameterInterface () {}
     };
 
+    //! Parameter class for time stepping schemes with an embedded error estimator
+    /**
+     * The embedded method of lower order shares all stages with the main
+     * method, so its solution is a linear combination of the stage values.
+     * The difference of both solutions, which serves as the estimate of
+     * the local error, is given by
+     * \f[ e = \sum_{i=0}^{s} e_i x_i \f]
+     * with the stage values \f$x_i\f$, where \f$x_0\f$ is the old solution
+     * and \f$x_s\f$ the new one.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class EmbeddedTimeSteppingParameterInterface : public TimeSteppingParameterInterface<R>
+    {
+    public:
+      /*! \brief Return coefficients of the error estimate
+        \note that i ∈ 0,...,s
+      */
+      virtual R e (int i) const = 0;
+
+      /*! \brief Return order of the embedded method
+      */
+      virtual unsigned embeddedOrder () const = 0;
+    };
+
+
+    /**
+       \brief The data the Jacobian of a stage of a one step method depends on
+
+       For a linear problem, two stages with equal fingerprints have identical
+       Jacobians, so the matrix and the preconditioner of the earlier stage
+       can be reused. The stage time is only part of the fingerprint if one
+       of the local operators has a time dependent Jacobian.
+    */
+    template<typename Real>
+    struct OneStepJacobianFingerprint
+    {
+      Real a_rr, b_rr;
+      Real dt_factor0, dt_factor1;
+      Real time;
+      bool valid;
+
+      OneStepJacobianFingerprint()
+        : a_rr(0.0), b_rr(0.0), dt_factor0(0.0), dt_factor1(0.0), time(0.0), valid(false)
+      {}
+
+      //! invalid fingerprints never compare equal
+      bool operator==(const OneStepJacobianFingerprint& other) const
+      {
+        return valid && other.valid
+          && a_rr == other.a_rr && b_rr == other.b_rr
+          && dt_factor0 == other.dt_factor0 && dt_factor1 == other.dt_factor1
+          && time == other.time;
+      }
+
+      bool operator!=(const OneStepJacobianFingerprint& other) const
+      {
+        return !(*this == other);
+      }
+    };
+
 
     //! Parameters specifying implicit euler
     /**
@@ -1,12 +1,18 @@
 #ifndef DUNE_PDELAB_DEFAULT_ASSEMBLER_HH
 #define DUNE_PDELAB_DEFAULT_ASSEMBLER_HH
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
 #include <dune/common/typetraits.hh>
 #include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
 #include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
 #include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
 #include <dune/pdelab/common/elementmapper.hh>
 #include <dune/pdelab/common/geometrywrapper.hh>
+#include <dune/pdelab/ordering/permutationalgorithms.hh>
 
 namespace Dune{
   namespace PDELab{
@@ -44,6 +50,18 @@ namespace Dune{
       //! Static check on whether this is a Galerkin method
       static const bool isGalerkinMethod = Dune::is_same<GFSU,GFSV>::value;
 
+      //! Orders in which the elements are visited during assembly
+      struct Traversal
+      {
+
+        enum type {
+          native, //!< The iteration order of the grid view.
+          hilbertCurve, //!< Along a Hilbert curve through the element centers.
+          elementSubset //!< Only a given subset of the elements, see setElementSubset().
+        };
+
+      };
+
       DefaultAssembler (const GFSU& gfsu_, const GFSV& gfsv_, const CU& cu_, const CV& cv_)
         : gfsu(gfsu_)
         , gfsv(gfsv_)
@@ -53,6 +71,8 @@ namespace Dune{
         , lfsv(gfsv_)
         , lfsun(gfsu_)
         , lfsvn(gfsv_)
+        , traversal(Traversal::native)
+        , subset_size(0)
       { }
 
       DefaultAssembler (const GFSU& gfsu_, const GFSV& gfsv_)
@@ -64,6 +84,8 @@ namespace Dune{
         , lfsv(gfsv_)
         , lfsun(gfsu_)
         , lfsvn(gfsv_)
+        , traversal(Traversal::native)
+        , subset_size(0)
       { }
 
       //! Get the trial grid function space
@@ -78,6 +100,108 @@ namespace Dune{
         return gfsv;
       }
 
+      //! Select the order in which the elements are visited
+      /**
+       * With Traversal::hilbertCurve, the elements are visited along a Hilbert curve through their
+       * centers, which keeps consecutive elements close in memory for both the geometry data and
+       * the scattered vector and matrix entries. The order is stored as a list of element seeds.
+       */
+      void setTraversal(typename Traversal::type traversal_)
+      {
+        traversal = traversal_;
+        element_seeds.clear();
+        subset_position.clear();
+        subset_size = 0;
+      }
+
+      //! Only visit the given elements, in the given order
+      /**
+       * This is meant for schemes that only update a part of the grid in each assembly, like local
+       * time stepping. An intersection between a visited and an unvisited element is assembled from
+       * the visited side, so every intersection of a visited element is assembled exactly once.
+       * Local operators with doSkeletonTwoSided only get the contribution of the visited side.
+       *
+       * The seeds are copied and stay in effect until setTraversal() is called. Initially, all
+       * given elements are visited; setElementSubsetSize() restricts the assembly to a prefix of the
+       * list, so sorting the seeds by some criterion allows to select nested subsets cheaply.
+       */
+      void setElementSubset(const std::vector<typename Element::EntitySeed>& seeds)
+      {
+        traversal = Traversal::elementSubset;
+        element_seeds = seeds;
+        subset_size = seeds.size();
+
+        // position of every element in the list, used to find unvisited neighbors
+        const GV& gv = gfsu.gridView();
+        ElementMapper<GV> cell_mapper(gv);
+        subset_position.assign(gv.size(0),std::numeric_limits<std::size_t>::max());
+        for (std::size_t i = 0; i < element_seeds.size(); ++i)
+          subset_position[cell_mapper.map(gv.grid().entity(element_seeds[i]))] = i;
+      }
+
+      //! Only visit the first n elements of the list passed to setElementSubset()
+      void setElementSubsetSize(std::size_t n)
+      {
+        subset_size = std::min(n,element_seeds.size());
+      }
+
+      //! Restricts the assembly to an element subset and restores the previous traversal on destruction
+      /**
+       * Schemes that assemble only parts of the grid use this to leave the assembler as they found
+       * it, also if an exception is thrown.
+       */
+      class ElementSubsetGuard
+      {
+      public:
+        ElementSubsetGuard(DefaultAssembler& assembler_, const std::vector<typename Element::EntitySeed>& seeds)
+          : assembler(assembler_)
+          , traversal(assembler_.traversal)
+          , subset_size(assembler_.subset_size)
+        {
+          element_seeds.swap(assembler.element_seeds);
+          subset_position.swap(assembler.subset_position);
+          assembler.setElementSubset(seeds);
+        }
+
+        ~ElementSubsetGuard()
+        {
+          assembler.traversal = traversal;
+          assembler.element_seeds.swap(element_seeds);
+          assembler.subset_position.swap(subset_position);
+          assembler.subset_size = subset_size;
+        }
+
+      private:
+        ElementSubsetGuard(const ElementSubsetGuard&);
+        ElementSubsetGuard& operator=(const ElementSubsetGuard&);
+
+        DefaultAssembler& assembler;
+        typename Traversal::type traversal;
+        std::vector<typename Element::EntitySeed> element_seeds;
+        std::vector<std::size_t> subset_position;
+        std::size_t subset_size;
+      };
+
+      //! The order in which the elements are visited
+      typename Traversal::type getTraversal() const
+      {
+        return traversal;
+      }
+
+      //! Recompute the element order; must be called after the grid has changed
+      /**
+       * A change of the number of elements is detected automatically during assembly, so this is
+       * only required if the grid changes without changing the number of elements. An element
+       * subset is discarded, i.e. the assembler returns to the native traversal.
+       */
+      void update()
+      {
+        if (traversal == Traversal::hilbertCurve)
+          updateTraversal();
+        else
+          setTraversal(Traversal::native);
+      }
+
       // Assembler (const GFSU& gfsu_, const GFSV& gfsv_)
       //   : gfsu(gfsu_), gfsv(gfsv_), lfsu(gfsu_), lfsv(gfsv_),
       //     lfsun(gfsu_), lfsvn(gfsv_),
@@ -117,20 +241,19 @@ namespace Dune{
         const bool require_v_post_skeleton = assembler_engine.requireVVolumePostSkeleton();
         const bool require_skeleton_two_sided = assembler_engine.requireSkeletonTwoSided();
 
-        // Traverse grid view
-        for (ElementIterator it = gfsu.gridView().template begin<0>();
-             it!=gfsu.gridView().template end<0>(); ++it)
+        // Assemble the contributions of a single element
+        auto assemble_element = [&](const Element& element)
           {
             // Compute unique id
-            const typename GV::IndexSet::IndexType ids = cell_mapper.map(*it);
+            const typename GV::IndexSet::IndexType ids = cell_mapper.map(element);
 
-            ElementGeometry<Element> eg(*it);
+            ElementGeometry<Element> eg(element);
 
             if(assembler_engine.assembleCell(eg))
-              continue;
+              return;
 
             // Bind local test function space to element
-            lfsv.bind( *it );
+            lfsv.bind( element );
             lfsv_cache.update();
 
             // Notify assembler engine about bind
@@ -140,7 +263,7 @@ namespace Dune{
             assembler_engine.assembleVVolume(eg,lfsv_cache);
 
             // Bind local trial function space to element
-            lfsu.bind( *it );
+            lfsu.bind( element );
             lfsu_cache.update();
 
             // Notify assembler engine about bind
@@ -159,8 +282,8 @@ namespace Dune{
               {
                 // Traverse intersections
                 unsigned int intersection_index = 0;
-                IntersectionIterator endit = gfsu.gridView().iend(*it);
-                IntersectionIterator iit = gfsu.gridView().ibegin(*it);
+                IntersectionIterator endit = gfsu.gridView().iend(element);
+                IntersectionIterator iit = gfsu.gridView().ibegin(element);
                 for(; iit!=endit; ++iit, ++intersection_index)
                   {
 
@@ -178,8 +301,9 @@ namespace Dune{
 
                             const typename GV::IndexSet::IndexType idn = cell_mapper.map(iit->outside());
 
-                            // Visit face if id is bigger
-                            bool visit_face = ids > idn || require_skeleton_two_sided;
+                            // Visit face if id is bigger, or if the neighbor is not visited at all
+                            bool visit_face = ids > idn || require_skeleton_two_sided
+                              || (traversal == Traversal::elementSubset && subset_position[idn] >= subset_size);
 
                             // unique vist of intersection
                             if (visit_face)
@@ -271,7 +395,29 @@ namespace Dune{
             // Notify assembler engine about unbinds
             assembler_engine.onUnbindLFSV(eg,lfsv_cache);
 
-          } // it
+          };
+
+        // Traverse grid view
+        if (traversal == Traversal::hilbertCurve)
+          {
+            // refresh the element order if the grid has obviously changed
+            if (element_seeds.size() != static_cast<std::size_t>(gfsu.gridView().size(0)))
+              updateTraversal();
+            for (const auto& seed : element_seeds)
+              assemble_element(gfsu.gridView().grid().entity(seed));
+          }
+        else if (traversal == Traversal::elementSubset)
+          {
+            // the positions are indexed by the element mapper, which changes with the grid
+            if (subset_position.size() != static_cast<std::size_t>(gfsu.gridView().size(0)))
+              DUNE_THROW(InvalidStateException,
+                         "DefaultAssembler: the grid has changed since setElementSubset() was called");
+            for (std::size_t i = 0; i < subset_size; ++i)
+              assemble_element(gfsu.gridView().grid().entity(element_seeds[i]));
+          }
+        else
+          for (const auto& element : elements(gfsu.gridView()))
+            assemble_element(element);
 
         // Notify assembler engine that assembly is finished
         assembler_engine.postAssembly(gfsu,gfsv);
@@ -280,6 +426,33 @@ namespace Dune{
 
     private:
 
+      //! Sort the element seeds along a Hilbert curve through the element centers
+      void updateTraversal() const
+      {
+        typedef typename Element::Geometry::GlobalCoordinate Point;
+
+        const GV& gv = gfsu.gridView();
+        std::vector<ElementSeed> seeds;
+        std::vector<Point> centers;
+        seeds.reserve(gv.size(0));
+        centers.reserve(gv.size(0));
+        for (const auto& element : elements(gv))
+          {
+            seeds.push_back(element.seed());
+            centers.push_back(element.geometry().center());
+          }
+
+        std::vector<std::size_t> order;
+        ordering::space_filling_curve(centers,true,order);
+
+        element_seeds.clear();
+        element_seeds.reserve(seeds.size());
+        for (std::size_t k : order)
+          element_seeds.push_back(seeds[k]);
+      }
+
+      typedef typename Element::EntitySeed ElementSeed;
+
       /* global function spaces */
       const GFSU& gfsu;
       const GFSV& gfsv;
@@ -305,6 +478,12 @@ namespace Dune{
       mutable LFSU lfsun;
       mutable LFSV lfsvn;
 
+      /* element traversal */
+      typename Traversal::type traversal;
+      mutable std::vector<ElementSeed> element_seeds;
+      std::vector<std::size_t> subset_position;
+      std::size_t subset_size;
+
     };
 
   }
@@ -190,6 +190,8 @@ namespace Dune{
       {
         // the DOF exchanger has matrix information, so we need to update it
         dof_exchanger->update(*this);
+        // the element traversal order depends on the grid
+        global_assembler.update();
       }
 
       //! Get the matrix backend for this grid operator.
@@ -2,6 +2,11 @@
 #ifndef DUNE_PDELAB_ONESTEP_OPERATOR_HH
 #define DUNE_PDELAB_ONESTEP_OPERATOR_HH
 
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <dune/pdelab/backend/istl/utility.hh>
 #include <dune/pdelab/instationary/onestep.hh>
 #include <dune/pdelab/gridoperator/onestep/localassembler.hh>
 #include <dune/pdelab/gridoperator/common/gridoperatorutilities.hh>
@@ -70,7 +75,9 @@ namespace Dune{
           go0(go0_), go1(go1_),
           la0(go0_.localAssembler()), la1(go1_.localAssembler()),
           const_residual( go0_.testGridFunctionSpace() ),
-          local_assembler(la0,la1, const_residual)
+          local_assembler(la0,la1, const_residual),
+          linear_mode(false),
+          time_dependent_source0(true), time_dependent_source1(true)
       {
         GO0::setupGridOperators(Dune::tie(go0_,go1_));
         if(!implicit)
@@ -93,6 +100,80 @@ namespace Dune{
         local_assembler.setDTAssemblingMode(LocalAssembler::MultiplyOperator0ByDT);
       }
 
+      //! Declare whether the Jacobians of the spatial (go0) and the
+      //! temporal (go1) local operator depend on time. By default both
+      //! are assumed to be time dependent.
+      void setTimeDependentJacobian(bool spatial, bool temporal)
+      {
+        local_assembler.setTimeDependentJacobian(spatial,temporal);
+      }
+
+      //! The fingerprint of the Jacobian of the given stage of the current step
+      /**
+       * For linear problems, stages with equal fingerprints share the same
+       * Jacobian, see OneStepMethod::setStageMatrixReuse().
+       */
+      OneStepJacobianFingerprint<Real> jacobianFingerprint(unsigned int stage) const
+      {
+        return local_assembler.jacobianFingerprint(stage);
+      }
+
+      //! Switch the assembling of linear problems from stored matrices on or off
+      /**
+       * For linear problems whose spatial (go0) and temporal (go1) local
+       * operators have time-independent Jacobians, the Jacobians of both
+       * grid operators are assembled once and kept. preStage(), residual()
+       * and jacobian() then form the constant part of the residual, the
+       * stage residual and the stage matrix by sparse matrix-vector
+       * products and matrix axpy operations on these matrices, the same
+       * idea StationaryMatrixLinearSolver applies to stationary problems.
+       *
+       * The local operators are only evaluated for the part of the residual
+       * that does not depend on the solution, i.e. sources and boundary
+       * terms. It is assembled once per stage time, or only once if it is
+       * declared to be time-independent by setTimeDependentSource().
+       *
+       * When the matrices are assembled, they are checked against the
+       * residual of the grid operators. An exception is thrown for
+       * operators which are not affine and for Jacobians without the
+       * columns of Dirichlet constrained DOFs, as produced by the symmetric
+       * elimination of Dirichlet constraints, since A x then misses the
+       * contribution of the Dirichlet values.
+       *
+       * \note This mode relies on the ISTL matrix backend and is only
+       *       available in implicit mode. The stored matrices are discarded
+       *       by update() and invalidateLinearOperators().
+       */
+      void setLinearInstationaryMode(bool enable)
+      {
+        if(!implicit)
+          DUNE_THROW(Dune::Exception,"The linear instationary mode is only available in implicit mode");
+        linear_mode = enable;
+        if(!linear_mode)
+          invalidateLinearOperators();
+      }
+
+      //! Declare whether the solution independent parts of the residuals
+      //! of the spatial (go0) and the temporal (go1) local operator depend
+      //! on time. By default both are assumed to be time dependent.
+      void setTimeDependentSource(bool spatial, bool temporal)
+      {
+        time_dependent_source0 = spatial;
+        time_dependent_source1 = temporal;
+        source0.clear(); source_time0.clear();
+        source1.clear(); source_time1.clear();
+      }
+
+      //! Discard the stored matrices and source terms of the linear
+      //! instationary mode, they will be reassembled on the next use.
+      void invalidateLinearOperators()
+      {
+        spatial_matrix.reset();
+        temporal_matrix.reset();
+        source0.clear(); source_time0.clear();
+        source1.clear(); source_time1.clear();
+      }
+
       //! Get the trial grid function space
       const typename Traits::TrialGridFunctionSpace& trialGridFunctionSpace() const
       {
@@ -138,6 +219,11 @@ namespace Dune{
       void preStage(unsigned int stage, const std::vector<Domain*> & x){
         if(!implicit){DUNE_THROW(Dune::Exception,"This function should not be called in explicit mode");}
 
+        if(linear_mode){
+          linearPreStage(stage,x);
+          return;
+        }
+
         typedef typename LocalAssembler::LocalPreStageAssemblerEngine PreStageEngine;
         local_assembler.setStage(stage);
         PreStageEngine & prestage_engine = local_assembler.localPreStageAssemblerEngine(x);
@@ -149,6 +235,11 @@ namespace Dune{
       void residual(const Domain & x, Range & r) const {
         if(!implicit){DUNE_THROW(Dune::Exception,"This function should not be called in explicit mode");}
 
+        if(linear_mode){
+          linearResidual(x,r);
+          return;
+        }
+
         typedef typename LocalAssembler::LocalResidualAssemblerEngine ResidualEngine;
         ResidualEngine & residual_engine = local_assembler.localResidualAssemblerEngine(r,x);
         global_assembler.assemble(residual_engine);
@@ -159,6 +250,11 @@ namespace Dune{
       void jacobian(const Domain & x, Jacobian & a) const {
         if(!implicit){DUNE_THROW(Dune::Exception,"This function should not be called in explicit mode");}
 
+        if(linear_mode){
+          linearJacobian(a);
+          return;
+        }
+
         typedef typename LocalAssembler::LocalJacobianAssemblerEngine JacobianEngine;
         JacobianEngine & jacobian_engine = local_assembler.localJacobianAssemblerEngine(a,x);
         global_assembler.assemble(jacobian_engine);
@@ -182,6 +278,51 @@ namespace Dune{
         global_assembler.assemble(jacobian_residual_engine);
       }
 
+      //! Assemble only the residuals for explicit treatment
+      /**
+       * Same as explicit_jacobian_residual(), but skips the assembly of the
+       * temporal Jacobian. This is meant for explicit schemes which keep
+       * the (inverted) mass matrix across stages and time steps.
+       */
+      void explicit_residual(unsigned int stage, const std::vector<Domain*> & x,
+                             Range & r1, Range & r0)
+      {
+        if(implicit){DUNE_THROW(Dune::Exception,"This function should not be called in implicit mode");}
+
+        local_assembler.setStage(stage);
+
+        typedef typename LocalAssembler::LocalPreStageAssemblerEngine PreStageEngine;
+        PreStageEngine & prestage_engine = local_assembler.localExplicitResidualAssemblerEngine(r0,r1,x);
+        global_assembler.assemble(prestage_engine);
+      }
+
+      //! Add the residuals for explicit treatment to r1 and r0
+      /**
+       * Same as explicit_residual(), but the residual vectors are not
+       * cleared, so the cost only depends on the elements visited by the
+       * assembler. This is meant for schemes which restrict the assembly to
+       * a subset of the elements, see DefaultAssembler::setElementSubset().
+       */
+      void accumulate_explicit_residual(unsigned int stage, const std::vector<Domain*> & x,
+                                        Range & r1, Range & r0)
+      {
+        if(implicit){DUNE_THROW(Dune::Exception,"This function should not be called in implicit mode");}
+
+        local_assembler.setStage(stage);
+
+        typedef typename LocalAssembler::LocalPreStageAssemblerEngine PreStageEngine;
+        PreStageEngine & prestage_engine = local_assembler.localExplicitResidualAssemblerEngine(r0,r1,x);
+        prestage_engine.setClearResiduals(false);
+        try {
+          global_assembler.assemble(prestage_engine);
+        }
+        catch (...) {
+          prestage_engine.setClearResiduals(true);
+          throw;
+        }
+        prestage_engine.setClearResiduals(true);
+      }
+
       //! Interpolate constrained values from given function f
       template<typename F, typename X>
       void interpolate (unsigned stage, const X& xold, F& f, X& x) const
@@ -211,6 +352,17 @@ namespace Dune{
         local_assembler.preStep(time_,dt_,method_.s());
       }
 
+      //! change the start time and the size of the current step
+      /**
+       * Unlike preStep(), this does not call preStep() of the local
+       * operators. This is meant for schemes which divide a step into
+       * stages or substeps of their own.
+       */
+      void setTimeStep (Real time_, Real dt_)
+      {
+        local_assembler.setTimeStep(time_,dt_);
+      }
+
       //! to be called after step is completed
       void postStep ()
       {
@@ -239,6 +391,7 @@ namespace Dune{
         go0.update();
         go1.update();
         const_residual = Range(go0.testGridFunctionSpace());
+        invalidateLinearOperators();
       }
 
       const typename Traits::MatrixBackend& matrixBackend() const
@@ -247,6 +400,179 @@ namespace Dune{
       }
 
     private:
+
+      //! Assemble the Jacobians of both grid operators if they are not available
+      void assembleLinearOperators() const
+      {
+        if(spatial_matrix && spatial_matrix->N() == const_residual.N())
+          return;
+
+        // both matrices share the pattern of the one step operator,
+        // so they can be combined by matrix axpy operations
+        const Domain zero(trialGridFunctionSpace(),0.0);
+        const Real time = local_assembler.timeAtStage(0);
+
+        spatial_matrix = std::make_shared<Jacobian>(*this,0.0);
+        la0.setTime(time);
+        la0.setWeight(1.0);
+        go0.jacobian(zero,*spatial_matrix);
+
+        temporal_matrix = std::make_shared<Jacobian>(*this,0.0);
+        la1.setTime(time);
+        la1.setWeight(1.0);
+        go1.jacobian(zero,*temporal_matrix);
+
+        source0.clear(); source_time0.clear();
+        source1.clear(); source_time1.clear();
+
+        try {
+          checkLinearOperator(go0,*spatial_matrix,"spatial");
+          checkLinearOperator(go1,*temporal_matrix,"temporal");
+        }
+        catch (...) {
+          spatial_matrix.reset();
+          temporal_matrix.reset();
+          throw;
+        }
+      }
+
+      //! Make sure that A x + source reproduces the residual of a grid operator
+      /**
+       * The stored matrix only yields the residual if the operator is
+       * affine and if the matrix still contains the columns of the
+       * constrained DOFs. The latter does not hold if the Dirichlet columns
+       * are eliminated to keep the matrix symmetric, see
+       * LocalAssemblerBase::etadd_symmetric(). The residual is compared for
+       * the vector of all ones and for a vector with varying entries, both
+       * with non-zero Dirichlet values, as a nonlinear operator may well be
+       * reproduced along a single direction.
+       */
+      template<typename GO>
+      void checkLinearOperator(GO & go, const Jacobian & A, const char* name) const
+      {
+        const Domain zero(go.trialGridFunctionSpace(),0.0);
+        Range source(go.testGridFunctionSpace(),0.0);
+        go.residual(zero,source);
+
+        Domain probe(go.trialGridFunctionSpace(),1.0);
+        for(int p = 0; p < 2; ++p){
+          if(p == 1){
+            std::size_t i = 0;
+            for(auto & v : probe)
+              v = 1.0 + 0.25*(i++ % 7);
+          }
+          Range r(go.testGridFunctionSpace(),0.0);
+          go.residual(probe,r);
+          r -= source;
+          Dune::PDELab::set_constrained_dofs(local_assembler.testConstraints(),0.0,r);
+          const Real scale = r.two_norm();
+          istl::raw(A).usmv(-1.0,istl::raw(probe),istl::raw(r));
+          Dune::PDELab::set_constrained_dofs(local_assembler.testConstraints(),0.0,r);
+          if(r.two_norm() > 1e-8*scale)
+            DUNE_THROW(Dune::Exception,"The linear instationary mode requires an affine " << name
+                       << " operator whose Jacobian keeps the columns of constrained DOFs, the stored"
+                       << " matrix does not reproduce the residual (deviation " << r.two_norm()
+                       << " of " << scale << ")");
+        }
+      }
+
+      //! Solution independent part of the residual of a grid operator at the given stage
+      template<typename GO, typename LA>
+      const Range & sourceTerm(GO & go, LA & la, std::vector<std::shared_ptr<Range> > & sources,
+                               std::vector<Real> & times, bool time_dependent, int stage) const
+      {
+        const Real time = local_assembler.timeAtStage(stage);
+        const std::size_t slot = time_dependent ? stage : 0;
+        if(sources.size() <= slot){
+          sources.resize(slot+1);
+          times.resize(slot+1);
+        }
+        if(!sources[slot] || (time_dependent && times[slot] != time)){
+          if(!sources[slot])
+            sources[slot] = std::make_shared<Range>(go.testGridFunctionSpace());
+          *sources[slot] = 0.0;
+          const Domain zero(go.trialGridFunctionSpace(),0.0);
+          la.setTime(time);
+          la.setWeight(1.0);
+          go.residual(zero,*sources[slot]);
+          times[slot] = time;
+        }
+        return *sources[slot];
+      }
+
+      //! Add w * (A x + source) to r for one of the two grid operators
+      template<typename GO, typename LA>
+      void addLinearResidual(GO & go, LA & la, const Jacobian & A,
+                             std::vector<std::shared_ptr<Range> > & sources, std::vector<Real> & times,
+                             bool time_dependent, int stage, Real w, const Domain & x, Range & r) const
+      {
+        istl::raw(A).usmv(w,istl::raw(x),istl::raw(r));
+        r.axpy(w,sourceTerm(go,la,sources,times,time_dependent,stage));
+      }
+
+      //! Linear instationary counterpart of preStage()
+      void linearPreStage(unsigned int stage, const std::vector<Domain*> & x)
+      {
+        local_assembler.setStage(stage);
+        assembleLinearOperators();
+
+        const OneStepParameters & method = local_assembler.method();
+        const Real time = local_assembler.timeAtStage(stage);
+        la0.preStage(time,stage);
+        la1.preStage(time,stage);
+
+        const Real dt_factor0 = local_assembler.timeStepFactor0();
+        const Real dt_factor1 = local_assembler.timeStepFactor1();
+
+        const_residual = 0.0;
+        for(unsigned int i=0; i<stage; ++i){
+          const Real b = method.b(stage,i);
+          const Real a = method.a(stage,i);
+          if(std::abs(b) > 1E-6)
+            addLinearResidual(go0,la0,*spatial_matrix,source0,source_time0,time_dependent_source0,
+                              i,b*dt_factor0,*x[i],const_residual);
+          if(std::abs(a) > 1E-6)
+            addLinearResidual(go1,la1,*temporal_matrix,source1,source_time1,time_dependent_source1,
+                              i,a*dt_factor1,*x[i],const_residual);
+        }
+
+        // the unit rows of constrained DOFs must not contribute
+        Dune::PDELab::set_constrained_dofs(local_assembler.testConstraints(),0.0,const_residual);
+      }
+
+      //! Linear instationary counterpart of residual()
+      void linearResidual(const Domain & x, Range & r) const
+      {
+        assembleLinearOperators();
+
+        const int stage = local_assembler.currentStage();
+        const Real b_rr = local_assembler.method().b(stage,stage);
+
+        r += const_residual;
+        if(std::abs(b_rr) > 1e-6)
+          addLinearResidual(go0,la0,*spatial_matrix,source0,source_time0,time_dependent_source0,
+                            stage,b_rr*local_assembler.timeStepFactor0(),x,r);
+        addLinearResidual(go1,la1,*temporal_matrix,source1,source_time1,time_dependent_source1,
+                          stage,local_assembler.timeStepFactor1(),x,r);
+
+        Dune::PDELab::set_constrained_dofs(local_assembler.testConstraints(),0.0,r);
+      }
+
+      //! Linear instationary counterpart of jacobian()
+      void linearJacobian(Jacobian & a) const
+      {
+        assembleLinearOperators();
+
+        const int stage = local_assembler.currentStage();
+        const Real b_rr = local_assembler.method().b(stage,stage);
+
+        if(std::abs(b_rr) > 1e-6)
+          istl::raw(a).axpy(b_rr*local_assembler.timeStepFactor0(),istl::raw(*spatial_matrix));
+        istl::raw(a).axpy(local_assembler.timeStepFactor1(),istl::raw(*temporal_matrix));
+
+        local_assembler.setTrivialConstrainedRows(testGridFunctionSpace(),a);
+      }
+
       Assembler & global_assembler;
       GO0 & go0;
       GO1 & go1;
@@ -254,6 +580,16 @@ namespace Dune{
       LocalAssemblerDT1 & la1;
       Range const_residual;
       mutable LocalAssembler local_assembler;
+
+      //! State of the linear instationary mode
+      //! @{
+      bool linear_mode;
+      bool time_dependent_source0, time_dependent_source1;
+      mutable std::shared_ptr<Jacobian> spatial_matrix;
+      mutable std::shared_ptr<Jacobian> temporal_matrix;
+      mutable std::vector<std::shared_ptr<Range> > source0, source1;
+      mutable std::vector<Real> source_time0, source_time1;
+      //! @}
     };
 
   }
@@ -94,6 +94,7 @@ namespace Dune{
           la0(la0_), la1(la1_),
           const_residual(const_residual_),
           time(0.0), dt_mode(MultiplyOperator0ByDT), stage(0),
+          time_dependent_jacobian0(true), time_dependent_jacobian1(true),
           pattern_engine(*this), prestage_engine(*this), residual_engine(*this), jacobian_engine(*this),
           explicit_jacobian_residual_engine(*this)
       { static_checks(); }
@@ -102,6 +103,15 @@ namespace Dune{
       //! assembling. Should be called before assembling if the local
       //! operator has time dependencies.
       void preStep(Real time_, Real dt_, int stages_){
+        setTimeStep(time_,dt_);
+
+        la0.preStep(time_,dt_, stages_);
+        la1.preStep(time_,dt_, stages_);
+      }
+
+      //! Change the start time and the size of the current step without
+      //! notifying the local operators, e.g. for the substeps of a step.
+      void setTimeStep(Real time_, Real dt_){
         time = time_;
         dt = dt_;
 
@@ -121,9 +131,6 @@ namespace Dune{
         else{
           DUNE_THROW(Dune::Exception,"Unknown mode for assembling of time step size!");
         }
-
-        la0.preStep(time_,dt_, stages_);
-        la1.preStep(time_,dt_, stages_);
       }
 
       //! Set the one step method parameters
@@ -155,11 +162,61 @@ namespace Dune{
         return time+osp_method->d(stage)*dt;
       }
 
+      //! Access the one step method parameters
+      const OneStepParameters & method() const{
+        return *osp_method;
+      }
+
+      //! Access the current stage of the one step scheme
+      int currentStage() const{
+        return stage;
+      }
+
+      //! The factor the time step size contributes to the operator of
+      //! temporal order zero
+      Real timeStepFactor0() const{
+        return dt_factor0;
+      }
+
+      //! The factor the time step size contributes to the operator of
+      //! temporal order one
+      Real timeStepFactor1() const{
+        return dt_factor1;
+      }
+
+      //! Replace the rows of constrained test DOFs in the global
+      //! matrix by unit rows, like the Jacobian engines do after
+      //! assembling
+      template<typename GFSV, typename Jacobian>
+      void setTrivialConstrainedRows(const GFSV& gfsv, Jacobian& a) const{
+        this->handle_dirichlet_constraints(gfsv,a);
+      }
+
       void setWeight(const Real weight){
         la0.setWeight(weight);
         la1.setWeight(weight);
       }
 
+      //! Declare whether the Jacobians of the local operators of
+      //! temporal order zero and one depend on time.
+      void setTimeDependentJacobian(bool dependent0, bool dependent1){
+        time_dependent_jacobian0 = dependent0;
+        time_dependent_jacobian1 = dependent1;
+      }
+
+      //! The fingerprint of the Jacobian assembled in the given stage
+      OneStepJacobianFingerprint<Real> jacobianFingerprint(int stage_) const{
+        OneStepJacobianFingerprint<Real> fp;
+        fp.a_rr = osp_method->a(stage_,stage_);
+        fp.b_rr = osp_method->b(stage_,stage_);
+        fp.dt_factor0 = fp.b_rr * dt_factor0;
+        fp.dt_factor1 = dt_factor1;
+        if ((time_dependent_jacobian0 && fp.b_rr != 0.0) || time_dependent_jacobian1)
+          fp.time = time+osp_method->d(stage_)*dt;
+        fp.valid = true;
+        return fp;
+      }
+
       //! Access methods which provid "ready to use" engines
       //! @{
 
@@ -230,6 +287,17 @@ namespace Dune{
         return explicit_jacobian_residual_engine;
       }
 
+      //! Returns a reference to the requested engine. This engine is
+      //! completely configured and ready to use.
+      LocalPreStageAssemblerEngine & localExplicitResidualAssemblerEngine
+      (typename Traits::Residual & r0, typename Traits::Residual & r1,
+       const std::vector<typename Traits::Solution*> & x)
+      {
+        prestage_engine.setSolutions( x );
+        prestage_engine.setConstResiduals(r0,r1);
+        return prestage_engine;
+      }
+
       //! @}
 
     private:
@@ -277,6 +345,9 @@ namespace Dune{
       //! The current stage of the one step scheme
       int stage;
 
+      //! Whether the Jacobians of the local operators depend on time
+      bool time_dependent_jacobian0, time_dependent_jacobian1;
+
       //! The engine member objects
       //! @{
       LocalPatternAssemblerEngine  pattern_engine;
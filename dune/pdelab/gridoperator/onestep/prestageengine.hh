@@ -74,7 +74,8 @@ namespace Dune{
           invalid_solutions(static_cast<Solutions*>(0)),
           const_residual_0(invalid_residual),
           const_residual_1(invalid_residual),
-          solutions(invalid_solutions)
+          solutions(invalid_solutions),
+          clear_residuals(true)
       {}
 
       //! Query methods for the global grid assembler
@@ -113,6 +114,12 @@ namespace Dune{
         setLocalAssemblerEngineDT1(la.la1.localResidualAssemblerEngine(*const_residual_1,*((*solutions)[0])));
       }
 
+      //! Control whether the residual vectors are cleared before assembling.
+      //! Without clearing, the contributions are added to the current values.
+      void setClearResiduals(bool clear){
+        clear_residuals = clear;
+      }
+
       //! Methods for loading of the local function's
       //! coefficients. These methods are blocked. The loading of the
       //! coefficients is done in each assemble call.
@@ -140,8 +147,10 @@ namespace Dune{
         lae0->preAssembly();
         lae1->preAssembly();
 
-        *const_residual_0 = 0.0;
-        *const_residual_1 = 0.0;
+        if (clear_residuals){
+          *const_residual_0 = 0.0;
+          *const_residual_1 = 0.0;
+        }
 
         // Extract the coefficients of the time step scheme
         a.resize(la.stage);
@@ -490,6 +499,9 @@ namespace Dune{
       //! Pointer to the current residual vector in which to assemble
       const Solutions * solutions;
 
+      //! Whether preAssembly() clears the residual vectors
+      bool clear_residuals;
+
       //! Coefficients of time stepping scheme
       std::vector<Real> a;
       std::vector<Real> b;
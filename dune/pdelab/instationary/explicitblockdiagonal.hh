@@ -0,0 +1,590 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+#ifndef DUNE_PDELAB_INSTATIONARY_EXPLICITBLOCKDIAGONAL_HH
+#define DUNE_PDELAB_INSTATIONARY_EXPLICITBLOCKDIAGONAL_HH
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/ios_state.hh>
+
+#include <dune/pdelab/backend/istl/blockmatrixdiagonal.hh>
+#include <dune/pdelab/common/logtag.hh>
+#include <dune/pdelab/gridfunctionspace/genericdatahandle.hh>
+#include <dune/pdelab/instationary/onestep.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    /**
+     *  @addtogroup OneStepMethod
+     *  @{
+     */
+
+    //! Explicit one step method for problems with a time-independent block-diagonal mass matrix
+    /**
+     * This is a drop-in replacement for ExplicitOneStepMethod for
+     * discontinuous Galerkin discretizations like
+     * DGLinearAcousticsSpatialOperator or DGMaxwellSpatialOperator, whose
+     * temporal operator yields a mass matrix that is block diagonal with one
+     * block per element.
+     *
+     * The mass matrix is assembled once, its diagonal blocks are inverted in
+     * place and the matrix itself is released again. Every stage then only
+     * assembles the residuals through
+     * OneStepGridOperator::explicit_residual() and computes the new stage
+     * value by applying the element-local inverses, so neither the Jacobian
+     * assembly nor any linear solver setup takes place during time stepping.
+     * The residual vectors and intermediate stage vectors are kept across
+     * time steps.
+     *
+     * The inverse mass matrix is recomputed automatically if the size of the
+     * function space changes. Call invalidateMassMatrix() if the coefficients
+     * of the temporal operator change for another reason.
+     *
+     * On parallel overlapping grids, overlap and ghost DOFs are updated after
+     * each stage by copy communication, like ISTLBackend_OVLP_ExplicitDiagonal.
+     *
+     * \tparam T          type to represent time values
+     * \tparam IGOS       assembler for instationary problems (explicit OneStepGridOperator)
+     * \tparam TrlV       vector type to represent coefficients of solutions
+     * \tparam TstV       vector type to represent residuals
+     * \tparam TC         time controller class
+     */
+    template<class T, class IGOS, class TrlV, class TstV = TrlV, class TC = SimpleTimeController<T> >
+    class ExplicitBlockDiagonalOneStepMethod
+    {
+      typedef typename TrlV::ElementType Real;
+      typedef typename IGOS::template MatrixContainer<Real>::Type M;
+      typedef typename istl::BlockMatrixDiagonal<M>::MatrixElementVector InverseMassMatrix;
+      typedef typename IGOS::Traits::TrialGridFunctionSpace GFS;
+
+    public:
+      //! construct a new one step scheme
+      /**
+       * \param method_    Parameter object.
+       * \param igos_      Assembler object (instationary grid operator space).
+       *
+       * Use SimpleTimeController that does not control the time step.
+       */
+      ExplicitBlockDiagonalOneStepMethod(const TimeSteppingParameterInterface<T>& method_, IGOS& igos_)
+        : method(&method_), igos(igos_), verbosityLevel(1), step(1),
+          tc(new SimpleTimeController<T>()), allocated(true)
+      {
+        if (method->implicit())
+          DUNE_THROW(Exception,"explicit one step method called with implicit scheme");
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+      }
+
+      //! construct a new one step scheme
+      /**
+       * \param method_    Parameter object.
+       * \param igos_      Assembler object (instationary grid operator space).
+       * \param tc_        a time controller object
+       */
+      ExplicitBlockDiagonalOneStepMethod(const TimeSteppingParameterInterface<T>& method_, IGOS& igos_, TC& tc_)
+        : method(&method_), igos(igos_), verbosityLevel(1), step(1),
+          tc(&tc_), allocated(false)
+      {
+        if (method->implicit())
+          DUNE_THROW(Exception,"explicit one step method called with implicit scheme");
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+      }
+
+      ~ExplicitBlockDiagonalOneStepMethod ()
+      {
+        if (allocated) delete tc;
+      }
+
+      //! change verbosity level; 0 means completely quiet
+      void setVerbosityLevel (int level)
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+        else
+          verbosityLevel = level;
+      }
+
+      //! change number of current step
+      void setStepNumber(int newstep) { step = newstep; }
+
+      //! redefine the method to be used; can be done before every step
+      void setMethod (const TimeSteppingParameterInterface<T>& method_)
+      {
+        method = &method_;
+        if (method->implicit())
+          DUNE_THROW(Exception,"explicit one step method called with implicit scheme");
+      }
+
+      //! discard the inverse mass matrix, it will be reassembled in the next stage
+      void invalidateMassMatrix()
+      {
+        inverse_mass.reset();
+      }
+
+      /*! \brief do one step;
+       * \param[in]  time start of time step
+       * \param[in]  dt suggested time step size
+       * \param[in]  xold value at begin of time step
+       * \param[in,out] xnew value at end of time step; contains initial guess for first substep on entry
+       * \return time step size
+       */
+      T apply (T time, T dt, TrlV& xold, TrlV& xnew)
+      {
+        DefaultLimiter limiter;
+        return apply(time,dt,xold,xnew,limiter);
+      }
+
+      template<typename Limiter>
+      T apply (T time, T dt, TrlV& xold, TrlV& xnew, Limiter& limiter)
+      {
+        // save formatting attributes
+        ios_base_all_saver format_attribute_saver(std::cout);
+        LocalTag mytag;
+        mytag << "ExplicitBlockDiagonalOneStepMethod::apply(): ";
+
+        prepareWorkspace(xold);
+
+        std::vector<TrlV*> x(1); // vector of pointers to all steps
+        x[0] = &xold;            // initially we have only one
+
+        if (verbosityLevel>=1){
+          std::ios_base::fmtflags oldflags = std::cout.flags();
+          std::cout << "TIME STEP [" << method->name() << "] "
+                    << std::setw(6) << step
+                    << " time (from): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time
+                    << " dt: "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << dt
+                    << " time (to): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time+dt
+                    << std::endl;
+          std::cout.flags(oldflags);
+        }
+
+        // prepare assembler
+        igos.preStep(*method,time,dt);
+
+        // loop over all stages
+        for(unsigned r=1; r<=method->s(); ++r)
+          {
+            LocalTag stagetag(mytag);
+            stagetag << "stage " << r << ": ";
+
+            if (verbosityLevel>=2){
+              std::ios_base::fmtflags oldflags = std::cout.flags();
+              std::cout << "STAGE "
+                        << r
+                        << " time (to): "
+                        << std::setw(12) << std::setprecision(4) << std::scientific
+                        << time+method->d(r)*dt
+                        << "." << std::endl;
+              std::cout.flags(oldflags);
+            }
+
+            // get vector for current stage, intermediate ones are kept across steps
+            if (r==method->s())
+              x.push_back(&xnew);
+            else
+              x.push_back(stages[r-1].get());
+
+            //apply slope limiter to old solution (e.g for finite volume reconstruction scheme)
+            limiter.prestage(*x[r-1]);
+
+            // compute residuals, the mass matrix only if it is not available yet
+            if (inverse_mass)
+              {
+                if(verbosityLevel>=4)
+                  std::cout << stagetag << "Assembling residual..." << std::endl;
+                igos.explicit_residual(r,x,*alpha,*beta);
+              }
+            else
+              {
+                if(verbosityLevel>=4)
+                  std::cout << stagetag << "Assembling residual and mass matrix..." << std::endl;
+                M D(igos);
+                D = Real(0.0);
+                igos.explicit_jacobian_residual(r,x,D,*alpha,*beta);
+                inverse_mass = std::make_shared<InverseMassMatrix>(D);
+                inverse_mass->invert();
+              }
+
+            // let time controller compute the optimal dt in first stage
+            if (r==1)
+              {
+                T newdt = tc->suggestTimestep(time,dt);
+                newdt = std::min(newdt, dt);
+
+                if (verbosityLevel>=2 && newdt!=dt)
+                  {
+                    std::ios_base::fmtflags oldflags = std::cout.flags();
+                    std::cout << "changed dt to "
+                              << std::setw(12) << std::setprecision(4) << std::scientific
+                              << newdt
+                              << std::endl;
+                    std::cout.flags(oldflags);
+                  }
+                dt = newdt;
+              }
+
+            // combine residual with selected dt and apply the element-local inverses
+            alpha->axpy(dt,*beta);
+            inverse_mass->mv(*alpha,*x[r]);
+
+            const GFS& gfs = igos.trialGridFunctionSpace();
+            if (gfs.gridView().comm().size()>1)
+              {
+                CopyDataHandle<GFS,TrlV> copydh(gfs,*x[r]);
+                gfs.gridView().communicate(copydh,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+              }
+
+            // apply slope limiter to new solution (e.g DG scheme)
+            limiter.poststage(*x[r]);
+
+            // stage cleanup
+            igos.postStage();
+
+            if (verbosityLevel>=4)
+              std::cout << stagetag << "Finished." << std::endl;
+          }
+
+        // step cleanup
+        igos.postStep();
+
+        step++;
+        return dt;
+      }
+
+    private:
+
+      //! dummy default limiter
+      class DefaultLimiter
+      {
+      public:
+        template<typename V>
+        void prestage(V& v)
+        {}
+
+        template<typename V>
+        void poststage(V& v)
+        {}
+      };
+
+      //! (re)allocate residual and stage vectors if the space or the scheme has changed
+      void prepareWorkspace(const TrlV& xold)
+      {
+        if (!alpha || alpha->N() != xold.N())
+          {
+            alpha = std::make_shared<TstV>(igos.testGridFunctionSpace());
+            beta = std::make_shared<TstV>(igos.testGridFunctionSpace());
+            stages.clear();
+            inverse_mass.reset();
+          }
+        while (stages.size() + 1 < method->s())
+          stages.push_back(std::make_shared<TrlV>(igos.trialGridFunctionSpace()));
+      }
+
+      const TimeSteppingParameterInterface<T> *method;
+      IGOS& igos;
+      int verbosityLevel;
+      int step;
+      TimeControllerInterface<T> *tc;
+      bool allocated;
+      std::shared_ptr<InverseMassMatrix> inverse_mass;
+      std::shared_ptr<TstV> alpha;
+      std::shared_ptr<TstV> beta;
+      std::vector<std::shared_ptr<TrlV> > stages;
+    };
+
+    //! Do one step of a low-storage explicit Runge-Kutta scheme
+    /**
+     * Advances the solution with a 2N-storage scheme described by a
+     * LowStorageTimeSteppingParameterInterface. Each stage evaluates
+     * \f$\Delta t L(u) = -\Delta t M^{-1} r(u)\f$ by one explicit Euler
+     * residual assembly of the instationary grid operator followed by the
+     * application of the element-local inverse mass matrices, and then
+     * updates the two registers \f$u\f$ (stored in xnew) and
+     * \f$\Delta u\f$.
+     *
+     * As in ExplicitBlockDiagonalOneStepMethod, the mass matrix must be
+     * block diagonal; it is assembled and inverted once and reused in all
+     * stages and time steps, so no Jacobian is assembled during time
+     * stepping. Apart from the residual vectors and the inverse mass
+     * matrix, only \f$\Delta u\f$ and one scratch vector are allocated,
+     * independent of the number of stages. The inverse mass matrix is
+     * recomputed automatically if the size of the function space changes.
+     * Call invalidateMassMatrix() if the coefficients of the temporal
+     * operator change for another reason.
+     *
+     * \tparam T          type to represent time values
+     * \tparam IGOS       assembler for instationary problems (explicit OneStepGridOperator)
+     * \tparam TrlV       vector type to represent coefficients of solutions
+     * \tparam TstV       vector type to represent residuals
+     * \tparam TC         time controller class
+     */
+    template<class T, class IGOS, class TrlV, class TstV = TrlV, class TC = SimpleTimeController<T> >
+    class LowStorageExplicitOneStepMethod
+    {
+      typedef typename TrlV::ElementType Real;
+      typedef typename IGOS::template MatrixContainer<Real>::Type M;
+      typedef typename istl::BlockMatrixDiagonal<M>::MatrixElementVector InverseMassMatrix;
+      typedef typename IGOS::Traits::TrialGridFunctionSpace GFS;
+
+    public:
+      //! construct a new low-storage scheme
+      /**
+       * \param method_    Parameter object.
+       * \param igos_      Assembler object (instationary grid operator space).
+       *
+       * Use SimpleTimeController that does not control the time step.
+       */
+      LowStorageExplicitOneStepMethod(const LowStorageTimeSteppingParameterInterface<T>& method_, IGOS& igos_)
+        : method(&method_), igos(igos_), verbosityLevel(1), step(1),
+          tc(new SimpleTimeController<T>()), allocated(true)
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+      }
+
+      //! construct a new low-storage scheme
+      /**
+       * \param method_    Parameter object.
+       * \param igos_      Assembler object (instationary grid operator space).
+       * \param tc_        a time controller object
+       */
+      LowStorageExplicitOneStepMethod(const LowStorageTimeSteppingParameterInterface<T>& method_, IGOS& igos_, TC& tc_)
+        : method(&method_), igos(igos_), verbosityLevel(1), step(1),
+          tc(&tc_), allocated(false)
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+      }
+
+      ~LowStorageExplicitOneStepMethod ()
+      {
+        if (allocated) delete tc;
+      }
+
+      //! change verbosity level; 0 means completely quiet
+      void setVerbosityLevel (int level)
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+        else
+          verbosityLevel = level;
+      }
+
+      //! change number of current step
+      void setStepNumber(int newstep) { step = newstep; }
+
+      //! redefine the method to be used; can be done before every step
+      void setMethod (const LowStorageTimeSteppingParameterInterface<T>& method_)
+      {
+        method = &method_;
+      }
+
+      //! discard the inverse mass matrix, it will be reassembled in the next stage
+      void invalidateMassMatrix()
+      {
+        inverse_mass.reset();
+      }
+
+      /*! \brief do one step;
+       * \param[in]  time start of time step
+       * \param[in]  dt suggested time step size
+       * \param[in]  xold value at begin of time step
+       * \param[out] xnew value at end of time step
+       * \return time step size
+       */
+      T apply (T time, T dt, TrlV& xold, TrlV& xnew)
+      {
+        DefaultLimiter limiter;
+        return apply(time,dt,xold,xnew,limiter);
+      }
+
+      template<typename Limiter>
+      T apply (T time, T dt, TrlV& xold, TrlV& xnew, Limiter& limiter)
+      {
+        // save formatting attributes
+        ios_base_all_saver format_attribute_saver(std::cout);
+        LocalTag mytag;
+        mytag << "LowStorageExplicitOneStepMethod::apply(): ";
+
+        prepareWorkspace(xold);
+
+        if (verbosityLevel>=1){
+          std::ios_base::fmtflags oldflags = std::cout.flags();
+          std::cout << "TIME STEP [" << method->name() << "] "
+                    << std::setw(6) << step
+                    << " time (from): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time
+                    << " dt: "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << dt
+                    << " time (to): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time+dt
+                    << std::endl;
+          std::cout.flags(oldflags);
+        }
+
+        xnew = xold;
+        *du = 0.0;
+
+        // L is evaluated by an explicit Euler stage: with a = (-1,1) and
+        // b = (1,0), z = M^{-1} dt*beta yields z = dt L(u)
+        std::vector<TrlV*> x(2);
+        x[0] = &xnew;
+        x[1] = z.get();
+
+        // prepare assembler, the stages only move the evaluation time
+        igos.preStep(euler,time,dt);
+
+        const GFS& gfs = igos.trialGridFunctionSpace();
+
+        // loop over all stages
+        for(unsigned r=1; r<=method->s(); ++r)
+          {
+            LocalTag stagetag(mytag);
+            stagetag << "stage " << r << ": ";
+
+            if (verbosityLevel>=2){
+              std::ios_base::fmtflags oldflags = std::cout.flags();
+              std::cout << "STAGE "
+                        << r
+                        << " time (at): "
+                        << std::setw(12) << std::setprecision(4) << std::scientific
+                        << time+method->c(r)*dt
+                        << "." << std::endl;
+              std::cout.flags(oldflags);
+            }
+
+            igos.setTimeStep(time+method->c(r)*dt,dt);
+
+            //apply slope limiter to current solution (e.g for finite volume reconstruction scheme)
+            limiter.prestage(xnew);
+
+            // compute residuals, the mass matrix only if it is not available yet
+            if (inverse_mass)
+              {
+                if(verbosityLevel>=4)
+                  std::cout << stagetag << "Assembling residual..." << std::endl;
+                igos.explicit_residual(1,x,*alpha,*beta);
+              }
+            else
+              {
+                if(verbosityLevel>=4)
+                  std::cout << stagetag << "Assembling residual and mass matrix..." << std::endl;
+                M D(igos);
+                D = Real(0.0);
+                igos.explicit_jacobian_residual(1,x,D,*alpha,*beta);
+                inverse_mass = std::make_shared<InverseMassMatrix>(D);
+                inverse_mass->invert();
+              }
+
+            // let time controller compute the optimal dt in first stage
+            if (r==1)
+              {
+                T newdt = tc->suggestTimestep(time,dt);
+                newdt = std::min(newdt, dt);
+
+                if (verbosityLevel>=2 && newdt!=dt)
+                  {
+                    std::ios_base::fmtflags oldflags = std::cout.flags();
+                    std::cout << "changed dt to "
+                              << std::setw(12) << std::setprecision(4) << std::scientific
+                              << newdt
+                              << std::endl;
+                    std::cout.flags(oldflags);
+                  }
+                dt = newdt;
+              }
+
+            // z = dt L(u)
+            *beta *= dt;
+            inverse_mass->mv(*beta,*z);
+
+            // update the registers
+            *du *= method->a(r);
+            *du += *z;
+            xnew.axpy(method->b(r),*du);
+
+            if (gfs.gridView().comm().size()>1)
+              {
+                CopyDataHandle<GFS,TrlV> copydh(gfs,xnew);
+                gfs.gridView().communicate(copydh,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+              }
+
+            // apply slope limiter to new solution (e.g DG scheme)
+            limiter.poststage(xnew);
+
+            // stage cleanup
+            igos.postStage();
+
+            if (verbosityLevel>=4)
+              std::cout << stagetag << "Finished." << std::endl;
+          }
+
+        // step cleanup
+        igos.postStep();
+
+        step++;
+        return dt;
+      }
+
+    private:
+
+      //! dummy default limiter
+      class DefaultLimiter
+      {
+      public:
+        template<typename V>
+        void prestage(V& v)
+        {}
+
+        template<typename V>
+        void poststage(V& v)
+        {}
+      };
+
+      //! (re)allocate the registers and the residual vectors if the space has changed
+      void prepareWorkspace(const TrlV& xold)
+      {
+        if (!du || du->N() != xold.N())
+          {
+            du = std::make_shared<TrlV>(igos.trialGridFunctionSpace());
+            z = std::make_shared<TrlV>(igos.trialGridFunctionSpace());
+            alpha = std::make_shared<TstV>(igos.testGridFunctionSpace());
+            beta = std::make_shared<TstV>(igos.testGridFunctionSpace());
+            inverse_mass.reset();
+          }
+      }
+
+      const LowStorageTimeSteppingParameterInterface<T> *method;
+      ExplicitEulerParameter<T> euler;
+      IGOS& igos;
+      int verbosityLevel;
+      int step;
+      TimeControllerInterface<T> *tc;
+      bool allocated;
+      std::shared_ptr<InverseMassMatrix> inverse_mass;
+      std::shared_ptr<TrlV> du;
+      std::shared_ptr<TrlV> z;
+      std::shared_ptr<TstV> alpha;
+      std::shared_ptr<TstV> beta;
+    };
+
+    /** @} */
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_INSTATIONARY_EXPLICITBLOCKDIAGONAL_HH
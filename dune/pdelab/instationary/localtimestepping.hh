@@ -0,0 +1,647 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+#ifndef DUNE_PDELAB_INSTATIONARY_LOCALTIMESTEPPING_HH
+#define DUNE_PDELAB_INSTATIONARY_LOCALTIMESTEPPING_HH
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/ios_state.hh>
+
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/pdelab/backend/istl/blockmatrixdiagonal.hh>
+#include <dune/pdelab/common/elementmapper.hh>
+#include <dune/pdelab/common/logtag.hh>
+#include <dune/pdelab/gridfunctionspace/genericdatahandle.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include <dune/pdelab/instationary/onestep.hh>
+#include <dune/pdelab/localoperator/localtimestepping.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    /**
+     *  @addtogroup OneStepMethod
+     *  @{
+     */
+
+    //! Assignment of the elements of a grid view to time step levels
+    /**
+     * Each element gets the level
+     * \f$\ell = \lfloor \log_2(\Delta t_e / \Delta t_{min}) \rfloor\f$,
+     * where \f$\Delta t_e\f$ is the admissible time step of the element and
+     * \f$\Delta t_{min}\f$ the smallest one over all processes. Levels are
+     * capped by a maximum level and afterwards lowered until the levels of
+     * neighbouring elements differ by at most one. Only interior elements
+     * are lowered, all other elements get the level of their owner, so the
+     * levels agree on all processes.
+     *
+     * During a macro step of size \f$2^L \Delta t_{min}\f$ an element on level
+     * \f$\ell\f$ is updated in every \f$2^\ell\f$-th of the \f$2^L\f$ substeps.
+     * weight() returns the factor the residual of an element or of a face
+     * is scaled with in the current substep, see
+     * LocalTimeSteppingLocalOperator.
+     *
+     * \tparam GV grid view type
+     * \tparam R  type to represent time values
+     */
+    template<typename GV, typename R = double>
+    class LocalTimeSteppingLevels
+    {
+      typedef typename GV::template Codim<0>::Iterator ElementIterator;
+      typedef typename GV::template Codim<0>::template Partition<Interior_Partition>::Iterator InteriorElementIterator;
+      typedef typename GV::IntersectionIterator IntersectionIterator;
+
+    public:
+      typedef typename GV::template Codim<0>::Entity Element;
+
+      /**
+       * \param gv_         grid view whose elements are assigned to levels
+       * \param max_level_  maximum level, i.e. the coarsest elements take at
+       *                    most \f$2^{max\_level}\f$ times the smallest step
+       */
+      LocalTimeSteppingLevels(const GV& gv_, int max_level_ = 4)
+        : gv(gv_), mapper(gv_), max_level(max_level_), top(0), substep(0), dtmin(0.0), update_count(0)
+      {}
+
+      //! set the maximum level, takes effect on the next update()
+      void setMaxLevel(int max_level_)
+      {
+        max_level = max_level_;
+      }
+
+      //! (re)compute the levels
+      /**
+       * \param celldt callable returning the admissible time step of an
+       *               element, e.g. \f$h_e / c_e\f$ for a wave with speed
+       *               \f$c_e\f$ times a CFL number
+       *
+       * This has to be called collectively on all processes.
+       */
+      template<typename F>
+      void update(const F& celldt)
+      {
+        std::vector<R> dt(gv.size(0));
+        R local_dtmin = 1e100;
+        for (ElementIterator it = gv.template begin<0>(); it!=gv.template end<0>(); ++it)
+          {
+            R& d = dt[mapper.map(*it)];
+            d = celldt(*it);
+            if (!(d > 0.0))
+              DUNE_THROW(Exception,"LocalTimeSteppingLevels: admissible time step has to be positive");
+            local_dtmin = std::min(local_dtmin,d);
+          }
+        dtmin = gv.comm().min(local_dtmin);
+
+        levels.resize(dt.size());
+        for (std::size_t i=0; i<dt.size(); ++i)
+          levels[i] = std::max(0,std::min(max_level,int(std::floor(std::log2(dt[i]/dtmin)))));
+
+        // limit the level jumps across faces, this only lowers levels and
+        // hence keeps every element within its CFL limit; the other
+        // processes are informed about lowered levels of interior elements
+        // until no process changes a level any more
+        bool changed = true;
+        while (changed)
+          {
+            changed = limitLevelJumps();
+            if (gv.comm().size() > 1)
+              {
+                LevelDataHandle dh(mapper,levels);
+                gv.communicate(dh,InteriorBorder_All_Interface,ForwardCommunication);
+                changed = dh.changed() || changed;
+              }
+            changed = gv.comm().max(int(changed));
+          }
+
+        int local_top = 0;
+        for (std::size_t i=0; i<levels.size(); ++i)
+          local_top = std::max(local_top,levels[i]);
+        top = gv.comm().max(local_top);
+        substep = 0;
+        ++update_count;
+      }
+
+      //! number of calls to update(), lets users detect changed levels
+      unsigned long updateCount() const
+      {
+        return update_count;
+      }
+
+      //! level of an element
+      int level(const Element& e) const
+      {
+        return levels[mapper.map(e)];
+      }
+
+      //! highest level over all processes
+      int maxLevel() const
+      {
+        return top;
+      }
+
+      //! number of substeps per macro step
+      unsigned int substeps() const
+      {
+        return 1u << top;
+      }
+
+      //! smallest admissible time step, the size of a substep
+      R fineTimestep() const
+      {
+        return dtmin;
+      }
+
+      //! largest macro step compatible with the levels
+      R macroTimestep() const
+      {
+        return dtmin*substeps();
+      }
+
+      //! select the substep within the macro step
+      void setSubstep(unsigned int k)
+      {
+        substep = k;
+      }
+
+      //! current substep within the macro step
+      unsigned int getSubstep() const
+      {
+        return substep;
+      }
+
+      //! whether an element is updated in the current substep
+      bool active(const Element& e) const
+      {
+        return substep % (1u << level(e)) == 0;
+      }
+
+      //! highest level whose elements start a local step in substep k
+      /**
+       * The elements on all levels up to the returned one are active in
+       * substep k. Substep \f$2^L\f$ is treated like substep 0.
+       */
+      int activeLevel(unsigned int k) const
+      {
+        int l = 0;
+        while (l < top && k % (2u << l) == 0)
+          ++l;
+        return l;
+      }
+
+      //! scaling of the residual of an element in the current substep
+      R weight(const Element& e) const
+      {
+        const unsigned int n = 1u << level(e);
+        return substep % n == 0 ? R(n) : R(0);
+      }
+
+      //! scaling of the contributions of a face between two elements in the current substep
+      /**
+       * A face is advanced with the local time step of its finer side, and
+       * both sides get the same contribution, so the flux across a level
+       * interface is conserved.
+       */
+      R weight(const Element& inside, const Element& outside) const
+      {
+        const unsigned int n = 1u << std::min(level(inside),level(outside));
+        return substep % n == 0 ? R(n) : R(0);
+      }
+
+    private:
+
+      //! exchanges the levels of the elements, records whether any level changed
+      class LevelDataHandle
+        : public CommDataHandleIF<LevelDataHandle,int>
+      {
+      public:
+        LevelDataHandle(const ElementMapper<GV>& mapper_, std::vector<int>& levels_)
+          : mapper(mapper_), levels(levels_), changed_(false)
+        {}
+
+        bool contains(int dim, int codim) const
+        {
+          return codim == 0;
+        }
+
+        bool fixedsize(int dim, int codim) const
+        {
+          return true;
+        }
+
+        template<typename Entity>
+        std::size_t size(const Entity& e) const
+        {
+          return 1;
+        }
+
+        template<typename MessageBuffer, typename Entity>
+        void gather(MessageBuffer& buff, const Entity& e) const
+        {
+          buff.write(levels[mapper.map(e)]);
+        }
+
+        template<typename MessageBuffer, typename Entity>
+        void scatter(MessageBuffer& buff, const Entity& e, std::size_t n)
+        {
+          int l;
+          buff.read(l);
+          int& current = levels[mapper.map(e)];
+          if (current != l)
+            {
+              current = l;
+              changed_ = true;
+            }
+        }
+
+        bool changed() const
+        {
+          return changed_;
+        }
+
+      private:
+        const ElementMapper<GV>& mapper;
+        std::vector<int>& levels;
+        bool changed_;
+      };
+
+      //! lower the levels of the interior elements until the jumps across faces are at most one
+      bool limitLevelJumps()
+      {
+        bool any_change = false;
+        bool changed = true;
+        while (changed)
+          {
+            changed = false;
+            for (InteriorElementIterator it = gv.template begin<0,Interior_Partition>();
+                 it!=gv.template end<0,Interior_Partition>(); ++it)
+              {
+                int& l = levels[mapper.map(*it)];
+                for (IntersectionIterator iit = gv.ibegin(*it); iit!=gv.iend(*it); ++iit)
+                  if (iit->neighbor())
+                    {
+                      const int ln = levels[mapper.map(*(iit->outside()))];
+                      if (l > ln+1)
+                        {
+                          l = ln+1;
+                          changed = true;
+                        }
+                    }
+              }
+            any_change = any_change || changed;
+          }
+        return any_change;
+      }
+
+      GV gv;
+      ElementMapper<GV> mapper;
+      int max_level;
+      int top;
+      unsigned int substep;
+      R dtmin;
+      unsigned long update_count;
+      std::vector<int> levels;
+    };
+
+    //! Multirate explicit Euler scheme with local time steps
+    /**
+     * Advances the solution by one macro step of size \f$\Delta t\f$ in
+     * \f$2^L\f$ substeps of size \f$\delta = 2^{-L}\Delta t\f$, where \f$L\f$
+     * is the highest level of the LocalTimeSteppingLevels object. In substep
+     * \f$k\f$, the elements on level \f$\ell\f$ with \f$k \bmod 2^\ell = 0\f$
+     * take an explicit Euler step of size \f$2^\ell\delta\f$ using the
+     * current values of their neighbours.
+     *
+     * The elements are sorted by level and the assembler of the grid
+     * operator only visits the elements which start a local step in the
+     * current substep, together with their faces (see
+     * DefaultAssembler::setElementSubset()). Assembly and update therefore
+     * cost \f$O(\sum_e 2^{L-\ell(e)})\f$ per macro step instead of \f$2^L\f$
+     * times the number of elements; the slope limiter and the communication
+     * of the solution still touch the whole vector in every substep. The
+     * previous traversal of the assembler is restored after every macro
+     * step.
+     *
+     * A face between elements on different levels is evaluated with the
+     * time step of its finer side, and the coarse side collects these
+     * contributions in a flux register until its own local step is
+     * complete. Both sides hence see the same flux and the scheme is
+     * conservative.
+     *
+     * The spatial local operator of the instationary grid operator has to be
+     * wrapped into a LocalTimeSteppingLocalOperator sharing the levels
+     * object, the temporal local operator is used unchanged. As in
+     * ExplicitBlockDiagonalOneStepMethod, the mass matrix must be block
+     * diagonal with one block per element; it is assembled and inverted
+     * once, so every substep only assembles the residual. This covers
+     * discontinuous Galerkin schemes like DGLinearAcousticsSpatialOperator
+     * as well as cell centered finite volume schemes like the TransportCCFV
+     * operators.
+     *
+     * \note The scheme is first order in time.
+     *
+     * \tparam T          type to represent time values
+     * \tparam IGOS       assembler for instationary problems (explicit OneStepGridOperator)
+     * \tparam Levels     time step levels, e.g. LocalTimeSteppingLevels
+     * \tparam TrlV       vector type to represent coefficients of solutions
+     * \tparam TstV       vector type to represent residuals
+     */
+    template<class T, class IGOS, class Levels, class TrlV, class TstV = TrlV>
+    class LocalTimeSteppingOneStepMethod
+    {
+      typedef typename TrlV::ElementType Real;
+      typedef typename IGOS::template MatrixContainer<Real>::Type M;
+      typedef typename istl::BlockMatrixDiagonal<M>::MatrixElementVector InverseMassMatrix;
+      typedef typename IGOS::Traits::TrialGridFunctionSpace GFS;
+      typedef typename GFS::Traits::GridViewType::template Codim<0>::Entity Element;
+      typedef typename Element::EntitySeed ElementSeed;
+      typedef typename IGOS::Assembler::ElementSubsetGuard ElementSubsetGuard;
+
+    public:
+      //! construct a new local time stepping scheme
+      /**
+       * \param igos_      Assembler object (instationary grid operator space).
+       * \param levels_    Time step levels, shared with the spatial local operator.
+       */
+      LocalTimeSteppingOneStepMethod(IGOS& igos_, Levels& levels_)
+        : igos(igos_), levels(levels_), verbosityLevel(1), step(1), level_lists_valid(false), level_lists_update(0)
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+      }
+
+      //! change verbosity level; 0 means completely quiet
+      void setVerbosityLevel (int level)
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+        else
+          verbosityLevel = level;
+      }
+
+      //! change number of current step
+      void setStepNumber(int newstep) { step = newstep; }
+
+      //! discard the inverse mass matrix, it will be reassembled in the next substep
+      void invalidateMassMatrix()
+      {
+        inverse_mass.reset();
+      }
+
+      /*! \brief do one macro step;
+       * \param[in]  time start of time step
+       * \param[in]  dt macro time step size, at most Levels::macroTimestep()
+       * \param[in]  xold value at begin of time step
+       * \param[out] xnew value at end of time step
+       * \return time step size
+       */
+      T apply (T time, T dt, TrlV& xold, TrlV& xnew)
+      {
+        DefaultLimiter limiter;
+        return apply(time,dt,xold,xnew,limiter);
+      }
+
+      template<typename Limiter>
+      T apply (T time, T dt, TrlV& xold, TrlV& xnew, Limiter& limiter)
+      {
+        // save formatting attributes
+        ios_base_all_saver format_attribute_saver(std::cout);
+        LocalTag mytag;
+        mytag << "LocalTimeSteppingOneStepMethod::apply(): ";
+
+        // the levels only guarantee stability up to the macro time step
+        if (dt > levels.macroTimestep()*(1.0+1e-12))
+          DUNE_THROW(Exception,"LocalTimeSteppingOneStepMethod::apply(): time step " << dt
+                     << " exceeds the macro time step " << levels.macroTimestep() << " of the levels");
+
+        prepareWorkspace(xold);
+        prepareLevelLists();
+
+        const unsigned int n = levels.substeps();
+        const T delta = dt/n;
+
+        if (verbosityLevel>=1){
+          std::ios_base::fmtflags oldflags = std::cout.flags();
+          std::cout << "TIME STEP [local time stepping, " << n << " substeps] "
+                    << std::setw(6) << step
+                    << " time (from): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time
+                    << " dt: "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << dt
+                    << " time (to): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time+dt
+                    << std::endl;
+          std::cout.flags(oldflags);
+        }
+
+        xnew = xold;
+
+        // each substep is an explicit Euler stage on the current solution;
+        // beta is the flux register, it collects the residual of every
+        // element until its local step is complete
+        std::vector<TrlV*> x(2);
+        x[0] = &xnew;
+        x[1] = z.get();
+        *alpha = 0.0;
+        *beta = 0.0;
+
+        const GFS& gfs = igos.trialGridFunctionSpace();
+        typename IGOS::Assembler& assembler = igos.assembler();
+        ElementSubsetGuard subset_guard(assembler,element_seeds);
+
+        igos.preStep(euler,time,delta);
+
+        try {
+          for (unsigned int k=0; k<n; ++k)
+            {
+              LocalTag substeptag(mytag);
+              substeptag << "substep " << k << ": ";
+
+              levels.setSubstep(k);
+              igos.setTimeStep(time+k*delta,delta);
+
+              //apply slope limiter to current solution (e.g for finite volume reconstruction scheme)
+              limiter.prestage(xnew);
+
+              // only visit the elements starting a local step
+              assembler.setElementSubsetSize(element_level_end[levels.activeLevel(k)]);
+              if (inverse_mass)
+                {
+                  if(verbosityLevel>=4)
+                    std::cout << substeptag << "Assembling residual..." << std::endl;
+                  igos.accumulate_explicit_residual(1,x,*alpha,*beta);
+                }
+              else
+                {
+                  // all registers are empty, so clearing them does no harm
+                  if(verbosityLevel>=4)
+                    std::cout << substeptag << "Assembling residual and mass matrix..." << std::endl;
+                  M D(igos);
+                  D = Real(0.0);
+                  igos.explicit_jacobian_residual(1,x,D,*alpha,*beta);
+                  inverse_mass = std::make_shared<InverseMassMatrix>(D);
+                  inverse_mass->invert();
+                }
+
+              // complete the local steps ending with this substep and clear their registers
+              updateBlocks(block_level_end[levels.activeLevel(k+1)],delta,xnew);
+
+              if (gfs.gridView().comm().size()>1)
+                {
+                  CopyDataHandle<GFS,TrlV> copydh(gfs,xnew);
+                  gfs.gridView().communicate(copydh,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+                }
+
+              // apply slope limiter to new solution (e.g DG scheme)
+              limiter.poststage(xnew);
+
+              // substep cleanup
+              igos.postStage();
+
+              if (verbosityLevel>=4)
+                std::cout << substeptag << "Finished." << std::endl;
+            }
+        }
+        catch (...) {
+          levels.setSubstep(0);
+          throw;
+        }
+
+        // step cleanup
+        levels.setSubstep(0);
+        igos.postStep();
+
+        step++;
+        return dt;
+      }
+
+    private:
+
+      //! dummy default limiter
+      class DefaultLimiter
+      {
+      public:
+        template<typename V>
+        void prestage(V& v)
+        {}
+
+        template<typename V>
+        void poststage(V& v)
+        {}
+      };
+
+      //! (re)allocate the work vectors if the space has changed
+      void prepareWorkspace(const TrlV& xold)
+      {
+        if (!alpha || alpha->N() != xold.N())
+          {
+            alpha = std::make_shared<TstV>(igos.testGridFunctionSpace());
+            beta = std::make_shared<TstV>(igos.testGridFunctionSpace());
+            z = std::make_shared<TrlV>(igos.trialGridFunctionSpace());
+            inverse_mass.reset();
+            level_lists_valid = false;
+          }
+      }
+
+      //! sort the elements and the vector blocks by level, if the levels have changed
+      void prepareLevelLists()
+      {
+        if (level_lists_valid && level_lists_update == levels.updateCount())
+          return;
+
+        typedef LocalFunctionSpace<GFS> LFS;
+        typedef LFSIndexCache<LFS> LFSCache;
+
+        const GFS& gfs = igos.trialGridFunctionSpace();
+        LFS lfs(gfs);
+        LFSCache lfs_cache(lfs);
+
+        const int top = levels.maxLevel();
+        const std::size_t blocks = gfs.blockCount();
+        std::vector<int> block_level(blocks,top);
+        std::vector<std::vector<ElementSeed> > seeds(top+1);
+
+        // a block shared by several elements is updated with the finest of them
+        for (const auto& cell : elements(gfs.gridView()))
+          {
+            const int l = levels.level(cell);
+            seeds[l].push_back(cell.seed());
+            lfs.bind(cell);
+            lfs_cache.update();
+            for (std::size_t i = 0; i < lfs_cache.size(); ++i)
+              {
+                int& bl = block_level[lfs_cache.containerIndex(i).back()];
+                bl = std::min(bl,l);
+              }
+          }
+
+        element_seeds.clear();
+        element_level_end.assign(top+1,0);
+        for (int l = 0; l <= top; ++l)
+          {
+            element_seeds.insert(element_seeds.end(),seeds[l].begin(),seeds[l].end());
+            element_level_end[l] = element_seeds.size();
+          }
+
+        std::vector<std::size_t> block_count(top+2,0);
+        for (std::size_t b = 0; b < blocks; ++b)
+          ++block_count[block_level[b]+1];
+        for (int l = 0; l <= top; ++l)
+          block_count[l+1] += block_count[l];
+        block_level_end.assign(block_count.begin()+1,block_count.end());
+        level_blocks.resize(blocks);
+        for (std::size_t b = 0; b < blocks; ++b)
+          level_blocks[block_count[block_level[b]]++] = b;
+
+        level_lists_valid = true;
+        level_lists_update = levels.updateCount();
+      }
+
+      //! x += delta M^{-1} beta on the first blocks of the level sorted list, clears their registers
+      void updateBlocks(std::size_t count, T delta, TrlV& xnew)
+      {
+        auto& b = istl::raw(*beta);
+        auto& zz = istl::raw(*z);
+        auto& xx = istl::raw(xnew);
+        for (std::size_t i = 0; i < count; ++i)
+          {
+            const std::size_t block = level_blocks[i];
+            inverse_mass->mv_block(block,*beta,*z);
+            xx[block].axpy(delta,zz[block]);
+            b[block] = 0.0;
+          }
+      }
+
+      ExplicitEulerParameter<T> euler;
+      IGOS& igos;
+      Levels& levels;
+      int verbosityLevel;
+      int step;
+      std::shared_ptr<InverseMassMatrix> inverse_mass;
+      std::shared_ptr<TstV> alpha;
+      std::shared_ptr<TstV> beta;
+      std::shared_ptr<TrlV> z;
+      bool level_lists_valid;
+      unsigned long level_lists_update;
+      std::vector<ElementSeed> element_seeds;
+      std::vector<std::size_t> element_level_end;
+      std::vector<std::size_t> level_blocks;
+      std::vector<std::size_t> block_level_end;
+    };
+
+    /** @} */
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_INSTATIONARY_LOCALTIMESTEPPING_HH
@@ -4,8 +4,11 @@
 #ifndef DUNE_PDELAB_ONESTEP_HH
 #define DUNE_PDELAB_ONESTEP_HH
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <ostream>
 #include <vector>
 
@@ -16,8 +19,13 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/ios_state.hh>
 
+#include <dune/istl/istlexception.hh>
+
+#include <dune/pdelab/backend/backendselector.hh>
 #include <dune/pdelab/common/logtag.hh>
+#include <dune/pdelab/gridfunctionspace/genericdatahandle.hh>
 #include <dune/pdelab/gridoperator/common/timesteppingparameterinterface.hh>
+#include <dune/pdelab/newton/exceptions.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -251,10 +259,13 @@ namespace Dune {
      * \brief Parameters to turn the ExplicitOneStepMethod into a
      * third order strong stability preserving (SSP) scheme.
      *
+     * The embedded second order method is Heun's method, built from the
+     * first two stages.
+     *
      * \tparam R C++ type of the floating point parameters
      */
     template<class R>
-    class Shu3Parameter : public TimeSteppingParameterInterface<R>
+    class Shu3Parameter : public EmbeddedTimeSteppingParameterInterface<R>
     {
     public:
 
@@ -270,6 +281,8 @@ namespace Dune {
         B[1][0] =  0.0; B[1][1] = 0.25;  B[1][2] = 0.0;     B[1][3] = 0.0;
         B[2][0] =  0.0; B[2][1] = 0.0;  B[2][2] = 2.0/3.0; B[2][3] = 0.0;
 
+        // Heun's method yields 2 x_2 - x_0
+        E[0] = 1.0; E[1] = 0.0; E[2] = -2.0; E[3] = 1.0;
       }
 
       /*! \brief Return true if method is implicit
@@ -317,10 +330,26 @@ namespace Dune {
         return std::string("Shu's third order method");
       }
 
+      /*! \brief Return coefficients of the error estimate
+        \note that i ∈ 0,...,s
+      */
+      virtual R e (int i) const
+      {
+        return E[i];
+      }
+
+      /*! \brief Return order of the embedded method
+      */
+      virtual unsigned embeddedOrder () const
+      {
+        return 2;
+      }
+
     private:
       Dune::FieldVector<R,4> D;
       Dune::FieldMatrix<R,3,4> A;
       Dune::FieldMatrix<R,3,4> B;
+      Dune::FieldVector<R,4> E;
     };
 
 
@@ -409,10 +438,13 @@ namespace Dune {
      * \brief Parameters to turn the OneStepMethod into an
      * Alexander scheme.
      *
+     * The embedded first order method takes the stage derivative of the
+     * first stage over the whole step.
+     *
      * \tparam R C++ type of the floating point parameters
      */
     template<class R>
-    class Alexander2Parameter : public TimeSteppingParameterInterface<R>
+    class Alexander2Parameter : public EmbeddedTimeSteppingParameterInterface<R>
     {
     public:
 
@@ -427,6 +459,9 @@ namespace Dune {
 
         B[0][0] =  0.0; B[0][1] = alpha;  B[0][2] = 0.0;
         B[1][0] =  0.0; B[1][1] = 1.0-alpha;  B[1][2] = alpha;
+
+        // the embedded solution is x_0 + (x_1-x_0)/alpha
+        E[0] = 1.0/alpha-1.0; E[1] = -1.0/alpha; E[2] = 1.0;
       }
 
       /*! \brief Return true if method is implicit
@@ -474,11 +509,27 @@ namespace Dune {
         return std::string("Alexander (order 2)");
       }
 
+      /*! \brief Return coefficients of the error estimate
+        \note that i ∈ 0,...,s
+      */
+      virtual R e (int i) const
+      {
+        return E[i];
+      }
+
+      /*! \brief Return order of the embedded method
+      */
+      virtual unsigned embeddedOrder () const
+      {
+        return 1;
+      }
+
     private:
       R alpha;
       Dune::FieldVector<R,3> D;
       Dune::FieldMatrix<R,2,3> A;
       Dune::FieldMatrix<R,2,3> B;
+      Dune::FieldVector<R,3> E;
     };
 
     /**
@@ -567,10 +618,13 @@ namespace Dune {
      * \brief Parameters to turn the OneStepMethod into an
      * Alexander3 scheme.
      *
+     * The embedded second order method combines the stage derivatives of
+     * the first two stages.
+     *
      * \tparam R C++ type of the floating point parameters
      */
     template<class R>
-    class Alexander3Parameter : public TimeSteppingParameterInterface<R>
+    class Alexander3Parameter : public EmbeddedTimeSteppingParameterInterface<R>
     {
     public:
 
@@ -607,6 +661,22 @@ namespace Dune {
         B[0][0] =  0.0; B[0][1] = alpha;      B[0][2] = 0.0;   B[0][3] = 0.0;
         B[1][0] =  0.0; B[1][1] = tau2-alpha; B[1][2] = alpha; B[1][3] = 0.0;
         B[2][0] =  0.0; B[2][1] = b1;         B[2][2] = b2;    B[2][3] = alpha;
+
+        // stage derivatives dt*k_1 and dt*k_2 in terms of the stage values
+        Dune::FieldVector<R,4> k1(0.0), k2(0.0);
+        k1[0] = -1.0/alpha; k1[1] = 1.0/alpha;
+        k2[0] = -1.0/alpha; k2[2] = 1.0/alpha;
+        k2.axpy(-(tau2-alpha)/alpha,k1);
+
+        // second order weights for the nodes alpha and tau2
+        R beta2 = (0.5-alpha)/(tau2-alpha);
+        R beta1 = 1.0-beta2;
+
+        // E = x_3 - (x_0 + beta1 dt k_1 + beta2 dt k_2)
+        E = 0.0;
+        E[0] = -1.0; E[3] = 1.0;
+        E.axpy(-beta1,k1);
+        E.axpy(-beta2,k2);
       }
 
       /*! \brief Return true if method is implicit
@@ -654,11 +724,191 @@ namespace Dune {
         return std::string("Alexander (claims order 3)");
       }
 
+      /*! \brief Return coefficients of the error estimate
+        \note that i ∈ 0,...,s
+      */
+      virtual R e (int i) const
+      {
+        return E[i];
+      }
+
+      /*! \brief Return order of the embedded method
+      */
+      virtual unsigned embeddedOrder () const
+      {
+        return 2;
+      }
+
     private:
       R alpha, theta, thetap, beta;
       Dune::FieldVector<R,4> D;
       Dune::FieldMatrix<R,3,4> A;
       Dune::FieldMatrix<R,3,4> B;
+      Dune::FieldVector<R,4> E;
+    };
+
+    /**
+     * \brief Interface for the parameters of low-storage Runge-Kutta methods.
+     *
+     * Describes 2N-storage explicit Runge-Kutta schemes in Williamson form
+     * for \f$u' = L(u)\f$:
+     *
+     * \f{align*}{
+     *   \Delta u &\leftarrow a_r \Delta u + \Delta t L(u, t + c_r\Delta t), \\
+     *   u &\leftarrow u + b_r \Delta u,
+     * \f}
+     *
+     * for \f$r = 1,\ldots,s\f$ with \f$a_1 = 0\f$. Only the two registers
+     * \f$u\f$ and \f$\Delta u\f$ have to be kept, regardless of the
+     * number of stages. These schemes are used with
+     * LowStorageExplicitOneStepMethod, see
+     * dune/pdelab/instationary/explicitblockdiagonal.hh.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class LowStorageTimeSteppingParameterInterface
+    {
+    public:
+      typedef R RealType;
+
+      /*! \brief Return number of stages s of the method
+       */
+      virtual unsigned s () const = 0;
+
+      /*! \brief Return the weight of the old increment in stage r
+        \note that r ∈ 1,...,s
+      */
+      virtual R a (int r) const = 0;
+
+      /*! \brief Return the weight of the increment in the update of stage r
+        \note that r ∈ 1,...,s
+      */
+      virtual R b (int r) const = 0;
+
+      /*! \brief Return the relative time at which L is evaluated in stage r
+        \note that r ∈ 1,...,s
+      */
+      virtual R c (int r) const = 0;
+
+      /*! \brief Return name of the scheme
+       */
+      virtual std::string name () const = 0;
+
+      //! every abstract base class has a virtual destructor
+      virtual ~LowStorageTimeSteppingParameterInterface () {}
+    };
+
+    /**
+     * \brief Parameters of Williamson's third order, three stage
+     * low-storage Runge-Kutta method.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class Williamson3Parameter : public LowStorageTimeSteppingParameterInterface<R>
+    {
+    public:
+
+      Williamson3Parameter ()
+      {
+        A[0] = 0.0;      A[1] = -5.0/9.0;   A[2] = -153.0/128.0;
+        B[0] = 1.0/3.0;  B[1] = 15.0/16.0;  B[2] = 8.0/15.0;
+        C[0] = 0.0;      C[1] = 1.0/3.0;    C[2] = 3.0/4.0;
+      }
+
+      virtual unsigned s () const
+      {
+        return 3;
+      }
+
+      virtual R a (int r) const
+      {
+        return A[r-1];
+      }
+
+      virtual R b (int r) const
+      {
+        return B[r-1];
+      }
+
+      virtual R c (int r) const
+      {
+        return C[r-1];
+      }
+
+      virtual std::string name () const
+      {
+        return std::string("Williamson (order 3, low storage)");
+      }
+
+    private:
+      Dune::FieldVector<R,3> A;
+      Dune::FieldVector<R,3> B;
+      Dune::FieldVector<R,3> C;
+    };
+
+    /**
+     * \brief Parameters of the fourth order, five stage low-storage
+     * Runge-Kutta method of Carpenter and Kennedy.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class CarpenterKennedy4Parameter : public LowStorageTimeSteppingParameterInterface<R>
+    {
+    public:
+
+      CarpenterKennedy4Parameter ()
+      {
+        A[0] = 0.0;
+        A[1] = -567301805773.0/1357537059087.0;
+        A[2] = -2404267990393.0/2016746695238.0;
+        A[3] = -3550918686646.0/2091501179385.0;
+        A[4] = -1275806237668.0/842570457699.0;
+
+        B[0] = 1432997174477.0/9575080441755.0;
+        B[1] = 5161836677717.0/13612068292357.0;
+        B[2] = 1720146321549.0/2090206949498.0;
+        B[3] = 3134564353537.0/4481467310338.0;
+        B[4] = 2277821191437.0/14882151754819.0;
+
+        C[0] = 0.0;
+        C[1] = 1432997174477.0/9575080441755.0;
+        C[2] = 2526269341429.0/6820363266100.0;
+        C[3] = 2006345519317.0/3224310063776.0;
+        C[4] = 2802321613138.0/2924317926251.0;
+      }
+
+      virtual unsigned s () const
+      {
+        return 5;
+      }
+
+      virtual R a (int r) const
+      {
+        return A[r-1];
+      }
+
+      virtual R b (int r) const
+      {
+        return B[r-1];
+      }
+
+      virtual R c (int r) const
+      {
+        return C[r-1];
+      }
+
+      virtual std::string name () const
+      {
+        return std::string("Carpenter-Kennedy (order 4, low storage)");
+      }
+
+    private:
+      Dune::FieldVector<R,5> A;
+      Dune::FieldVector<R,5> B;
+      Dune::FieldVector<R,5> C;
     };
 
 
@@ -739,6 +989,225 @@ namespace Dune {
       const IGOS& igos;
     };
 
+    //! the PITimeController refused to reduce the time step any further
+    class TimeStepControlError : public Exception {};
+
+    //! PI controller for the time step based on an embedded error estimate
+    /**
+     * Used by OneStepMethod together with a scheme implementing
+     * EmbeddedTimeSteppingParameterInterface. After each step the norm of
+     * the error estimate is scaled to
+     * \f[ \varepsilon = \frac{\|e\|}{atol + rtol \|x\|}. \f]
+     * The step is accepted if \f$\varepsilon \le 1\f$, and the next step is
+     * chosen as
+     * \f[ \Delta t_{n+1} = \Delta t_n \, \rho \,
+     *     \varepsilon_n^{-k_I/(q+1)} \varepsilon_{n-1}^{k_P/(q+1)} \f]
+     * with the order \f$q\f$ of the embedded method and the safety factor
+     * \f$\rho\f$. A rejected step is repeated with the time step reduced
+     * by the elementary controller.
+     *
+     * Time stepping fails with a TimeStepControlError if the time step has
+     * to be reduced below the minimum time step, which defaults to
+     * \f$10^{-8}\f$ times the first time step, or if a step is rejected
+     * more than a given number of times (default 20) in a row. This holds
+     * for rejections by the error estimate (acceptStep()) as well as for
+     * failures of the solver (failedStep()).
+     *
+     * The time step passed to the time stepping scheme is only used until
+     * the controller has judged the first step (or after reset()), all
+     * further steps use the time step proposed by the controller.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class PITimeController : public TimeControllerInterface<R>
+    {
+    public:
+      typedef R RealType;
+
+      /**
+       * \param rtol_   relative tolerance
+       * \param atol_   absolute tolerance
+       * \param target_ final time, steps are shortened to hit it exactly
+       */
+      PITimeController (R rtol_, R atol_ = 0.0, R target_ = 1e100)
+        : rtol(rtol_), atol(atol_), target(target_), safety(0.9), kI(0.7), kP(0.4),
+          facmin(0.2), facmax(5.0), dtmin(0.0), dtmin_factor(1e-8), dtmax(1e100), dtfirst(0.0),
+          proposed(0.0), errold(-1.0), rejected(false), accepted_steps(0), rejected_steps(0),
+          max_rejections(20), consecutive_rejections(0)
+      {}
+
+      void setTarget (R target_)
+      {
+        target = target_;
+      }
+
+      void setTolerances (R rtol_, R atol_)
+      {
+        rtol = rtol_;
+        atol = atol_;
+      }
+
+      //! set safety factor applied to the optimal step
+      void setSafetyFactor (R safety_)
+      {
+        safety = safety_;
+      }
+
+      //! set integral and proportional gain; kP = 0 yields the elementary controller
+      void setGains (R kI_, R kP_)
+      {
+        kI = kI_;
+        kP = kP_;
+      }
+
+      //! limit the ratio of consecutive time steps
+      void setStepRatioLimits (R facmin_, R facmax_)
+      {
+        facmin = facmin_;
+        facmax = facmax_;
+      }
+
+      //! limit the time step; stepping fails if it has to be reduced below dtmin_
+      /**
+       * A nonpositive dtmin_ selects the default minimum time step relative
+       * to the first time step, see setRelativeMinimumTimestep().
+       */
+      void setTimestepLimits (R dtmin_, R dtmax_)
+      {
+        dtmin = dtmin_;
+        dtmax = dtmax_;
+      }
+
+      //! set the default minimum time step as a fraction of the first time step
+      void setRelativeMinimumTimestep (R factor)
+      {
+        dtmin_factor = factor;
+      }
+
+      //! limit the number of consecutive rejections of a step
+      void setMaxRejections (unsigned int n)
+      {
+        max_rejections = n;
+      }
+
+      //! the time step below which stepping fails
+      RealType minimumTimestep () const
+      {
+        return dtmin > 0.0 ? dtmin : dtmin_factor*dtfirst;
+      }
+
+      //! forget the controller history, e.g. after a discontinuity in the data
+      void reset ()
+      {
+        proposed = 0.0;
+        errold = -1.0;
+        rejected = false;
+        consecutive_rejections = 0;
+      }
+
+      unsigned int acceptedSteps () const { return accepted_steps; }
+      unsigned int rejectedSteps () const { return rejected_steps; }
+
+      /*! \brief Return the time step proposed by the last error estimate, or givendt initially
+       */
+      virtual RealType suggestTimestep (RealType time, RealType givendt)
+      {
+        RealType suggested = proposed > 0.0 ? proposed : givendt;
+        suggested = std::min(suggested,dtmax);
+        if (time+2.0*suggested<target)
+          return suggested;
+        if (time+suggested<target)
+          return 0.5*(target-time);
+        return target-time;
+      }
+
+      //! scaled error of a step
+      RealType scaledError (RealType error_norm, RealType solution_norm) const
+      {
+        return error_norm/(atol + rtol*solution_norm);
+      }
+
+      /*! \brief Judge a step and compute the next time step
+       * \param dt    size of the step just computed
+       * \param err   scaled error of the step
+       * \param order order of the embedded method
+       * \return whether the step is accepted
+       * \throws TimeStepControlError if a rejected step must not be retried
+       */
+      bool acceptStep (RealType dt, RealType err, unsigned int order)
+      {
+        recordFirstTimestep(dt);
+        const RealType k = order+1;
+        if (err <= 1.0)
+          {
+            err = std::max(err,RealType(1e-10));
+            RealType fac = safety*std::pow(err,-kI/k);
+            if (errold > 0.0)
+              fac *= std::pow(errold,kP/k);
+            else
+              fac = safety*std::pow(err,-1.0/k);
+            // do not increase the step right after a rejection
+            fac = std::max(facmin,std::min(rejected ? RealType(1.0) : facmax,fac));
+            proposed = dt*fac;
+            errold = err;
+            rejected = false;
+            consecutive_rejections = 0;
+            ++accepted_steps;
+            return true;
+          }
+        RealType fac = std::max(facmin,safety*std::pow(err,-1.0/k));
+        rejectStep(dt*fac);
+        return false;
+      }
+
+      //! the solver failed for time step dt, try again with a smaller one
+      /**
+       * \throws TimeStepControlError if the step must not be retried,
+       *         because the reduced time step would fall below the minimum
+       *         time step or the step has been rejected too often
+       */
+      void failedStep (RealType dt)
+      {
+        recordFirstTimestep(dt);
+        rejectStep(dt*facmin);
+      }
+
+    private:
+      void recordFirstTimestep (RealType dt)
+      {
+        if (dtfirst <= 0.0)
+          dtfirst = dt;
+      }
+
+      void rejectStep (RealType newdt)
+      {
+        if (newdt < minimumTimestep())
+          DUNE_THROW(TimeStepControlError,"PITimeController: time step " << newdt
+                     << " fell below minimum time step " << minimumTimestep());
+        if (consecutive_rejections >= max_rejections)
+          DUNE_THROW(TimeStepControlError,"PITimeController: step rejected " << consecutive_rejections
+                     << " times in a row");
+        proposed = newdt;
+        rejected = true;
+        ++rejected_steps;
+        ++consecutive_rejections;
+      }
+
+      R rtol, atol;
+      R target;
+      R safety;
+      R kI, kP;
+      R facmin, facmax;
+      R dtmin, dtmin_factor, dtmax;
+      R dtfirst;
+      R proposed;
+      R errold;
+      bool rejected;
+      unsigned int accepted_steps, rejected_steps;
+      unsigned int max_rejections, consecutive_rejections;
+    };
+
 
     // Status information of Newton's method
     struct OneStepMethodPartialResult
@@ -778,6 +1247,8 @@ namespace Dune {
     class OneStepMethod
     {
       typedef typename PDESOLVER::Result PDESolverResult;
+      //! owner rank of every DOF, used for norms without counting shared DOFs twice
+      typedef typename BackendVectorSelector<typename IGOS::Traits::TrialGridFunctionSpace,int>::Type RankVector;
 
     public:
       typedef OneStepMethodResult Result;
@@ -796,7 +1267,8 @@ namespace Dune {
        */
       OneStepMethod(const TimeSteppingParameterInterface<T>& method_,
                     IGOS& igos_, PDESOLVER& pdesolver_)
-        : method(&method_), igos(igos_), pdesolver(pdesolver_), verbosityLevel(1), step(1), res()
+        : method(&method_), igos(igos_), pdesolver(pdesolver_), verbosityLevel(1), step(1), res(), controller(0),
+          reuse_stage_matrix(false), last_size(0)
       {
         if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
           verbosityLevel = 0;
@@ -844,6 +1316,77 @@ namespace Dune {
         method = &method_;
       }
 
+      //! control the time step by the embedded error estimate of the scheme
+      /**
+       * \param controller_ PI controller, referenced until clearErrorController() is called
+       *
+       * Error control only takes effect for schemes implementing
+       * EmbeddedTimeSteppingParameterInterface, like Alexander2Parameter and
+       * Alexander3Parameter. apply() then repeats a step with a smaller
+       * time step until the scaled error is below one. The time step passed
+       * to apply() is only used for the first step, afterwards apply() takes
+       * the step proposed by the controller and returns its size. A failure
+       * of the PDE solver (a NewtonError or an ISTLError) also leads to a
+       * repetition with a reduced time step. Once the controller refuses
+       * further retries, apply() throws a TimeStepControlError. Other
+       * exceptions are never caught.
+       */
+      void setErrorController (PITimeController<T>& controller_)
+      {
+        controller = &controller_;
+      }
+
+      //! switch off error control
+      void clearErrorController ()
+      {
+        controller = 0;
+      }
+
+      //! reuse the stage matrix if it is known to be unchanged
+      /**
+       * Meant for linear problems solved with StationaryLinearProblemSolver.
+       * Before each stage, the fingerprint of the stage Jacobian provided by
+       * OneStepGridOperator::jacobianFingerprint() is compared with the one
+       * of the previous solve. If they agree, the solver is told to skip the
+       * matrix assembly and to keep its preconditioner, e.g. across the
+       * stages of SDIRK schemes like Alexander2Parameter and across steps
+       * with a constant time step. Use
+       * OneStepGridOperator::setTimeDependentJacobian() to declare time
+       * independent operators, otherwise stages at different times never
+       * share a matrix.
+       *
+       * \note The fingerprint does not cover the dependence on the
+       *       solution, so this must not be enabled for nonlinear problems.
+       *       Solvers without an apply(x,reuse_matrix) method, like
+       *       Newton, always assemble the matrix.
+       */
+      void setStageMatrixReuse (bool reuse)
+      {
+        reuse_stage_matrix = reuse;
+        discardStageMatrix();
+      }
+
+      //! forget the last stage matrix, e.g. after the coefficients of the problem changed
+      void discardStageMatrix ()
+      {
+        last_fingerprint = OneStepJacobianFingerprint<T>();
+      }
+
+      //! release the vectors kept across time steps
+      /**
+       * The intermediate stage vectors are allocated in the first step and
+       * reused in all following steps. They are reallocated automatically
+       * if the size of the function space changes, call this method to
+       * release them, e.g. after grid adaptation.
+       */
+      void releaseWorkspace ()
+      {
+        stages.clear();
+        error.reset();
+        guess.reset();
+        owners.reset();
+      }
+
       /*! \brief do one step;
        * \param[in]  time start of time step
        * \param[in]  dt suggested time step size
@@ -853,152 +1396,184 @@ namespace Dune {
        */
       T apply (T time, T dt, TrlV& xold, TrlV& xnew)
       {
-        // save formatting attributes
-        ios_base_all_saver format_attribute_saver(std::cout);
+        NoInterpolation* f = 0;
+        return controlledStep(time,dt,xold,f,xnew);
+      }
 
-        // do statistics
-        OneStepMethodPartialResult step_result;
+      /*! \brief do one step;
+       * This is a version which interpolates constraints at the start of each stage
+       *
+       * \param[in]  time start of time step
+       * \param[in]  dt suggested time step size
+       * \param[in]  xold value at begin of time step
+       * \param[in]  f function to interpolate boundary conditions from
+       * \param[in,out] xnew value at end of time step; contains initial guess for first substep on entry
+       * \return selected time step size
+       */
+      template<typename F>
+      T apply (T time, T dt, TrlV& xold, F& f, TrlV& xnew)
+      {
+        return controlledStep(time,dt,xold,&f,xnew);
+      }
 
-        std::vector<TrlV*> x(1); // vector of pointers to all steps
-        x[0] = &xold;            // initially we have only one
+    private:
+      //! tag for steps without interpolation of constraints
+      struct NoInterpolation {};
 
-        if (verbosityLevel>=1){
-          std::ios_base::fmtflags oldflags = std::cout.flags();
-          std::cout << "TIME STEP [" << method->name() << "] "
-                    << std::setw(6) << step
-                    << " time (from): "
-                    << std::setw(12) << std::setprecision(4) << std::scientific
-                    << time
-                    << " dt: "
-                    << std::setw(12) << std::setprecision(4) << std::scientific
-                    << dt
-                    << " time (to): "
-                    << std::setw(12) << std::setprecision(4) << std::scientific
-                    << time+dt
-                    << std::endl;
-          std::cout.flags(oldflags);
-        }
+      //! repeat the step until the error controller accepts it
+      template<typename F>
+      T controlledStep (T time, T dt, TrlV& xold, F* f, TrlV& xnew)
+      {
+        // save formatting attributes
+        ios_base_all_saver format_attribute_saver(std::cout);
 
-        // prepare assembler
-        igos.preStep(*method,time,dt);
+        const EmbeddedTimeSteppingParameterInterface<T>* embedded = 0;
+        if (controller)
+          embedded = dynamic_cast<const EmbeddedTimeSteppingParameterInterface<T>*>(method);
 
-        // loop over all stages
-        for (unsigned r=1; r<=method->s(); ++r)
+        if (!embedded)
           {
-            if (verbosityLevel>=2){
-              std::ios_base::fmtflags oldflags = std::cout.flags();
-              std::cout << "STAGE "
-                        << r
-                        << " time (to): "
-                        << std::setw(12) << std::setprecision(4) << std::scientific
-                        << time+method->d(r)*dt
-                        << "." << std::endl;
-              std::cout.flags(oldflags);
-            }
+            OneStepMethodPartialResult step_result;
+            solveStages(time,dt,xold,f,xnew,step_result,0);
+            acceptStep(step_result);
+            return dt;
+          }
 
-            // prepare stage
-            igos.preStage(r,x);
+        if (!error || error->N() != xold.N())
+          {
+            error = std::make_shared<TrlV>(igos.trialGridFunctionSpace());
+            guess = std::make_shared<TrlV>(igos.trialGridFunctionSpace());
+          }
+        *guess = xnew;
+        dt = controller->suggestTimestep(time,dt);
 
-            // get vector for current stage
-            if (r==method->s())
+        while (true)
+          {
+            OneStepMethodPartialResult step_result;
+            try {
+              solveStages(time,dt,xold,f,xnew,step_result,error.get());
+            }
+            catch (NewtonError& e)
               {
-                // last stage
-                x.push_back(&xnew);
-                if (r>1) xnew = *(x[r-1]); // if r=1 then xnew has already initial guess
+                retryFailedStep(e,time,dt);
+                xnew = *guess;
+                continue;
               }
-            else
+            catch (ISTLError& e)
               {
-                // intermediate step
-                x.push_back(new TrlV(igos.trialGridFunctionSpace()));
-                if (r>1)
-                  *(x[r]) = *(x[r-1]); // use result of last stage as initial guess
-                else
-                  *(x[r]) = xnew;
+                retryFailedStep(e,time,dt);
+                xnew = *guess;
+                continue;
               }
 
-            // solve stage
-            try {
-              pdesolver.apply(*x[r]);
-            }
-            catch (...)
+            // norms of the error estimate and the new solution
+            const T error_norm = globalNorm(*error);
+            const T solution_norm = globalNorm(xnew);
+            const T err = controller->scaledError(error_norm,solution_norm);
+
+            if (controller->acceptStep(dt,err,embedded->embeddedOrder()))
               {
-                // time step failed -> accumulate to total only
-                PDESolverResult pderes = pdesolver.result();
-                step_result.assembler_time += pderes.assembler_time;
-                step_result.linear_solver_time += pderes.linear_solver_time;
-                step_result.linear_solver_iterations += pderes.linear_solver_iterations;
-                step_result.nonlinear_solver_iterations += pderes.iterations;
-                res.total.assembler_time += step_result.assembler_time;
-                res.total.linear_solver_time += step_result.linear_solver_time;
-                res.total.linear_solver_iterations += step_result.linear_solver_iterations;
-                res.total.nonlinear_solver_iterations += step_result.nonlinear_solver_iterations;
-                res.total.timesteps += 1;
-                throw;
+                if (verbosityLevel>=2){
+                  std::ios_base::fmtflags oldflags = std::cout.flags();
+                  std::cout << "::: accepted, scaled error "
+                            << std::setw(12) << std::setprecision(4) << std::scientific
+                            << err << std::endl;
+                  std::cout.flags(oldflags);
+                }
+                acceptStep(step_result);
+                return dt;
               }
-            PDESolverResult pderes = pdesolver.result();
-            step_result.assembler_time += pderes.assembler_time;
-            step_result.linear_solver_time += pderes.linear_solver_time;
-            step_result.linear_solver_iterations += pderes.linear_solver_iterations;
-            step_result.nonlinear_solver_iterations += pderes.iterations;
 
-            // stage cleanup
-            igos.postStage();
+            // rejected step -> accumulate to total only
+            accumulate(res.total,step_result);
+            res.total.timesteps += 1;
+
+            const T newdt = controller->suggestTimestep(time,dt);
+            if (verbosityLevel>=1){
+              std::ios_base::fmtflags oldflags = std::cout.flags();
+              std::cout << "::: rejected, scaled error "
+                        << std::setw(12) << std::setprecision(4) << std::scientific
+                        << err << ", retry with dt "
+                        << std::setw(12) << std::setprecision(4) << std::scientific
+                        << newdt << std::endl;
+              std::cout.flags(oldflags);
+            }
+            dt = newdt;
+            xnew = *guess;
           }
+      }
 
-        // delete intermediate steps
-        for (unsigned i=1; i<method->s(); ++i) delete x[i];
+      //! reduce the time step after a failure of the PDE solver
+      void retryFailedStep (const Dune::Exception& e, T time, T& dt)
+      {
+        // statistics have already been accumulated to the total
+        if (verbosityLevel>=1)
+          std::cout << "::: step failed: " << e.what() << std::endl;
+        try {
+          controller->failedStep(dt);
+        }
+        catch (TimeStepControlError& ce)
+          {
+            DUNE_THROW(TimeStepControlError,ce.what() << ", the PDE solver failed with: " << e.what());
+          }
+        dt = controller->suggestTimestep(time,dt);
+      }
 
-        // step cleanup
-        igos.postStep();
+      //! Euclidean norm over all ranks, counting every DOF on its owner rank only
+      T globalNorm (const TrlV& x)
+      {
+        typedef typename IGOS::Traits::TrialGridFunctionSpace GFS;
+        const GFS& gfs = igos.trialGridFunctionSpace();
+        if (gfs.gridView().comm().size() == 1)
+          return x.two_norm();
 
-        // update statistics
-        res.total.assembler_time += step_result.assembler_time;
-        res.total.linear_solver_time += step_result.linear_solver_time;
-        res.total.linear_solver_iterations += step_result.linear_solver_iterations;
-        res.total.nonlinear_solver_iterations += step_result.nonlinear_solver_iterations;
-        res.total.timesteps += 1;
-        res.successful.assembler_time += step_result.assembler_time;
-        res.successful.linear_solver_time += step_result.linear_solver_time;
-        res.successful.linear_solver_iterations += step_result.linear_solver_iterations;
-        res.successful.nonlinear_solver_iterations += step_result.nonlinear_solver_iterations;
-        res.successful.timesteps += 1;
-        if (verbosityLevel>=1){
-          std::ios_base::fmtflags oldflags = std::cout.flags();
-          std::cout << "::: timesteps      " << std::setw(6) << res.successful.timesteps
-                    << " (" << res.total.timesteps << ")" << std::endl;
-          std::cout << "::: nl iterations  " << std::setw(6) << res.successful.nonlinear_solver_iterations
-                    << " (" << res.total.nonlinear_solver_iterations << ")" << std::endl;
-          std::cout << "::: lin iterations " << std::setw(6) << res.successful.linear_solver_iterations
-                    << " (" << res.total.linear_solver_iterations << ")" << std::endl;
-          std::cout << "::: assemble time  " << std::setw(12) << std::setprecision(4) << std::scientific
-                    << res.successful.assembler_time << " (" << res.total.assembler_time << ")" << std::endl;
-          std::cout << "::: lin solve time " << std::setw(12) << std::setprecision(4) << std::scientific
-                    << res.successful.linear_solver_time << " (" << res.total.linear_solver_time << ")" << std::endl;
-          std::cout.flags(oldflags);
-        }
+        if (!owners || owners->N() != x.N())
+          {
+            owners = std::make_shared<RankVector>(gfs);
+            DisjointPartitioningDataHandle<GFS,RankVector> pdh(gfs,*owners);
+            gfs.gridView().communicate(pdh,InteriorBorder_All_Interface,ForwardCommunication);
+          }
 
-        step++;
-        return dt;
+        using std::abs;
+        const int rank = gfs.gridView().comm().rank();
+        T sum = 0.0;
+        typename RankVector::const_iterator owner = owners->begin();
+        for (typename TrlV::const_iterator it = x.begin(); it != x.end(); ++it, ++owner)
+          if (*owner == rank)
+            sum += abs(*it)*abs(*it);
+        return std::sqrt(gfs.gridView().comm().sum(sum));
       }
 
-      /*! \brief do one step;
-       * This is a version which interpolates constraints at the start of each stage
-       *
-       * \param[in]  time start of time step
-       * \param[in]  dt suggested time step size
-       * \param[in]  xold value at begin of time step
-       * \param[in]  f function to interpolate boundary conditions from
-       * \param[in,out] xnew value at end of time step; contains initial guess for first substep on entry
-       * \return selected time step size
-       */
+      //! initial guess for a stage
+      void initializeStage (unsigned r, std::vector<TrlV*>& x, TrlV& xnew, NoInterpolation* f)
+      {
+        if (r==method->s())
+          {
+            // last stage
+            if (r>1) xnew = *(x[r-1]); // if r=1 then xnew has already initial guess
+          }
+        else
+          {
+            if (r>1)
+              *(x[r]) = *(x[r-1]); // use result of last stage as initial guess
+            else
+              *(x[r]) = xnew;
+          }
+      }
+
+      //! initial guess for a stage, setting boundary conditions from f
       template<typename F>
-      T apply (T time, T dt, TrlV& xold, F& f, TrlV& xnew)
+      void initializeStage (unsigned r, std::vector<TrlV*>& x, TrlV& xnew, F* f)
       {
-        // do statistics
-        OneStepMethodPartialResult step_result;
+        igos.interpolate(r,*x[r-1],*f,*x[r]);
+      }
 
-        // save formatting attributes
-        ios_base_all_saver format_attribute_saver(std::cout);
+      //! solve all stages of a step, optionally computing the embedded error estimate
+      template<typename F>
+      void solveStages (T time, T dt, TrlV& xold, F* f, TrlV& xnew,
+                        OneStepMethodPartialResult& step_result, TrlV* err)
+      {
+        prepareStages(xold);
 
         std::vector<TrlV*> x(1); // vector of pointers to all steps
         x[0] = &xold;            // initially we have only one
@@ -1040,66 +1615,108 @@ namespace Dune {
             // prepare stage
             igos.preStage(r,x);
 
-            // get vector for current stage
+            // get vector for current stage, intermediate ones are kept across steps
             if (r==method->s())
-              {
-                // last stage
-                x.push_back(&xnew);
-              }
+              x.push_back(&xnew);
             else
+              x.push_back(stages[r-1].get());
+
+            // set initial value (and boundary conditions)
+            initializeStage(r,x,xnew,f);
+
+            // check whether the matrix of the last solve can be used again
+            bool reuse = false;
+            if (reuse_stage_matrix)
               {
-                // intermediate step
-                x.push_back(new TrlV(igos.trialGridFunctionSpace()));
+                const OneStepJacobianFingerprint<T> fingerprint = igos.jacobianFingerprint(r);
+                reuse = fingerprint == last_fingerprint && xold.N() == last_size;
+                last_fingerprint = fingerprint;
+                last_size = xold.N();
+                if (verbosityLevel>=2 && reuse)
+                  std::cout << "::: reusing stage matrix" << std::endl;
               }
 
-            // set boundary conditions and initial value
-            igos.interpolate(r,*x[r-1],f,*x[r]);
-
             // solve stage
             try {
-              pdesolver.apply(*x[r]);
+              applyPDESolver(pdesolver,*x[r],reuse,0);
             }
             catch (...)
               {
+                discardStageMatrix();
                 // time step failed -> accumulate to total only
-                PDESolverResult pderes = pdesolver.result();
-                step_result.assembler_time += pderes.assembler_time;
-                step_result.linear_solver_time += pderes.linear_solver_time;
-                step_result.linear_solver_iterations += pderes.linear_solver_iterations;
-                step_result.nonlinear_solver_iterations += pderes.iterations;
-                res.total.assembler_time += step_result.assembler_time;
-                res.total.linear_solver_time += step_result.linear_solver_time;
-                res.total.linear_solver_iterations += step_result.linear_solver_iterations;
-                res.total.nonlinear_solver_iterations += step_result.nonlinear_solver_iterations;
+                accumulate(step_result,pdesolver.result());
+                accumulate(res.total,step_result);
                 res.total.timesteps += 1;
                 throw;
               }
-            PDESolverResult pderes = pdesolver.result();
-            step_result.assembler_time += pderes.assembler_time;
-            step_result.linear_solver_time += pderes.linear_solver_time;
-            step_result.linear_solver_iterations += pderes.linear_solver_iterations;
-            step_result.nonlinear_solver_iterations += pderes.iterations;
+            accumulate(step_result,pdesolver.result());
 
             // stage cleanup
             igos.postStage();
           }
 
-        // delete intermediate steps
-        for (unsigned i=1; i<method->s(); ++i) delete x[i];
+        // the embedded error estimate is a combination of all stages
+        if (err)
+          {
+            const EmbeddedTimeSteppingParameterInterface<T>& embedded =
+              dynamic_cast<const EmbeddedTimeSteppingParameterInterface<T>&>(*method);
+            *err = 0.0;
+            for (unsigned i=0; i<=method->s(); ++i)
+              if (embedded.e(i) != 0.0)
+                err->axpy(embedded.e(i),*x[i]);
+          }
 
         // step cleanup
         igos.postStep();
+      }
+
+      //! (re)allocate the intermediate stage vectors if the space or the scheme has changed
+      void prepareStages (const TrlV& xold)
+      {
+        if (!stages.empty() && stages.front()->N() != xold.N())
+          stages.clear();
+        while (stages.size() + 1 < method->s())
+          stages.push_back(std::make_shared<TrlV>(igos.trialGridFunctionSpace()));
+      }
+
+      //! solve a stage, telling the solver about an unchanged matrix if it supports that
+      template<typename S>
+      static auto applyPDESolver (S& solver, TrlV& x, bool reuse, int)
+        -> decltype(solver.apply(x,reuse), void())
+      {
+        solver.apply(x,reuse);
+      }
+
+      template<typename S>
+      static void applyPDESolver (S& solver, TrlV& x, bool reuse, long)
+      {
+        solver.apply(x);
+      }
 
-        // update statistics
-        res.total.assembler_time += step_result.assembler_time;
-        res.total.linear_solver_time += step_result.linear_solver_time;
-        res.total.linear_solver_iterations += step_result.linear_solver_iterations;
-        res.total.nonlinear_solver_iterations += step_result.nonlinear_solver_iterations;
+      //! add the statistics of the PDE solver
+      static void accumulate (OneStepMethodPartialResult& result, const PDESolverResult& pderes)
+      {
+        result.assembler_time += pderes.assembler_time;
+        result.linear_solver_time += pderes.linear_solver_time;
+        result.linear_solver_iterations += pderes.linear_solver_iterations;
+        result.nonlinear_solver_iterations += pderes.iterations;
+      }
+
+      //! add the statistics of a step
+      static void accumulate (OneStepMethodPartialResult& result, const OneStepMethodPartialResult& step_result)
+      {
+        result.assembler_time += step_result.assembler_time;
+        result.linear_solver_time += step_result.linear_solver_time;
+        result.linear_solver_iterations += step_result.linear_solver_iterations;
+        result.nonlinear_solver_iterations += step_result.nonlinear_solver_iterations;
+      }
+
+      //! update statistics for a successful step
+      void acceptStep (const OneStepMethodPartialResult& step_result)
+      {
+        accumulate(res.total,step_result);
         res.total.timesteps += 1;
-        res.successful.assembler_time += step_result.assembler_time;
-        res.successful.linear_solver_time += step_result.linear_solver_time;
-        res.successful.linear_solver_iterations += step_result.linear_solver_iterations;
-        res.successful.nonlinear_solver_iterations += step_result.nonlinear_solver_iterations;
+        accumulate(res.successful,step_result);
         res.successful.timesteps += 1;
         if (verbosityLevel>=1){
           std::ios_base::fmtflags oldflags = std::cout.flags();
@@ -1117,16 +1734,22 @@ namespace Dune {
         }
 
         step++;
-        return dt;
       }
 
-    private:
       const TimeSteppingParameterInterface<T> *method;
       IGOS& igos;
       PDESOLVER& pdesolver;
       int verbosityLevel;
       int step;
       Result res;
+      PITimeController<T>* controller;
+      std::shared_ptr<TrlV> error;
+      std::shared_ptr<TrlV> guess;
+      std::vector<std::shared_ptr<TrlV> > stages;
+      std::shared_ptr<RankVector> owners;
+      bool reuse_stage_matrix;
+      OneStepJacobianFingerprint<T> last_fingerprint;
+      std::size_t last_size;
     };
 
     //! Do one step of an explicit time-stepping scheme
@@ -1158,8 +1781,8 @@ namespace Dune {
        * Use SimpleTimeController that does not control the time step.
        */
       ExplicitOneStepMethod(const TimeSteppingParameterInterface<T>& method_, IGOS& igos_, LS& ls_)
-        : method(&method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1), D(igos),
-          tc(new SimpleTimeController<T>()), allocated(true)
+        : method(&method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1),
+          tc(new SimpleTimeController<T>()), allocated(true), controller(0)
       {
         if (method->implicit())
           DUNE_THROW(Exception,"explicit one step method called with implicit scheme");
@@ -1180,8 +1803,8 @@ namespace Dune {
        * there).
        */
       ExplicitOneStepMethod(const TimeSteppingParameterInterface<T>& method_, IGOS& igos_, LS& ls_, TC& tc_)
-        : method(&method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1), D(igos),
-          tc(&tc_), allocated(false)
+        : method(&method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1),
+          tc(&tc_), allocated(false), controller(0)
       {
         if (method->implicit())
           DUNE_THROW(Exception,"explicit one step method called with implicit scheme");
@@ -1219,6 +1842,46 @@ namespace Dune {
           DUNE_THROW(Exception,"explicit one step method called with implicit scheme");
       }
 
+      //! control the time step by the embedded error estimate of the scheme
+      /**
+       * \param controller_ PI controller, referenced until clearErrorController() is called
+       *
+       * Error control only takes effect for schemes implementing
+       * EmbeddedTimeSteppingParameterInterface, like Shu3Parameter. A step
+       * is repeated with the time step proposed by the controller until it
+       * is accepted. The time step passed to apply() is only used for the
+       * first step, afterwards the controller proposes it. The time step is
+       * still limited by the time controller passed to the constructor,
+       * e.g. a CFLTimeController.
+       */
+      void setErrorController (PITimeController<T>& controller_)
+      {
+        controller = &controller_;
+      }
+
+      //! switch off error control
+      void clearErrorController ()
+      {
+        controller = 0;
+      }
+
+      //! release the matrix and the vectors kept across time steps
+      /**
+       * The diagonal matrix, the residual vectors and the intermediate stage
+       * vectors are allocated in the first step and reused in all following
+       * steps. They are reallocated automatically if the size of the
+       * function space changes, call this method to release them, e.g. after
+       * grid adaptation.
+       */
+      void releaseWorkspace ()
+      {
+        diagonal.reset();
+        alpha_vector.reset();
+        beta_vector.reset();
+        stages.clear();
+        error.reset();
+      }
+
       /*! \brief do one step;
        * \param[in]  time start of time step
        * \param[in]  dt suggested time step size
@@ -1234,6 +1897,55 @@ namespace Dune {
 
       template<typename Limiter>
       T apply (T time, T dt, TrlV& xold, TrlV& xnew, Limiter& limiter)
+      {
+        const EmbeddedTimeSteppingParameterInterface<T>* embedded = 0;
+        if (controller)
+          embedded = dynamic_cast<const EmbeddedTimeSteppingParameterInterface<T>*>(method);
+
+        if (!embedded)
+          {
+            dt = solveStages(time,dt,xold,xnew,limiter,0);
+            step++;
+            return dt;
+          }
+
+        if (!error || error->N() != xold.N())
+          error = std::make_shared<TrlV>(igos.trialGridFunctionSpace());
+        dt = controller->suggestTimestep(time,dt);
+
+        while (true)
+          {
+            dt = solveStages(time,dt,xold,xnew,limiter,error.get());
+
+            // the linear solver backend computes norms on the disjoint DOF partition
+            const T error_norm = ls.norm(*error);
+            const T solution_norm = ls.norm(xnew);
+            const T err = controller->scaledError(error_norm,solution_norm);
+
+            if (controller->acceptStep(dt,err,embedded->embeddedOrder()))
+              break;
+
+            const T newdt = controller->suggestTimestep(time,dt);
+            if (verbosityLevel>=1){
+              ios_base_all_saver format_attribute_saver(std::cout);
+              std::cout << "::: rejected, scaled error "
+                        << std::setw(12) << std::setprecision(4) << std::scientific
+                        << err << ", retry with dt "
+                        << std::setw(12) << std::setprecision(4) << std::scientific
+                        << newdt << std::endl;
+            }
+            dt = newdt;
+          }
+
+        step++;
+        return dt;
+      }
+
+    private:
+
+      //! compute all stages, optionally with the embedded error estimate, and return the time step taken
+      template<typename Limiter>
+      T solveStages (T time, T dt, TrlV& xold, TrlV& xnew, Limiter& limiter, TrlV* err)
       {
         // save formatting attributes
         ios_base_all_saver format_attribute_saver(std::cout);
@@ -1243,12 +1955,15 @@ namespace Dune {
         std::vector<TrlV*> x(1); // vector of pointers to all steps
         x[0] = &xold;         // initially we have only one
         if(verbosityLevel>=4)
-          std::cout << mytag << "Creating residual vectors alpha and beta..."
+          std::cout << mytag << "Preparing residual and stage vectors..."
                     << std::endl;
-        TstV alpha(igos.testGridFunctionSpace()), beta(igos.testGridFunctionSpace()); // split residual vectors
+        prepareWorkspace(xold);
+        M& D = *diagonal;
+        TstV& alpha = *alpha_vector; // split residual vectors
+        TstV& beta = *beta_vector;
         if(verbosityLevel>=4)
           std::cout << mytag
-                    << "Creating residual vectors alpha and beta... done."
+                    << "Preparing residual and stage vectors... done."
                     << std::endl;
 
         if (verbosityLevel>=1){
@@ -1303,8 +2018,8 @@ namespace Dune {
               }
             else
               {
-                // intermediate step
-                x.push_back(new TrlV(igos.trialGridFunctionSpace()));
+                // intermediate step, the vectors are kept across steps
+                x.push_back(stages[r-1].get());
                 if (r>1)
                   *(x[r]) = *(x[r-1]); // use result of last stage as initial guess
                 else
@@ -1392,8 +2107,16 @@ namespace Dune {
               std::cout << stagetag << "Finished." << std::endl;
           }
 
-        // delete intermediate steps
-        for(unsigned i=1; i<method->s(); ++i) delete x[i];
+        // the embedded error estimate is a combination of all stages
+        if (err)
+          {
+            const EmbeddedTimeSteppingParameterInterface<T>& embedded =
+              dynamic_cast<const EmbeddedTimeSteppingParameterInterface<T>&>(*method);
+            *err = 0.0;
+            for (unsigned i=0; i<=method->s(); ++i)
+              if (embedded.e(i) != 0.0)
+                err->axpy(embedded.e(i),*x[i]);
+          }
 
         // step cleanup
         if (verbosityLevel>=4)
@@ -1402,11 +2125,22 @@ namespace Dune {
         if (verbosityLevel>=4)
           std::cout << mytag << "Cleanup... done." << std::endl;
 
-        step++;
         return dt;
       }
 
-    private:
+      //! (re)allocate the matrix, residual and stage vectors if the space or the scheme has changed
+      void prepareWorkspace (const TrlV& xold)
+      {
+        if (!alpha_vector || alpha_vector->N() != xold.N())
+          {
+            diagonal = std::make_shared<M>(igos);
+            alpha_vector = std::make_shared<TstV>(igos.testGridFunctionSpace());
+            beta_vector = std::make_shared<TstV>(igos.testGridFunctionSpace());
+            stages.clear();
+          }
+        while (stages.size() + 1 < method->s())
+          stages.push_back(std::make_shared<TrlV>(igos.trialGridFunctionSpace()));
+      }
 
       //! dummy default limiter
       class DefaultLimiter
@@ -1426,9 +2160,14 @@ namespace Dune {
       LS& ls;
       int verbosityLevel;
       int step;
-      M D;
       TimeControllerInterface<T> *tc;
       bool allocated;
+      PITimeController<T>* controller;
+      std::shared_ptr<TrlV> error;
+      std::shared_ptr<M> diagonal;
+      std::shared_ptr<TstV> alpha_vector;
+      std::shared_ptr<TstV> beta_vector;
+      std::vector<std::shared_ptr<TrlV> > stages;
     };
 
     class FilenameHelper
@@ -0,0 +1,457 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+#ifndef DUNE_PDELAB_LOCALOPERATOR_LOCALTIMESTEPPING_HH
+#define DUNE_PDELAB_LOCALOPERATOR_LOCALTIMESTEPPING_HH
+
+namespace Dune {
+  namespace PDELab {
+    //! \addtogroup LocalOperator
+    //! \ingroup PDELab
+    //! \{
+
+    //! A local operator that restricts another one to the currently active time step level
+    /**
+     * \nosubgrouping
+     *
+     * This local operator wraps the spatial local operator of an explicit
+     * scheme for use with LocalTimeSteppingOneStepMethod.  Before each
+     * evaluation it asks the levels object for the weight of the element
+     * the contribution belongs to: the residual of an element which is not
+     * updated in the current substep gets weight zero, the residual of an
+     * active element on level \f$\ell\f$ is multiplied by \f$2^\ell\f$, the
+     * ratio of its local time step to the finest one.
+     *
+     * Volume and boundary terms of inactive elements are not evaluated at
+     * all.  Skeleton terms are evaluated with the local time step of the
+     * finer of the two elements, and both sides of the result get the same
+     * weight, so LocalTimeSteppingOneStepMethod can collect the fluxes of
+     * the coarse side until its step is complete and the scheme stays
+     * conservative.  As a consequence, the wrapped operator is only
+     * meaningful for discretizations whose degrees of freedom are associated
+     * with a single element, like discontinuous Galerkin and cell centered
+     * finite volume schemes, and it must not assemble the skeleton terms
+     * from both sides.
+     *
+     * Like ScaledLocalOperator, this class does not derive from
+     * LocalOperatorDefaultFlags and forwards all flags of the backend.  The
+     * pattern methods and the instationary methods are forwarded unchanged.
+     *
+     * \tparam Backend Type of the backend operator.
+     * \tparam Levels  Type of the levels object, e.g. LocalTimeSteppingLevels.
+     * \tparam Time    Type of time values.
+     */
+    template<typename Backend, typename Levels, typename Time = double>
+    class LocalTimeSteppingLocalOperator
+    {
+      Backend* bp;
+      const Levels* levels;
+
+      // the assembler only visits a face from one of its elements
+      static_assert(!Backend::doSkeletonTwoSided,
+                    "LocalTimeSteppingLocalOperator requires one-sided skeleton terms");
+
+    public:
+      //! construct a LocalTimeSteppingLocalOperator
+      /**
+       * \param backend Reference to the backend local operator
+       * \param levels_ Time step levels of the elements
+       */
+      LocalTimeSteppingLocalOperator(Backend& backend, const Levels& levels_)
+        : bp(&backend), levels(&levels_) { }
+
+      //! get a reference to the backend
+      Backend& getBackend() const { return *bp; }
+
+      //! get a reference to the levels object
+      const Levels& getLevels() const { return *levels; }
+
+      //////////////////////////////////////////////////////////////////////
+      //
+      //! \name Control flags
+      //! \{
+      //
+
+      enum { doPatternVolume = Backend::doPatternVolume };
+      enum {
+        doPatternVolumePostSkeleton = Backend::doPatternVolumePostSkeleton
+      };
+      enum { doPatternSkeleton = Backend::doPatternSkeleton };
+      enum { doPatternBoundary = Backend::doPatternBoundary };
+
+      enum { doAlphaVolume = Backend::doAlphaVolume };
+      enum { doAlphaVolumePostSkeleton = Backend::doAlphaVolumePostSkeleton };
+      enum { doAlphaSkeleton = Backend::doAlphaSkeleton };
+      enum { doAlphaBoundary = Backend::doAlphaBoundary };
+
+      enum { doLambdaVolume = Backend::doLambdaVolume };
+      enum {
+        doLambdaVolumePostSkeleton = Backend::doLambdaVolumePostSkeleton
+      };
+      enum { doLambdaSkeleton = Backend::doLambdaSkeleton };
+      enum { doLambdaBoundary = Backend::doLambdaBoundary };
+
+      enum { doSkeletonTwoSided = Backend::doSkeletonTwoSided };
+
+      //! \} Control flags
+
+      //////////////////////////////////////////////////////////////////////
+      //
+      //! \name Methods for the sparsity pattern
+      //! \{
+      //
+
+      template<typename LFSU, typename LFSV, typename LocalPattern>
+      void pattern_volume
+      ( const LFSU& lfsu, const LFSV& lfsv,
+        LocalPattern& pattern) const
+      {
+        bp->pattern_volume(lfsu, lfsv, pattern);
+      }
+
+      template<typename LFSU, typename LFSV, typename LocalPattern>
+      void pattern_volume_post_skeleton
+      ( const LFSU& lfsu, const LFSV& lfsv,
+        LocalPattern& pattern) const
+      {
+        bp->pattern_volume_post_skeleton(lfsu, lfsv, pattern);
+      }
+
+      template<typename LFSU, typename LFSV, typename LocalPattern>
+      void pattern_skeleton
+      ( const LFSU& lfsu_s, const LFSV& lfsv_s,
+        const LFSU& lfsu_n, const LFSV& lfsv_n,
+        LocalPattern& pattern_sn,
+        LocalPattern& pattern_ns) const
+      {
+        bp->pattern_skeleton(lfsu_s, lfsv_s, lfsu_n, lfsv_n,
+                             pattern_sn, pattern_ns);
+      }
+
+      template<typename LFSU, typename LFSV, typename LocalPattern>
+      void pattern_boundary
+      ( const LFSU& lfsu_s, const LFSV& lfsv_s,
+        LocalPattern& pattern_ss) const
+      {
+        bp->pattern_boundary(lfsu_s, lfsv_s, pattern_ss);
+      }
+
+      //! \} Methods for the sparsity pattern
+
+      //////////////////////////////////////////////////////////////////////
+      //
+      //! \name Methods for the residual -- non-constant parts
+      //! \{
+      //
+
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename R>
+      void alpha_volume
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        R& r) const
+      {
+        const Time w = levels->weight(eg.entity());
+        if(w != 0) {
+          typename R::WeightedAccumulationView
+            my_r(r.weightedAccumulationView(w));
+          bp->alpha_volume(eg, lfsu, x, lfsv, my_r);
+        }
+      }
+
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename R>
+      void alpha_volume_post_skeleton
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        R& r) const
+      {
+        const Time w = levels->weight(eg.entity());
+        if(w != 0) {
+          typename R::WeightedAccumulationView
+            my_r(r.weightedAccumulationView(w));
+          bp->alpha_volume_post_skeleton(eg, lfsu, x, lfsv, my_r);
+        }
+      }
+
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename R>
+      void alpha_skeleton
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+        R& r_s, R& r_n) const
+      {
+        const Time w = levels->weight(*(ig.inside()),*(ig.outside()));
+        if(w != 0) {
+          typename R::WeightedAccumulationView
+            my_r_s(r_s.weightedAccumulationView(w));
+          typename R::WeightedAccumulationView
+            my_r_n(r_n.weightedAccumulationView(w));
+          bp->alpha_skeleton(ig,
+                             lfsu_s, x_s, lfsv_s,
+                             lfsu_n, x_n, lfsv_n,
+                             my_r_s, my_r_n);
+        }
+      }
+
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename R>
+      void alpha_boundary
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        R& r_s) const
+      {
+        const Time w_s = levels->weight(*(ig.inside()));
+        if(w_s != 0) {
+          typename R::WeightedAccumulationView
+            my_r_s(r_s.weightedAccumulationView(w_s));
+          bp->alpha_boundary(ig, lfsu_s, x_s, lfsv_s, my_r_s);
+        }
+      }
+
+      //! \} Methods for the residual -- non-constant parts
+
+      //////////////////////////////////////////////////////////////////////
+      //
+      //! \name Methods for the residual -- constant parts
+      //! \{
+      //
+
+      template<typename EG, typename LFSV, typename R>
+      void lambda_volume(const EG& eg, const LFSV& lfsv, R& r) const
+      {
+        const Time w = levels->weight(eg.entity());
+        if(w != 0) {
+          typename R::WeightedAccumulationView
+            my_r(r.weightedAccumulationView(w));
+          bp->lambda_volume(eg, lfsv, my_r);
+        }
+      }
+
+      template<typename EG, typename LFSV, typename R>
+      void lambda_volume_post_skeleton(const EG& eg,
+                                       const LFSV& lfsv,
+                                       R& r) const
+      {
+        const Time w = levels->weight(eg.entity());
+        if(w != 0) {
+          typename R::WeightedAccumulationView
+            my_r(r.weightedAccumulationView(w));
+          bp->lambda_volume_post_skeleton(eg, lfsv, my_r);
+        }
+      }
+
+      template<typename IG, typename LFSV, typename R>
+      void lambda_skeleton(const IG& ig,
+                           const LFSV& lfsv_s, const LFSV& lfsv_n,
+                           R& r_s, R& r_n) const
+      {
+        const Time w = levels->weight(*(ig.inside()),*(ig.outside()));
+        if(w != 0) {
+          typename R::WeightedAccumulationView
+            my_r_s(r_s.weightedAccumulationView(w));
+          typename R::WeightedAccumulationView
+            my_r_n(r_n.weightedAccumulationView(w));
+          bp->lambda_skeleton(ig, lfsv_s, lfsv_n, my_r_s, my_r_n);
+        }
+      }
+
+      template<typename IG, typename LFSV, typename R>
+      void lambda_boundary(const IG& ig, const LFSV& lfsv_s, R& r_s) const
+      {
+        const Time w_s = levels->weight(*(ig.inside()));
+        if(w_s != 0) {
+          typename R::WeightedAccumulationView
+            my_r_s(r_s.weightedAccumulationView(w_s));
+          bp->lambda_boundary(ig, lfsv_s, my_r_s);
+        }
+      }
+
+      //! \} Methods for the residual -- constant parts
+
+      //////////////////////////////////////////////////////////////////////
+      //
+      //! \name Methods for the application of the jacobian
+      //! \{
+      //
+
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename Y>
+      void jacobian_apply_volume
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        Y& y) const
+      {
+        const Time w = levels->weight(eg.entity());
+        if(w != 0) {
+          typename Y::WeightedAccumulationView
+            my_y(y.weightedAccumulationView(w));
+          bp->jacobian_apply_volume(eg, lfsu, x, lfsv, my_y);
+        }
+      }
+
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename Y>
+      void jacobian_apply_volume_post_skeleton
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        Y& y) const
+      {
+        const Time w = levels->weight(eg.entity());
+        if(w != 0) {
+          typename Y::WeightedAccumulationView
+            my_y(y.weightedAccumulationView(w));
+          bp->jacobian_apply_volume_post_skeleton(eg, lfsu, x, lfsv, my_y);
+        }
+      }
+
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename Y>
+      void jacobian_apply_skeleton
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+        Y& y_s, Y& y_n) const
+      {
+        const Time w = levels->weight(*(ig.inside()),*(ig.outside()));
+        if(w != 0) {
+          typename Y::WeightedAccumulationView
+            my_y_s(y_s.weightedAccumulationView(w));
+          typename Y::WeightedAccumulationView
+            my_y_n(y_n.weightedAccumulationView(w));
+          bp->jacobian_apply_skeleton(ig,
+                                      lfsu_s, x_s, lfsv_s,
+                                      lfsu_n, x_n, lfsv_n,
+                                      my_y_s, my_y_n);
+        }
+      }
+
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename Y>
+      void jacobian_apply_boundary
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        Y& y_s) const
+      {
+        const Time w_s = levels->weight(*(ig.inside()));
+        if(w_s != 0) {
+          typename Y::WeightedAccumulationView
+            my_y_s(y_s.weightedAccumulationView(w_s));
+          bp->jacobian_apply_boundary(ig, lfsu_s, x_s, lfsv_s, my_y_s);
+        }
+      }
+
+      //! \} Methods for the application of the jacobian
+
+      //////////////////////////////////////////////////////////////////////
+      //
+      //! \name Methods to extract the jacobian
+      //! \{
+      //
+
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename M>
+      void jacobian_volume
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        M& mat) const
+      {
+        const Time w = levels->weight(eg.entity());
+        if(w != 0) {
+          typename M::WeightedAccumulationView
+            my_mat(mat.weightedAccumulationView(w));
+          bp->jacobian_volume(eg, lfsu, x, lfsv, my_mat);
+        }
+      }
+
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename M>
+      void jacobian_volume_post_skeleton
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        M& mat) const
+      {
+        const Time w = levels->weight(eg.entity());
+        if(w != 0) {
+          typename M::WeightedAccumulationView
+            my_mat(mat.weightedAccumulationView(w));
+          bp->jacobian_volume_post_skeleton(eg, lfsu, x, lfsv, my_mat);
+        }
+      }
+
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename M>
+      void jacobian_skeleton
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+        M& mat_ss, M& mat_sn, M& mat_ns, M& mat_nn) const
+      {
+        const Time w = levels->weight(*(ig.inside()),*(ig.outside()));
+        if(w != 0) {
+          typename M::WeightedAccumulationView
+            my_mat_ss(mat_ss.weightedAccumulationView(w));
+          typename M::WeightedAccumulationView
+            my_mat_sn(mat_sn.weightedAccumulationView(w));
+          typename M::WeightedAccumulationView
+            my_mat_ns(mat_ns.weightedAccumulationView(w));
+          typename M::WeightedAccumulationView
+            my_mat_nn(mat_nn.weightedAccumulationView(w));
+          bp->jacobian_skeleton(ig,
+                                lfsu_s, x_s, lfsv_s,
+                                lfsu_n, x_n, lfsv_n,
+                                my_mat_ss, my_mat_sn, my_mat_ns, my_mat_nn);
+        }
+      }
+
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename M>
+      void jacobian_boundary
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        M& mat_ss) const
+      {
+        const Time w_s = levels->weight(*(ig.inside()));
+        if(w_s != 0) {
+          typename M::WeightedAccumulationView
+            my_mat_ss(mat_ss.weightedAccumulationView(w_s));
+          bp->jacobian_boundary(ig, lfsu_s, x_s, lfsv_s, my_mat_ss);
+        }
+      }
+
+      //! \} Methods to extract the jacobian
+
+      ////////////////////////////////////////////////////////////////////////
+      //
+      //! \name Methods for temporal local operators
+      //! \{
+
+      typedef Time RealType;
+
+      void setTime (Time t) { bp->setTime(t); }
+
+      Time getTime () const { return bp->getTime(); }
+
+      void preStep (Time time, Time dt, int stages)
+      { bp->preStep(time, dt, stages); }
+
+      void postStep () { bp->postStep(); }
+
+      void preStage (Time time, int r) { bp->preStage(time, r); }
+
+      int getStage () const { return bp->getStage(); }
+
+      void postStage () { bp->postStage(); }
+
+      Time suggestTimestep (Time dt) const
+      { return bp->suggestTimestep(dt); }
+
+      //! \} Methods for temporal local operators
+
+    };
+
+    //! \} group LocalOperator
+  }
+}
+
+#endif // DUNE_PDELAB_LOCALOPERATOR_LOCALTIMESTEPPING_HH
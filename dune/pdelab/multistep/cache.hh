@@ -5,6 +5,7 @@
 #define DUNE_PDELAB_MULTISTEP_CACHE_HH
 
 #include <cstddef>
+#include <list>
 #include <map>
 #include <memory>
 #include <utility>
@@ -27,6 +28,37 @@ namespace Dune {
     //! Exception thrown when a stored item is already in the cache
     class AlreadyInCache : public CacheError {};
 
+    //! The kinds of items stored in the MultiStepCache
+    struct MultiStepCacheItem {
+      enum Kind {
+        residualValue,    //!< residual value \f$r_j(t_n,u_n)\f$
+        jacobian,         //!< Jacobian of an operator \f$J(r_j|_{t_n})\f$
+        zeroResidual,     //!< zero-residual \f$r_j(t_n,0)\f$
+        composedJacobian, //!< Jacobian of the composed system
+        unknowns          //!< vector of unknowns \f$u_n\f$
+      };
+    };
+
+    //! Approximate memory footprint of a container stored in the MultiStepCache
+    /**
+     * The memory bounded cache policies need the size of the stored vectors
+     * and matrices. Backends provide an overload of this function for their
+     * containers next to their definition, it is found by argument dependent
+     * lookup. The cache only calls it for policies that account for memory
+     * (see MultiStepCachePolicy::accountsMemory()), so containers without
+     * such an overload, e.g. the PETSc ones, work with all other policies.
+     *
+     * \throw CacheError always, this fallback is only used for containers
+     *                   without an overload.
+     */
+    template<class T>
+    std::size_t multiStepCacheBytes(const T& t)
+    {
+      DUNE_THROW(CacheError, "The MultiStepCache cannot determine the memory "
+                 "footprint of this container, provide an overload of "
+                 "multiStepCacheBytes() for it");
+    }
+
     //! Policy class for the MultiStepCache
     /**
      * \tparam Step Type used for step number.  May be signed or unsigned
@@ -186,6 +218,198 @@ namespace Dune {
       //! determine whether a composed Jacobian can be removed
       virtual bool canEvictComposedJacobian(Step step) const
       { return step + stepsOfScheme < currentStep; }
+
+      //! \}
+
+      //! \name methods for memory accounting
+      //! \{
+
+      //! whether itemStored() needs the memory footprint of the items
+      /**
+       * Returns \c false by default, in which case the cache passes 0 bytes
+       * and never calls multiStepCacheBytes().
+       */
+      virtual bool accountsMemory() const
+      { return false; }
+      //! called whenever an item has been stored in the cache
+      /**
+       * \param kind    Kind of the item.
+       * \param order   Temporal order of the operator the item belongs to
+       *                (0 for composed Jacobians and unknowns).
+       * \param step    Step of the item.
+       * \param storage Identifies the stored container.  Items that reuse a
+       *                value of another step share the same storage.
+       * \param bytes   Approximate memory footprint of the container, 0
+       *                unless accountsMemory() returns \c true.
+       *
+       * Does nothing by default.
+       */
+      virtual void itemStored(MultiStepCacheItem::Kind kind,
+                              std::size_t order, Step step,
+                              const void* storage, std::size_t bytes)
+      { }
+      //! called whenever an item has been extracted from the cache
+      /** does nothing by default. */
+      virtual void itemAccessed(MultiStepCacheItem::Kind kind,
+                                std::size_t order, Step step)
+      { }
+      //! called whenever an item has been removed from the cache
+      /** does nothing by default. */
+      virtual void itemEvicted(MultiStepCacheItem::Kind kind,
+                               std::size_t order, Step step)
+      { }
+      //! select an item to evict in addition to the stale items
+      /**
+       * The cache calls this method after storing an item and evicts the
+       * selected items until it returns \c false.  Every returned item must
+       * have been announced by itemStored() and not yet been evicted.
+       *
+       * Returns \c false by default.
+       */
+      virtual bool selectVictim(MultiStepCacheItem::Kind& kind,
+                                std::size_t& order, Step& step) const
+      { return false; }
+
+      //! \}
+    };
+
+    //! MultiStepCachePolicy that keeps the cache within a memory budget
+    /**
+     * \tparam Step Type used for step number.
+     * \tparam Time Type used for temporal values.
+     *
+     * In addition to the step based eviction of MultiStepCachePolicy, this
+     * policy tracks the approximate memory footprint of all items in the
+     * cache.  Whenever the footprint exceeds the budget, the least recently
+     * used items are evicted.  Items sharing the same storage are only
+     * accounted once, and the vectors of unknowns are accounted but never
+     * evicted, since they are no cached values.
+     *
+     * The decisions what to cache and which items to reuse are inherited
+     * from MultiStepCachePolicy, derive from this class to change them.
+     *
+     * The footprint is computed by multiStepCacheBytes(), so this policy can
+     * only be used with containers that provide an overload of it.
+     */
+    template<class Step = int, class Time = double>
+    class MemoryBoundedMultiStepCachePolicy :
+      public MultiStepCachePolicy<Step, Time>
+    {
+      typedef MultiStepCacheItem::Kind Kind;
+
+      struct Key {
+        Kind kind;
+        std::size_t order;
+        Step step;
+
+        bool operator<(const Key& other) const
+        {
+          if(kind != other.kind) return kind < other.kind;
+          if(order != other.order) return order < other.order;
+          return step < other.step;
+        }
+      };
+
+      struct Entry {
+        Key key;
+        const void* storage;
+      };
+
+      typedef std::list<Entry> LRUList;
+      typedef std::map<Key, typename LRUList::iterator> EntryMap;
+      // storage -> (bytes, number of items sharing it)
+      typedef std::map<const void*, std::pair<std::size_t, std::size_t> >
+      StorageMap;
+
+      std::size_t budgetBytes;
+      std::size_t usedBytes;
+      // most recently used items first
+      LRUList lru;
+      EntryMap entries;
+      StorageMap storages;
+
+      void remove(typename EntryMap::iterator it)
+      {
+        typename StorageMap::iterator sit =
+          storages.find(it->second->storage);
+        if(sit != storages.end() && --sit->second.second == 0) {
+          usedBytes -= sit->second.first;
+          storages.erase(sit);
+        }
+        lru.erase(it->second);
+        entries.erase(it);
+      }
+
+    public:
+      //! construct a policy object
+      /**
+       * \param budget_ Memory budget of the cache in bytes.
+       */
+      explicit MemoryBoundedMultiStepCachePolicy(std::size_t budget_) :
+        budgetBytes(budget_), usedBytes(0)
+      { }
+
+      //! the memory budget in bytes
+      std::size_t budget() const { return budgetBytes; }
+      //! change the memory budget, effective when the next item is stored
+      void setBudget(std::size_t budget_) { budgetBytes = budget_; }
+      //! the approximate memory footprint of all items in the cache
+      std::size_t bytesUsed() const { return usedBytes; }
+
+      virtual bool accountsMemory() const
+      { return true; }
+
+      virtual void itemStored(Kind kind, std::size_t order, Step step,
+                              const void* storage, std::size_t bytes)
+      {
+        const Key key = { kind, order, step };
+        typename EntryMap::iterator it = entries.find(key);
+        if(it != entries.end())
+          remove(it);
+
+        const Entry entry = { key, storage };
+        lru.push_front(entry);
+        entries.insert(std::make_pair(key, lru.begin()));
+
+        std::pair<std::size_t, std::size_t>& s = storages[storage];
+        if(s.second++ == 0) {
+          s.first = bytes;
+          usedBytes += bytes;
+        }
+      }
+
+      virtual void itemAccessed(Kind kind, std::size_t order, Step step)
+      {
+        const Key key = { kind, order, step };
+        typename EntryMap::iterator it = entries.find(key);
+        if(it != entries.end())
+          lru.splice(lru.begin(), lru, it->second);
+      }
+
+      virtual void itemEvicted(Kind kind, std::size_t order, Step step)
+      {
+        const Key key = { kind, order, step };
+        typename EntryMap::iterator it = entries.find(key);
+        if(it != entries.end())
+          remove(it);
+      }
+
+      //! select the least recently used item that is not a vector of unknowns
+      virtual bool selectVictim(Kind& kind, std::size_t& order,
+                                Step& step) const
+      {
+        if(usedBytes <= budgetBytes)
+          return false;
+        for(typename LRUList::const_reverse_iterator it = lru.rbegin();
+            it != lru.rend(); ++it)
+          if(it->key.kind != MultiStepCacheItem::unknowns) {
+            kind = it->key.kind;
+            order = it->key.order;
+            step = it->key.step;
+            return true;
+          }
+        return false;
+      }
     };
 
     //! Cache for the CachedMultiStepGridOperatorSpace
@@ -225,6 +449,16 @@ namespace Dune {
      * prepared to recompute a value that cannot be extracted from the cache,
      * and should try to store that value in the cache afterwards.
      *
+     * The policy is notified about every stored, extracted and evicted item,
+     * which allows policies like MemoryBoundedMultiStepCachePolicy to account
+     * for the memory footprint of the cache and to evict items beyond the
+     * stale ones.
+     *
+     * Vectors of unknowns obtained from makeUnknowns() are kept in a pool of
+     * limited size (see setPoolCapacity()) when they are evicted and nobody
+     * else references them anymore, and makeUnknowns() hands them out again
+     * instead of allocating new vectors.
+     *
      * \note The cache keeps pointers to the values it stores.  The user code
      *       must make sure that any value stored in the cache is not later
      *       modified, any such modification results in undefined behaviour.
@@ -235,12 +469,38 @@ namespace Dune {
       typedef MultiStepCachePolicy<Step, Time> Policy;
 
     private:
+      typedef MultiStepCacheItem Item;
+
+      // adapters for the canEvict*() methods of the policy
+      struct CanEvict {
+        typedef bool (Policy::*Method)(std::size_t, Step) const;
+        const Policy& policy;
+        Method method;
+        CanEvict(const Policy& policy_, Method method_) :
+          policy(policy_), method(method_)
+        { }
+        bool operator()(std::size_t order, Step step) const
+        { return (policy.*method)(order, step); }
+      };
+      struct CanEvictStep {
+        typedef bool (Policy::*Method)(Step) const;
+        const Policy& policy;
+        Method method;
+        CanEvictStep(const Policy& policy_, Method method_) :
+          policy(policy_), method(method_)
+        { }
+        bool operator()(std::size_t order, Step step) const
+        { return (policy.*method)(step); }
+      };
+
       typedef std::map<Step, std::shared_ptr<const Matrix> > MatrixMap;
       typedef typename MatrixMap::const_iterator MatrixIterator;
+      typedef typename MatrixMap::iterator MatrixMapIterator;
       typedef std::map<Step, std::shared_ptr<const VectorV> > ResidualMap;
       typedef typename ResidualMap::const_iterator ResidualIterator;
       typedef std::map<Step, std::shared_ptr<const VectorU> > UnknownMap;
       typedef typename UnknownMap::const_iterator UnknownIterator;
+      typedef typename UnknownMap::iterator UnknownMapIterator;
 
       // non-linear caching across time steps
       std::vector<ResidualMap> residualValues;
@@ -258,6 +518,143 @@ namespace Dune {
       // policy object
       std::shared_ptr<Policy> policy;
 
+      // vectors of unknowns handed out by makeUnknowns() that are still
+      // alive, and evicted ones kept for recycling
+      std::vector<std::weak_ptr<VectorU> > issuedUnknowns;
+      std::vector<std::shared_ptr<VectorU> > unknownPool;
+      std::size_t poolCapacity;
+
+      template<class T>
+      void stored(Item::Kind kind, std::size_t order, Step step,
+                  const std::shared_ptr<const T>& item) const
+      {
+        const std::size_t bytes =
+          item && policy->accountsMemory() ? multiStepCacheBytes(*item) : 0;
+        policy->itemStored(kind, order, step, item.get(), bytes);
+      }
+
+      // the mutable handle of a vector handed out by makeUnknowns()
+      std::shared_ptr<VectorU> issued(const VectorU* v)
+      {
+        for(std::size_t i = 0; i < issuedUnknowns.size(); ++i) {
+          std::shared_ptr<VectorU> u = issuedUnknowns[i].lock();
+          if(u.get() == v)
+            return u;
+        }
+        return std::shared_ptr<VectorU>();
+      }
+
+      template<class Map>
+      void evictFrom(Map& map, typename Map::iterator it, Item::Kind kind,
+                     std::size_t order)
+      {
+        const Step step = it->first;
+        map.erase(it);
+        policy->itemEvicted(kind, order, step);
+      }
+
+      template<class Map>
+      void evictFromOrder(std::vector<Map>& maps, Item::Kind kind,
+                          std::size_t order, Step step)
+      {
+        if(order < maps.size()) {
+          typename Map::iterator it = maps[order].find(step);
+          if(it != maps[order].end()) {
+            evictFrom(maps[order], it, kind, order);
+            return;
+          }
+        }
+        policy->itemEvicted(kind, order, step);
+      }
+
+      // remove a vector of unknowns and keep its storage if it was created
+      // by makeUnknowns() and nobody else references it
+      void evictUnknowns(UnknownMapIterator it)
+      {
+        std::shared_ptr<VectorU> storage = issued(it->second.get());
+        evictFrom(unknowns, it, Item::unknowns, 0);
+        if(storage && storage.use_count() == 1 &&
+           unknownPool.size() < poolCapacity)
+          unknownPool.push_back(storage);
+      }
+
+      // remove a single item selected by the policy
+      void evict(Item::Kind kind, std::size_t order, Step step)
+      {
+        switch(kind) {
+        case Item::residualValue:
+          evictFromOrder(residualValues, kind, order, step);
+          return;
+        case Item::jacobian:
+          evictFromOrder(jacobians, kind, order, step);
+          return;
+        case Item::zeroResidual:
+          evictFromOrder(zeroResiduals, kind, order, step);
+          return;
+        case Item::composedJacobian: {
+          MatrixMapIterator it = composedJacobians.find(step);
+          if(it != composedJacobians.end())
+            evictFrom(composedJacobians, it, kind, 0);
+          else
+            policy->itemEvicted(kind, order, step);
+          return;
+        }
+        case Item::unknowns: {
+          UnknownMapIterator it = unknowns.find(step);
+          if(it != unknowns.end())
+            evictUnknowns(it);
+          else
+            policy->itemEvicted(kind, order, step);
+          return;
+        }
+        }
+      }
+
+      // evict items until the policy is satisfied
+      void enforcePolicy()
+      {
+        Item::Kind kind;
+        std::size_t order;
+        Step step;
+        while(policy->selectVictim(kind, order, step))
+          evict(kind, order, step);
+      }
+
+      // evict all items of a map the policy considers stale
+      template<class Map, class CanEvict>
+      void evictStale(Map& map, Item::Kind kind, std::size_t order,
+                      const CanEvict& canEvict)
+      {
+        typename Map::iterator it = map.begin();
+        while(it != map.end())
+          if(canEvict(order, it->first))
+            evictFrom(map, it++, kind, order);
+          else
+            ++it;
+      }
+
+      // announce all items to the current policy
+      void announceAll() const
+      {
+        for(std::size_t order = 0; order < residualValues.size(); ++order)
+          for(ResidualIterator it = residualValues[order].begin();
+              it != residualValues[order].end(); ++it)
+            stored(Item::residualValue, order, it->first, it->second);
+        for(std::size_t order = 0; order < jacobians.size(); ++order)
+          for(MatrixIterator it = jacobians[order].begin();
+              it != jacobians[order].end(); ++it)
+            stored(Item::jacobian, order, it->first, it->second);
+        for(std::size_t order = 0; order < zeroResiduals.size(); ++order)
+          for(ResidualIterator it = zeroResiduals[order].begin();
+              it != zeroResiduals[order].end(); ++it)
+            stored(Item::zeroResidual, order, it->first, it->second);
+        for(MatrixIterator it = composedJacobians.begin();
+            it != composedJacobians.end(); ++it)
+          stored(Item::composedJacobian, 0, it->first, it->second);
+        for(UnknownIterator it = unknowns.begin(); it != unknowns.end(); ++it)
+          stored(Item::unknowns, 0, it->first, it->second);
+      }
+
     public:
 
       //! \name construction and policy management
@@ -265,7 +662,7 @@ namespace Dune {
 
       MultiStepCache(const std::shared_ptr<Policy> &policy_ =
                            std::shared_ptr<Policy>(new Policy)) :
-        policy(policy_)
+        policy(policy_), poolCapacity(2)
       {
         if(!policy)
           DUNE_THROW(CacheError,
@@ -282,6 +679,55 @@ namespace Dune {
           DUNE_THROW(CacheError, "MultiStepCache::setPolicy(): attempt to set "
                      "policy == NULL");
         policy = policy_;
+        announceAll();
+        enforcePolicy();
+      }
+
+      //! \}
+
+      //! \name recycling of container storage
+      //! \{
+
+      //! maximum number of vectors of unknowns kept for recycling
+      std::size_t getPoolCapacity() const
+      { return poolCapacity; }
+      //! change the maximum number of vectors kept for recycling
+      void setPoolCapacity(std::size_t capacity)
+      {
+        poolCapacity = capacity;
+        if(unknownPool.size() > capacity) unknownPool.resize(capacity);
+      }
+      //! number of vectors of unknowns currently kept for recycling
+      std::size_t pooledUnknowns() const
+      { return unknownPool.size(); }
+
+      //! get a vector of unknowns, recycled from an evicted one if possible
+      /**
+       * \param gfs The trial grid function space, used to construct a new
+       *            vector if no storage is available for recycling.
+       *
+       * The content of a recycled vector is unspecified.  Only vectors
+       * obtained from this method are recycled when they are evicted.
+       */
+      template<class GFS>
+      std::shared_ptr<VectorU> makeUnknowns(const GFS& gfs)
+      {
+        // forget vectors that have been released by everybody
+        std::size_t live = 0;
+        for(std::size_t i = 0; i < issuedUnknowns.size(); ++i)
+          if(!issuedUnknowns[i].expired())
+            issuedUnknowns[live++] = issuedUnknowns[i];
+        issuedUnknowns.resize(live);
+
+        std::shared_ptr<VectorU> v;
+        if(unknownPool.empty())
+          v = std::make_shared<VectorU>(gfs);
+        else {
+          v = unknownPool.back();
+          unknownPool.pop_back();
+        }
+        issuedUnknowns.push_back(v);
+        return v;
       }
 
       //! \}
@@ -306,8 +752,10 @@ namespace Dune {
       getResidualValue(std::size_t order, Step step) const {
         if(order < residualValues.size()) {
           ResidualIterator it = residualValues[order].find(step);
-          if(it != residualValues[order].end())
+          if(it != residualValues[order].end()) {
+            policy->itemAccessed(Item::residualValue, order, step);
             return it->second;
+          }
         }
         DUNE_THROW(NotInCache, "MultiStepCache::getResidualValue(): The "
                    "requested residual value "
@@ -336,6 +784,8 @@ namespace Dune {
           DUNE_THROW(AlreadyInCache, "Residual value"
                      "r_" << order << "(t_" << step << ", u_" << step << ") "
                      "is already in the cache!");
+        stored(Item::residualValue, order, step, residualValue);
+        enforcePolicy();
       }
 
       //! \}
@@ -362,14 +812,21 @@ namespace Dune {
         if(order < jacobians.size()) {
           MatrixIterator it = jacobians[order].find(step);
           const MatrixIterator &end = jacobians[order].end();
-          if(it != end)
+          if(it != end) {
+            policy->itemAccessed(Item::jacobian, order, step);
             return it->second;
+          }
 
           // try to copy from another step
           for(it = jacobians[order].begin(); it != end; ++it)
-            if(policy->canReuseJacobian(order, step, it->first))
+            if(policy->canReuseJacobian(order, step, it->first)) {
               // assign and return value
-              return jacobians[order][step] = it->second;
+              std::shared_ptr<const Matrix> jacobian =
+                jacobians[order][step] = it->second;
+              policy->itemAccessed(Item::jacobian, order, it->first);
+              stored(Item::jacobian, order, step, jacobian);
+              return jacobian;
+            }
         }
         DUNE_THROW(NotInCache, "MultiStepCache::getJacobian(): The requested "
                    "Jacobian J(r_" << order << "|_t_" << step << ") is not in "
@@ -396,6 +853,8 @@ namespace Dune {
           DUNE_THROW(AlreadyInCache, "MultiStepCache::setJacobian(): Jacobian "
                      "J(r_" << order << "|_t_" << step << ") is already in "
                      "the cache!");
+        stored(Item::jacobian, order, step, jacobian);
+        enforcePolicy();
       }
 
       //! \}
@@ -418,18 +877,25 @@ namespace Dune {
        *       method only works on the mutable cache.
        */
       std::shared_ptr<const VectorV>
-      getZeroResidual(std::size_t order, Step step) const {
+      getZeroResidual(std::size_t order, Step step) {
         if(order < zeroResiduals.size()) {
           ResidualIterator it = zeroResiduals[order].find(step);
           const ResidualIterator &end = zeroResiduals[order].end();
-          if(it != end)
+          if(it != end) {
+            policy->itemAccessed(Item::zeroResidual, order, step);
             return it->second;
+          }
 
           // try to copy from another step
           for(it = zeroResiduals[order].begin(); it != end; ++it)
-            if(policy->canReuseZeroResidual(order, step, it->first))
+            if(policy->canReuseZeroResidual(order, step, it->first)) {
               // assign and return value
-              return zeroResiduals[order][step] = it->second;
+              std::shared_ptr<const VectorV> zeroResidual =
+                zeroResiduals[order][step] = it->second;
+              policy->itemAccessed(Item::zeroResidual, order, it->first);
+              stored(Item::zeroResidual, order, step, zeroResidual);
+              return zeroResidual;
+            }
         }
         DUNE_THROW(NotInCache, "MultiStepCache::getZeroResidual(): The "
                    "requested zero-residual "
@@ -458,6 +924,8 @@ namespace Dune {
           DUNE_THROW(AlreadyInCache, "Zero-residual "
                      "r_" << order << "(t_" << step << ", 0) is already in "
                      "the cache!");
+        stored(Item::zeroResidual, order, step, zeroResidual);
+        enforcePolicy();
       }
 
       //! \}
@@ -482,14 +950,21 @@ namespace Dune {
       getComposedJacobian(Step step) {
         MatrixIterator it = composedJacobians.find(step);
         const MatrixIterator &end = composedJacobians.end();
-        if(it != end)
+        if(it != end) {
+          policy->itemAccessed(Item::composedJacobian, 0, step);
           return it->second;
+        }
 
         // try to copy from another step
         for(it = composedJacobians.begin(); it != end; ++it)
-          if(policy->canReuseComposedJacobian(step, it->first))
+          if(policy->canReuseComposedJacobian(step, it->first)) {
             // assign and return value
-            return composedJacobians[step] = it->second;
+            std::shared_ptr<const Matrix> jacobian =
+              composedJacobians[step] = it->second;
+            policy->itemAccessed(Item::composedJacobian, 0, it->first);
+            stored(Item::composedJacobian, 0, step, jacobian);
+            return jacobian;
+          }
 
         DUNE_THROW(NotInCache, "MultiStepCache::getComposedJacobian(): The "
                    "requested composed Jacobian for step " << step << " is "
@@ -512,6 +987,8 @@ namespace Dune {
           DUNE_THROW(AlreadyInCache, "MultiStepCache::setComposedJacobian(): "
                      "Composed Jacobian for time step " << step << " is "
                      "already in the cache!");
+        stored(Item::composedJacobian, 0, step, jacobian);
+        enforcePolicy();
       }
 
       //! \}
@@ -531,8 +1008,10 @@ namespace Dune {
       std::shared_ptr<const VectorU>
       getUnknowns(Step step) const {
         UnknownIterator it = unknowns.find(step);
-        if(it != unknowns.end())
+        if(it != unknowns.end()) {
+          policy->itemAccessed(Item::unknowns, 0, step);
           return it->second;
+        }
         DUNE_THROW(NotInCache, "Unknowns u_" << step << " missing in the "
                    "cache!");
       }
@@ -549,6 +1028,8 @@ namespace Dune {
           DUNE_THROW(AlreadyInCache, "Unknowns u_" << step << " are already "
                      "in the cache!");
         unknowns[step] = unknowns_;
+        stored(Item::unknowns, 0, step, unknowns_);
+        enforcePolicy();
       }
 
       //! \}
@@ -559,14 +1040,36 @@ namespace Dune {
       //! Flush all cached values
       /**
        * This is useful for instance after adaption.  It is equivalent to
-       * recreating the cache.
+       * recreating the cache, in particular the vectors kept for recycling
+       * are released as well.
        */
       void flushAll() {
+        for(std::size_t order = 0; order < residualValues.size(); ++order)
+          for(ResidualIterator it = residualValues[order].begin();
+              it != residualValues[order].end(); ++it)
+            policy->itemEvicted(Item::residualValue, order, it->first);
+        for(std::size_t order = 0; order < jacobians.size(); ++order)
+          for(MatrixIterator it = jacobians[order].begin();
+              it != jacobians[order].end(); ++it)
+            policy->itemEvicted(Item::jacobian, order, it->first);
+        for(std::size_t order = 0; order < zeroResiduals.size(); ++order)
+          for(ResidualIterator it = zeroResiduals[order].begin();
+              it != zeroResiduals[order].end(); ++it)
+            policy->itemEvicted(Item::zeroResidual, order, it->first);
+        for(MatrixIterator it = composedJacobians.begin();
+            it != composedJacobians.end(); ++it)
+          policy->itemEvicted(Item::composedJacobian, 0, it->first);
+        for(UnknownIterator it = unknowns.begin(); it != unknowns.end(); ++it)
+          policy->itemEvicted(Item::unknowns, 0, it->first);
+
         residualValues.clear();
         jacobians.clear();
         zeroResiduals.clear();
         composedJacobians.clear();
         unknowns.clear();
+
+        issuedUnknowns.clear();
+        unknownPool.clear();
       }
 
       //! \}
@@ -594,59 +1097,32 @@ namespace Dune {
         policy->preStep(step, stepsOfScheme, endTime, dt);
 
         // residual values
-        for(std::size_t order = 0; order < residualValues.size(); ++order) {
-          const ResidualIterator end = residualValues[order].end();
-          ResidualIterator it = residualValues[order].begin();
-          while(it != end)
-            if(policy->canEvictResidualValue(order, it->first))
-              residualValues[order].erase(it++);
-            else
-              ++it;
-        }
+        for(std::size_t order = 0; order < residualValues.size(); ++order)
+          evictStale(residualValues[order], Item::residualValue, order,
+                     CanEvict(*policy, &Policy::canEvictResidualValue));
 
         // Jacobians
-        for(std::size_t order = 0; order < jacobians.size(); ++order) {
-          const MatrixIterator end = jacobians[order].end();
-          MatrixIterator it = jacobians[order].begin();
-          while(it != end)
-            if(policy->canEvictJacobian(order, it->first))
-              jacobians[order].erase(it++);
-            else
-              ++it;
-        }
+        for(std::size_t order = 0; order < jacobians.size(); ++order)
+          evictStale(jacobians[order], Item::jacobian, order,
+                     CanEvict(*policy, &Policy::canEvictJacobian));
 
         // zero-residual
-        for(std::size_t order = 0; order < zeroResiduals.size(); ++order) {
-          const ResidualIterator end = zeroResiduals[order].end();
-          ResidualIterator it = zeroResiduals[order].begin();
-          while(it != end)
-            if(policy->canEvictZeroResidual(order, it->first))
-              zeroResiduals[order].erase(it++);
-            else
-              ++it;
-        }
+        for(std::size_t order = 0; order < zeroResiduals.size(); ++order)
+          evictStale(zeroResiduals[order], Item::zeroResidual, order,
+                     CanEvict(*policy, &Policy::canEvictZeroResidual));
 
         // composed Jacobians
-        {
-          const MatrixIterator end = composedJacobians.end();
-          MatrixIterator it = composedJacobians.begin();
-          while(it != end)
-            if(policy->canEvictComposedJacobian(it->first))
-              composedJacobians.erase(it++);
-            else
-              ++it;
-        }
+        evictStale(composedJacobians, Item::composedJacobian, 0,
+                   CanEvictStep(*policy, &Policy::canEvictComposedJacobian));
 
         // unknowns
-        {
-          const UnknownIterator end = unknowns.end();
-          UnknownIterator it = unknowns.begin();
-          while(it != end)
-            if(policy->canEvictUnknowns(it->first))
-              unknowns.erase(it++);
-            else
-              ++it;
-        }
+        for(UnknownMapIterator it = unknowns.begin(); it != unknowns.end(); )
+          if(policy->canEvictUnknowns(it->first))
+            evictUnknowns(it++);
+          else
+            ++it;
+
+        enforcePolicy();
       }
 
       //! Do some housekeeping after computing a time-step
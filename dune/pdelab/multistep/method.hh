@@ -239,7 +239,9 @@ namespace Dune {
        * \return A shared_ptr to the new value
        *
        * The old values are expected in the cache of the GridOperatorSpace.
-       * The computed value is store in the cache as well.
+       * The computed value is store in the cache as well.  The vector for
+       * the new value is obtained from MultiStepCache::makeUnknowns(), which
+       * recycles the storage of evicted vectors of unknowns.
        */
       std::shared_ptr<const TrialV> apply(T time, T dt)
       {
@@ -278,8 +280,10 @@ namespace Dune {
           std::cout << "== setup result vector" << std::endl;
           subTimer.reset();
         }
-        std::shared_ptr<TrialV>
-          xnew(new TrialV(*mgos.getCache()->getUnknowns(step-1)));
+        // storage of evicted vectors is recycled by the cache
+        std::shared_ptr<TrialV> xnew =
+          mgos.getCache()->makeUnknowns(mgos.trialGridFunctionSpace());
+        *xnew = *mgos.getCache()->getUnknowns(step-1);
         if(verbosity >= 2)
           std::cout << "== setup result vector (" << subTimer.elapsed() << "s)"
                     << std::endl;
@@ -329,7 +333,9 @@ namespace Dune {
        * \return A shared_ptr to the new value
        *
        * The old values are expected in the cache of the GridOperatorSpace.
-       * The computed value is store in the cache as well.
+       * The computed value is store in the cache as well.  The vector for
+       * the new value is obtained from MultiStepCache::makeUnknowns(), which
+       * recycles the storage of evicted vectors of unknowns.
        */
       template<typename F>
       std::shared_ptr<const TrialV> apply(T time, T dt, F& f)
@@ -369,7 +375,9 @@ namespace Dune {
           std::cout << "== setup result vector" << std::endl;
           subTimer.reset();
         }
-        std::shared_ptr<TrialV> xnew(new TrialV(mgos.trialGridFunctionSpace()));
+        // storage of evicted vectors is recycled by the cache
+        std::shared_ptr<TrialV> xnew =
+          mgos.getCache()->makeUnknowns(mgos.trialGridFunctionSpace());
         // set boundary conditions and initial value
         f.setTime(time+dt);
         mgos.interpolate(*mgos.getCache()->getUnknowns(step-1),f,*xnew);
@@ -0,0 +1,21 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_NEWTON_EXCEPTIONS_HH
+#define DUNE_PDELAB_NEWTON_EXCEPTIONS_HH
+
+#include <dune/common/exceptions.hh>
+
+namespace Dune
+{
+  namespace PDELab
+  {
+    // Exception classes used in NewtonSolver
+    class NewtonError : public Exception {};
+    class NewtonDefectError : public NewtonError {};
+    class NewtonLinearSolverError : public NewtonError {};
+    class NewtonLineSearchError : public NewtonError {};
+    class NewtonNotConverged : public NewtonError {};
+  }
+}
+
+#endif // DUNE_PDELAB_NEWTON_EXCEPTIONS_HH
@@ -0,0 +1,347 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_NEWTON_JACOBIANFREE_HH
+#define DUNE_PDELAB_NEWTON_JACOBIANFREE_HH
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/ftraits.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/istl/operators.hh>
+#include <dune/istl/solvercategory.hh>
+
+#include <dune/pdelab/backend/istl/utility.hh>
+#include <dune/pdelab/newton/newton.hh>
+
+namespace Dune
+{
+  namespace PDELab
+  {
+
+    //! the grid operator computes a Jacobian action that is inconsistent with its residual
+    class NewtonJacobianApplyError : public NewtonError {};
+
+    namespace impl {
+
+      //! whether GO provides jacobian_apply(const Domain&, Range&)
+      template<typename GO>
+      struct has_jacobian_apply
+      {
+        template<typename T>
+        static std::true_type test(decltype(std::declval<const T&>().jacobian_apply(
+                                              std::declval<const typename T::Traits::Domain&>(),
+                                              std::declval<typename T::Traits::Range&>()))*);
+
+        template<typename T>
+        static std::false_type test(...);
+
+        static const bool value = decltype(test<GO>(0))::value;
+      };
+
+    } // namespace impl
+
+    /** \brief Action of the Jacobian of a grid operator without assembling it
+
+        The Jacobian at the linearization point u is applied to a direction v
+        by a one-sided finite difference of the residual,
+
+        \f[ J(u) v \approx \frac{F(u + \varepsilon v) - F(u)}{\varepsilon}, \f]
+
+        with \f$\varepsilon = \sqrt{(1+\|u\|)\,\epsilon_{mach}}/\|v\|\f$ unless a
+        fixed perturbation is requested.
+
+        For grid operators whose local operator is affine in u, jacobian_apply()
+        can compute the action instead. It ignores the linearization point, so
+        setLinearizationPoint() then checks that \f$J u = F(u) - F(0)\f$, which
+        costs two residual evaluations, and throws a NewtonJacobianApplyError if
+        the operator turns out to be nonlinear. Grid operators without
+        jacobian_apply(), like OneStepGridOperator, only support finite
+        differences.
+
+        Constrained rows vanish in the residual, so the operator maps them to
+        zero. As the Newton defect vanishes there as well, the Krylov iteration
+        never leaves the subspace of unconstrained DOFs.
+
+        \note The operator is sequential, it can only be combined with sequential
+        solver backends.
+    */
+    template<typename GO, typename TrlV, typename TstV>
+    class NewtonJacobianFreeOperator
+      : public Dune::LinearOperator<typename istl::raw_type<TrlV>::type,
+                                    typename istl::raw_type<TstV>::type>
+    {
+    public:
+      typedef typename istl::raw_type<TrlV>::type domain_type;
+      typedef typename istl::raw_type<TstV>::type range_type;
+      typedef typename domain_type::field_type field_type;
+      typedef typename Dune::FieldTraits<field_type>::real_type real_type;
+
+      enum {category=Dune::SolverCategory::sequential};
+
+      /** \brief construct the operator
+
+          \param[in] go_ the grid operator whose Jacobian is applied
+          \param[in] use_jacobian_apply_ use go.jacobian_apply() instead of finite differences
+          \param[in] epsilon_ fixed relative perturbation, 0 selects it automatically
+      */
+      explicit NewtonJacobianFreeOperator(const GO& go_,
+                                          bool use_jacobian_apply_ = false,
+                                          real_type epsilon_ = 0.0)
+        : go(go_)
+        , u(0)
+        , u_norm(0.0)
+        , use_jacobian_apply(false)
+        , epsilon(epsilon_)
+      {
+        setUseJacobianApply(use_jacobian_apply_);
+      }
+
+      //! use go.jacobian_apply(), throws if GO does not provide it
+      void setUseJacobianApply(bool use_jacobian_apply_)
+      {
+        if (use_jacobian_apply_ && !impl::has_jacobian_apply<GO>::value)
+          DUNE_THROW(Dune::NotImplemented,
+                     "NewtonJacobianFreeOperator: the grid operator has no jacobian_apply()");
+        use_jacobian_apply = use_jacobian_apply_;
+      }
+
+      void setEpsilon(real_type epsilon_)
+      {
+        epsilon = epsilon_;
+      }
+
+      /** \brief set the point to linearize at
+
+          \param[in] u_ the linearization point, referenced until the next call
+          \param[in] r_ the residual F(u_), which is copied
+      */
+      void setLinearizationPoint(const TrlV& u_, const TstV& r_)
+      {
+        // the work vectors are kept across Newton iterations and
+        // only reallocated if the function spaces have changed
+        if (!x_work || x_work->N() != u_.N())
+          x_work = std::make_shared<TrlV>(go.trialGridFunctionSpace());
+        if (!r_work || r_work->N() != r_.N())
+          {
+            r_work = std::make_shared<TstV>(go.testGridFunctionSpace());
+            r0 = std::make_shared<TstV>(go.testGridFunctionSpace());
+          }
+        u = &u_;
+        *r0 = r_;
+        u_norm = istl::raw(u_).two_norm();
+        if (use_jacobian_apply)
+          checkAffine();
+      }
+
+      virtual void apply (const domain_type& x, range_type& y) const
+      {
+        if (evaluate(x))
+          y = istl::raw(*r_work);
+        else
+          y = 0.0;
+      }
+
+      virtual void applyscaleadd (field_type alpha, const domain_type& x, range_type& y) const
+      {
+        if (evaluate(x))
+          y.axpy(alpha,istl::raw(*r_work));
+      }
+
+    private:
+      //! compute J x into r_work, returns false if the result is zero
+      bool evaluate(const domain_type& x) const
+      {
+        if (use_jacobian_apply)
+          {
+            istl::raw(*x_work) = x;
+            *r_work = 0.0;
+            jacobianApply(*x_work, *r_work, impl::has_jacobian_apply<GO>());
+            return true;
+          }
+
+        const real_type x_norm = x.two_norm();
+        if (x_norm == 0.0)
+          return false;
+
+        real_type eps = epsilon;
+        if (eps <= 0.0)
+          eps = std::sqrt((1.0 + u_norm) * std::numeric_limits<real_type>::epsilon());
+        eps /= x_norm;
+
+        *x_work = *u;
+        istl::raw(*x_work).axpy(eps, x);
+        *r_work = 0.0;
+        go.residual(*x_work, *r_work);
+        *r_work -= *r0;
+        *r_work *= 1.0/eps;
+        return true;
+      }
+
+      void jacobianApply(const TrlV& x, TstV& r, std::true_type) const
+      {
+        go.jacobian_apply(x, r);
+      }
+
+      void jacobianApply(const TrlV& x, TstV& r, std::false_type) const
+      {
+        // unreachable, setUseJacobianApply() rejects such grid operators
+        DUNE_THROW(Dune::NotImplemented,
+                   "NewtonJacobianFreeOperator: the grid operator has no jacobian_apply()");
+      }
+
+      //! check J u = F(u) - F(0), which holds for all u iff F is affine
+      void checkAffine() const
+      {
+        // F(u) - F(0)
+        *x_work = 0.0;
+        *r_work = 0.0;
+        go.residual(*x_work, *r_work);
+        TstV difference(*r0);
+        difference -= *r_work;
+        // J u, as computed by jacobian_apply() independently of the linearization point
+        *r_work = 0.0;
+        jacobianApply(*u, *r_work, impl::has_jacobian_apply<GO>());
+        const real_type scale = std::max(difference.two_norm(), r_work->two_norm());
+        difference -= *r_work;
+        // local operators typically compute the action by finite differences themselves
+        const real_type tolerance = std::cbrt(std::numeric_limits<real_type>::epsilon());
+        if (difference.two_norm() > tolerance * scale)
+          DUNE_THROW(NewtonJacobianApplyError,
+                     "NewtonJacobianFreeOperator: jacobian_apply() is inconsistent with the "
+                     "residual, the local operator is not linear in u");
+      }
+
+      const GO& go;
+      const TrlV* u;
+      std::shared_ptr<TstV> r0;
+      mutable std::shared_ptr<TrlV> x_work;
+      mutable std::shared_ptr<TstV> r_work;
+      real_type u_norm;
+      bool use_jacobian_apply;
+      real_type epsilon;
+    };
+
+    /** \brief Jacobian-free Newton-Krylov solver
+
+        Works like Newton, but the linear solver only sees the action of the
+        Jacobian through a NewtonJacobianFreeOperator. The assembled matrix is
+        merely used to build the preconditioner, so it can be lagged across
+        Newton iterations via setReassembleThreshold() without spoiling the
+        convergence of the outer iteration.
+
+        The solver backend S has to provide
+        \code
+        template<class Op, class M, class V, class W>
+        void apply(Op& op, M& P, V& z, W& r, typename W::ElementType reduction);
+        \endcode
+        e.g. ISTLBackend_SEQ_JacobianFree_GMRES_SSOR.
+    */
+    template<class GOS, class S, class TrlV, class TstV = TrlV>
+    class JacobianFreeNewton : public Newton<GOS,S,TrlV,TstV>
+    {
+      typedef GOS GridOperator;
+      typedef S Solver;
+      typedef TrlV TrialVector;
+      typedef TstV TestVector;
+
+      typedef typename TestVector::ElementType RFType;
+      typedef typename GOS::Traits::Jacobian Matrix;
+      typedef NewtonJacobianFreeOperator<GOS,TrlV,TstV> Operator;
+
+    public:
+      JacobianFreeNewton(GridOperator& go, TrialVector& u_, Solver& solver_)
+        : NewtonBase<GOS,TrlV,TstV>(go,u_)
+        , Newton<GOS,S,TrlV,TstV>(go,u_,solver_)
+        , op(go)
+      {
+        // the matrix is only a preconditioner, so keep it as long as
+        // the nonlinear iteration converges reasonably
+        this->setReassembleThreshold(0.5);
+      }
+
+      JacobianFreeNewton(GridOperator& go, Solver& solver_)
+        : NewtonBase<GOS,TrlV,TstV>(go)
+        , Newton<GOS,S,TrlV,TstV>(go,solver_)
+        , op(go)
+      {
+        this->setReassembleThreshold(0.5);
+      }
+
+      //! use jacobian_apply() of the grid operator, which has to be affine in u
+      /**
+         Throws Dune::NotImplemented if the grid operator has no jacobian_apply(),
+         and the linear solve throws a NewtonJacobianApplyError if the operator
+         turns out to be nonlinear.
+      */
+      void setUseJacobianApply(bool use_jacobian_apply_)
+      {
+        op.setUseJacobianApply(use_jacobian_apply_);
+      }
+
+      //! set a fixed finite difference perturbation, 0 selects it automatically
+      void setJacobianFreeEpsilon(RFType epsilon_)
+      {
+        op.setEpsilon(epsilon_);
+      }
+
+      //! interpret a parameter tree as a set of options for the newton solver
+      /**
+         In addition to the keys understood by Newton::setParameters(), this
+         supports UseJacobianApply and JacobianFreeEpsilon.
+      */
+      void setParameters(Dune::ParameterTree & param)
+      {
+        Newton<GOS,S,TrlV,TstV>::setParameters(param);
+        if (param.hasKey("UseJacobianApply"))
+          this->setUseJacobianApply(
+            param.get<bool>("UseJacobianApply"));
+        if (param.hasKey("JacobianFreeEpsilon"))
+          this->setJacobianFreeEpsilon(
+            param.get<RFType>("JacobianFreeEpsilon"));
+      }
+
+    protected:
+      //! the Jacobian is applied at the current iterate, only the preconditioner may be outdated
+      virtual bool newtonDirection() const
+      {
+        return true;
+      }
+
+      virtual void linearSolve(Matrix& A, TrialVector& z, TestVector& r)
+      {
+        if (this->verbosity_level >= 4)
+          std::cout << "      Solving linear system (Jacobian-free)..." << std::endl;
+        // r holds F(u) at this point, which is the base of the finite differences
+        op.setLinearizationPoint(*this->u, r);
+        z = 0.0;                                        // TODO: vector interface
+        this->solver.apply(op, A, z, r, this->linear_reduction);
+
+        ios_base_all_saver restorer(std::cout); // store old ios flags
+
+        if (!this->solver.result().converged)
+          DUNE_THROW(NewtonLinearSolverError,
+                     "JacobianFreeNewton::linearSolve(): Linear solver did not converge "
+                     "in " << this->solver.result().iterations << " iterations");
+        if (this->verbosity_level >= 4)
+          std::cout << "          linear solver iterations:     "
+                    << std::setw(12) << this->solver.result().iterations << std::endl
+                    << "          linear defect reduction:      "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << this->solver.result().reduction << std::endl;
+      }
+
+    private:
+      Operator op;
+    };
+
+  }
+}
+
+#endif // DUNE_PDELAB_NEWTON_JACOBIANFREE_HH
@@ -3,9 +3,11 @@
 #ifndef DUNE_PDELAB_NEWTON_HH
 #define DUNE_PDELAB_NEWTON_HH
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <memory>
 
 #include <math.h>
 
@@ -15,18 +17,12 @@
 #include <dune/common/parametertree.hh>
 
 #include <dune/pdelab/backend/solver.hh>
+#include <dune/pdelab/newton/exceptions.hh>
 
 namespace Dune
 {
   namespace PDELab
   {
-    // Exception classes used in NewtonSolver
-    class NewtonError : public Exception {};
-    class NewtonDefectError : public NewtonError {};
-    class NewtonLinearSolverError : public NewtonError {};
-    class NewtonLineSearchError : public NewtonError {};
-    class NewtonNotConverged : public NewtonError {};
-
     // Status information of Newton's method
     template<class RFType>
     struct NewtonResult : LinearSolverResult<RFType>
@@ -80,6 +76,7 @@ namespace Dune
         : gridoperator(go)
         , u(&u_)
         , verbosity_level(1)
+        , linear_reduction(0.0)
       {
         if (gridoperator.trialGridFunctionSpace().gridView().comm().rank()>0)
           verbosity_level = 0;
@@ -89,6 +86,7 @@ namespace Dune
         : gridoperator(go)
         , u(0)
         , verbosity_level(1)
+        , linear_reduction(0.0)
       {
         if (gridoperator.trialGridFunctionSpace().gridView().comm().rank()>0)
           verbosity_level = 0;
@@ -152,8 +150,7 @@ namespace Dune
       }
 
 
-    private:
-      void linearSolve(Matrix& A, TrialVector& z, TestVector& r) const
+      virtual void linearSolve(Matrix& A, TrialVector& z, TestVector& r)
       {
         if (this->verbosity_level >= 4)
           std::cout << "      Solving linear system..." << std::endl;
@@ -175,6 +172,8 @@ namespace Dune
       }
 
       Solver& solver;
+
+    private:
       bool result_valid;
     };
 
@@ -496,9 +495,27 @@ namespace Dune
                       hackbuschReusken,
                       hackbuschReuskenAcceptBest };
 
+      /** How the next damping factor is chosen after a rejected one
+
+          damped multiplies lambda by the damping factor, quadratic and cubic
+          minimize a polynomial model of phi(lambda) = |F(u - lambda z)|^2/2
+          built from phi(0), phi'(0) and the last one or two trial values.
+          As the linear systems are only solved up to the relative reduction
+          eta, phi'(0) is the bound -(1-eta)|F(u)|^2 of the slope of an
+          inexact Newton direction. The interpolated factor is safeguarded
+          to lie in [0.1 lambda, 0.5 lambda]. If the Jacobian has not been
+          reassembled in the current iteration, the direction is not a
+          Newton direction and the bound does not hold, so these iterations
+          fall back to damped backtracking.
+      */
+      enum Backtracking { damped,
+                          quadratic,
+                          cubic };
+
       NewtonLineSearch(GridOperator& go, TrialVector& u_)
         : NewtonBase<GOS,TrlV,TstV>(go,u_)
         , strategy(hackbuschReusken)
+        , backtracking(damped)
         , maxit(10)
         , damping_factor(0.5)
       {}
@@ -506,6 +523,7 @@ namespace Dune
       NewtonLineSearch(GridOperator& go)
         : NewtonBase<GOS,TrlV,TstV>(go)
         , strategy(hackbuschReusken)
+        , backtracking(damped)
         , maxit(10)
         , damping_factor(0.5)
       {}
@@ -520,6 +538,16 @@ namespace Dune
         strategy = strategyFromName(strategy_);
       }
 
+      void setLineSearchBacktracking(Backtracking backtracking_)
+      {
+        backtracking = backtracking_;
+      }
+
+      void setLineSearchBacktracking(std::string backtracking_)
+      {
+        backtracking = backtrackingFromName(backtracking_);
+      }
+
       void setLineSearchMaxIterations(unsigned int maxit_)
       {
         maxit = maxit_;
@@ -544,7 +572,19 @@ namespace Dune
         RFType lambda = 1.0;
         RFType best_lambda = 0.0;
         RFType best_defect = this->res.defect;
-        TrialVector prev_u(*this->u);  // TODO: vector interface
+        // the backup of the solution is kept across Newton iterations
+        if (!prev_u || prev_u->N() != this->u->N())
+          prev_u = std::make_shared<TrialVector>(*this->u); // TODO: vector interface
+        else
+          *prev_u = *this->u;
+        // data of the polynomial model phi(lambda) = defect(lambda)^2/2; with
+        // |F + J z| <= eta |F|, the slope along the Newton direction is at
+        // most -(1-eta)|F|^2
+        const RFType eta = std::min(std::max(this->linear_reduction,RFType(0.0)),RFType(0.99));
+        const RFType phi0 = 0.5 * this->prev_defect * this->prev_defect;
+        const RFType dphi0 = -2.0 * (1.0 - eta) * phi0;
+        RFType prev_lambda = 0.0;
+        RFType prev_phi = phi0;
         unsigned int i = 0;
         ios_base_all_saver restorer(std::cout); // store old ios flags
 
@@ -557,23 +597,25 @@ namespace Dune
                         << std::endl;
 
             this->u->axpy(-lambda, z);                  // TODO: vector interface
+            bool finite = true;
             try {
               this->defect(r);
             }
             catch (NewtonDefectError)
               {
+                finite = false;
                 if (this->verbosity_level >= 4)
                   std::cout << "          Nans detected" << std::endl;
               }       // ignore NaNs and try again with lower lambda
 
-            if (this->res.defect <= (1.0 - lambda/4) * this->prev_defect)
+            if (finite && this->res.defect <= (1.0 - lambda/4) * this->prev_defect)
               {
                 if (this->verbosity_level >= 4)
                   std::cout << "          line search converged" << std::endl;
                 break;
               }
 
-            if (this->res.defect < best_defect)
+            if (finite && this->res.defect < best_defect)
               {
                 best_defect = this->res.defect;
                 best_lambda = lambda;
@@ -586,7 +628,7 @@ namespace Dune
                 switch (strategy)
                   {
                   case hackbuschReusken:
-                    *this->u = prev_u;
+                    *this->u = *prev_u;
                     this->defect(r);
                     DUNE_THROW(NewtonLineSearchError,
                                "NewtonLineSearch::line_search(): line search failed, "
@@ -595,7 +637,7 @@ namespace Dune
                   case hackbuschReuskenAcceptBest:
                     if (best_lambda == 0.0)
                       {
-                        *this->u = prev_u;
+                        *this->u = *prev_u;
                         this->defect(r);
                         DUNE_THROW(NewtonLineSearchError,
                                    "NewtonLineSearch::line_search(): line search failed, "
@@ -604,7 +646,7 @@ namespace Dune
                       }
                     if (best_lambda != lambda)
                       {
-                        *this->u = prev_u;
+                        *this->u = *prev_u;
                         this->u->axpy(-best_lambda, z);
                         this->defect(r);
                       }
@@ -615,8 +657,14 @@ namespace Dune
                 break;
               }
 
-            lambda *= damping_factor;
-            *this->u = prev_u;                          // TODO: vector interface
+            const RFType phi = 0.5 * this->res.defect * this->res.defect;
+            const RFType next_lambda = finite && newtonDirection()
+              ? nextLambda(lambda, phi, prev_lambda, prev_phi, phi0, dphi0)
+              : lambda * damping_factor;
+            prev_lambda = lambda;
+            prev_phi = phi;
+            lambda = next_lambda;
+            *this->u = *prev_u;                         // TODO: vector interface
           }
         if (this->verbosity_level >= 4)
           std::cout << "          line search damping factor:   "
@@ -625,6 +673,12 @@ namespace Dune
       }
 
     protected:
+      //! whether the search direction solves a linear system with the current Jacobian
+      virtual bool newtonDirection() const
+      {
+        return this->reassembled;
+      }
+
       /** helper function to get the different strategies from their name */
       Strategy strategyFromName(const std::string & s) {
         if (s == "noLineSearch")
@@ -633,12 +687,69 @@ namespace Dune
           return hackbuschReusken;
         if (s == "hackbuschReuskenAcceptBest")
           return hackbuschReuskenAcceptBest;
+        DUNE_THROW(Exception, "unknown line search strategy " << s);
+      }
+
+      /** helper function to get the backtracking variants from their name */
+      Backtracking backtrackingFromName(const std::string & s) {
+        if (s == "damped")
+          return damped;
+        if (s == "quadratic")
+          return quadratic;
+        if (s == "cubic")
+          return cubic;
+        DUNE_THROW(Exception, "unknown line search backtracking " << s);
+      }
+
+      //! compute the next trial damping factor after lambda has been rejected
+      RFType nextLambda(RFType lambda, RFType phi,
+                        RFType prev_lambda, RFType prev_phi,
+                        RFType phi0, RFType dphi0) const
+      {
+        if (backtracking == damped)
+          return lambda * damping_factor;
+
+        RFType next;
+        if (backtracking == quadratic || prev_lambda == 0.0)
+          {
+            // minimizer of the parabola through phi0, dphi0 and phi(lambda)
+            const RFType denom = 2.0 * (phi - phi0 - dphi0 * lambda);
+            next = denom > 0.0 ? -dphi0 * lambda * lambda / denom : 0.5 * lambda;
+          }
+        else
+          {
+            // minimizer of the cubic through phi0, dphi0, phi(lambda) and phi(prev_lambda)
+            const RFType r1 = phi - phi0 - dphi0 * lambda;
+            const RFType r2 = prev_phi - phi0 - dphi0 * prev_lambda;
+            const RFType l1 = lambda * lambda;
+            const RFType l2 = prev_lambda * prev_lambda;
+            const RFType d = lambda - prev_lambda;
+            const RFType a = (r1 / l1 - r2 / l2) / d;
+            const RFType b = (-prev_lambda * r1 / l1 + lambda * r2 / l2) / d;
+            if (a == 0.0)
+              next = -dphi0 / (2.0 * b);
+            else
+              {
+                const RFType disc = b * b - 3.0 * a * dphi0;
+                if (disc < 0.0)
+                  next = 0.5 * lambda;
+                else if (b <= 0.0)
+                  next = (-b + std::sqrt(disc)) / (3.0 * a);
+                else
+                  next = -dphi0 / (b + std::sqrt(disc));
+              }
+          }
+        if (!std::isfinite(next))
+          next = 0.5 * lambda;
+        return std::max(RFType(0.1 * lambda), std::min(next, RFType(0.5 * lambda)));
       }
 
     private:
       Strategy strategy;
+      Backtracking backtracking;
       unsigned int maxit;
       RFType damping_factor;
+      std::shared_ptr<TrialVector> prev_u;
     };
 
     template<class GOS, class S, class TrlV, class TstV = TrlV>
@@ -718,6 +829,9 @@ namespace Dune
         if (param.hasKey("LineSearchStrategy"))
           this->setLineSearchStrategy(
             param.get<std::string>("LineSearchStrategy"));
+        if (param.hasKey("LineSearchBacktracking"))
+          this->setLineSearchBacktracking(
+            param.get<std::string>("LineSearchBacktracking"));
         if (param.hasKey("LineSearchMaxIterations"))
           this->setLineSearchMaxIterations(
             param.get<unsigned int>("LineSearchMaxIterations"));
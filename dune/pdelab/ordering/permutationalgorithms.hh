@@ -0,0 +1,449 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_ORDERING_PERMUTATIONALGORITHMS_HH
+#define DUNE_PDELAB_ORDERING_PERMUTATIONALGORITHMS_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup Ordering
+    //! \{
+
+    namespace ordering {
+
+      //! Algorithms for computing the permutation of a Permuted ordering during GridFunctionSpace::update().
+      struct PermutationAlgorithm
+      {
+
+        enum type {
+          user, //!< The permutation is supplied by the user.
+          reverseCuthillMcKee, //!< Reduce the bandwidth of the DOF graph by reverse Cuthill-McKee.
+          hilbertCurve, //!< Sort the DOFs along a Hilbert curve through their locations.
+          mortonCurve, //!< Sort the DOFs along a Morton (Z-order) curve through their locations.
+          nestedDissection //!< Order the DOFs by recursive bisection of the DOF graph with separators last.
+        };
+
+      };
+
+
+      //! Symmetric adjacency graph of the DOF blocks, stored in compressed row format.
+      /**
+       * Two blocks are adjacent if they are associated with a common element. The graph is built
+       * from the lists of blocks of all elements; a block is never adjacent to itself.
+       */
+      class DOFAdjacencyGraph
+      {
+
+      public:
+
+        typedef std::size_t size_type;
+
+        /**
+         * \param blocks          Number of DOF blocks.
+         * \param element_offsets Offsets of the block lists of the elements in element_blocks, with a
+         *                        trailing entry for the end of the last list.
+         * \param element_blocks  Concatenated, duplicate free block lists of all elements.
+         */
+        DOFAdjacencyGraph(size_type blocks,
+                          const std::vector<size_type>& element_offsets,
+                          const std::vector<size_type>& element_blocks)
+          : _offsets(blocks + 1,0)
+        {
+          const size_type elements = element_offsets.size() - 1;
+
+          // transpose the element -> block relation
+          std::vector<size_type> block_offsets(blocks + 1,0);
+          for (size_type b : element_blocks)
+            ++block_offsets[b + 1];
+          std::partial_sum(block_offsets.begin(),block_offsets.end(),block_offsets.begin());
+          std::vector<size_type> block_elements(element_blocks.size());
+          {
+            std::vector<size_type> fill(block_offsets.begin(),block_offsets.end() - 1);
+            for (size_type e = 0; e < elements; ++e)
+              for (size_type i = element_offsets[e]; i < element_offsets[e + 1]; ++i)
+                block_elements[fill[element_blocks[i]]++] = e;
+          }
+
+          // the neighbors of a block are the blocks of its elements
+          std::vector<size_type> marker(blocks,std::numeric_limits<size_type>::max());
+          for (size_type b = 0; b < blocks; ++b)
+            {
+              marker[b] = b;
+              for (size_type k = block_offsets[b]; k < block_offsets[b + 1]; ++k)
+                {
+                  const size_type e = block_elements[k];
+                  for (size_type i = element_offsets[e]; i < element_offsets[e + 1]; ++i)
+                    {
+                      const size_type n = element_blocks[i];
+                      if (marker[n] != b)
+                        {
+                          marker[n] = b;
+                          _neighbors.push_back(n);
+                        }
+                    }
+                }
+              _offsets[b + 1] = _neighbors.size();
+            }
+        }
+
+        size_type size() const
+        {
+          return _offsets.size() - 1;
+        }
+
+        size_type degree(size_type v) const
+        {
+          return _offsets[v + 1] - _offsets[v];
+        }
+
+        const size_type* beginNeighbors(size_type v) const
+        {
+          return _neighbors.data() + _offsets[v];
+        }
+
+        const size_type* endNeighbors(size_type v) const
+        {
+          return _neighbors.data() + _offsets[v + 1];
+        }
+
+      private:
+
+        std::vector<size_type> _offsets;
+        std::vector<size_type> _neighbors;
+
+      };
+
+
+#ifndef DOXYGEN // implementation internals
+
+      namespace permuted {
+
+        // Breadth first search within the vertices v with subset[v] == stamp, starting at start.
+        // Appends the visited vertices to queue and returns the number of levels. The vertices of
+        // level l are queue[level_offsets[l]] ... queue[level_offsets[l+1]-1]. With sort_by_degree,
+        // the neighbors of each vertex are visited in order of increasing degree (Cuthill-McKee).
+        inline std::size_t bfs_levels(const DOFAdjacencyGraph& graph,
+                                      std::size_t start,
+                                      const std::vector<std::size_t>& subset,
+                                      std::size_t stamp,
+                                      std::vector<std::size_t>& visited,
+                                      std::size_t visit_stamp,
+                                      std::vector<std::size_t>& queue,
+                                      std::vector<std::size_t>& level_offsets,
+                                      bool sort_by_degree)
+        {
+          const std::size_t queue_begin = queue.size();
+          level_offsets.assign(1,queue_begin);
+          queue.push_back(start);
+          visited[start] = visit_stamp;
+          std::size_t head = queue_begin;
+          while (head < queue.size())
+            {
+              const std::size_t level_end = queue.size();
+              for (; head < level_end; ++head)
+                {
+                  const std::size_t v = queue[head];
+                  const std::size_t first_new = queue.size();
+                  for (const std::size_t* n = graph.beginNeighbors(v); n != graph.endNeighbors(v); ++n)
+                    if (subset[*n] == stamp && visited[*n] != visit_stamp)
+                      {
+                        visited[*n] = visit_stamp;
+                        queue.push_back(*n);
+                      }
+                  if (sort_by_degree)
+                    std::sort(queue.begin() + first_new,queue.end(),
+                              [&graph](std::size_t a, std::size_t b) {
+                                return graph.degree(a) < graph.degree(b);
+                              });
+                }
+              level_offsets.push_back(queue.size());
+            }
+          // the loop has appended an empty last level
+          level_offsets.pop_back();
+          for (std::size_t& offset : level_offsets)
+            offset -= queue_begin;
+          return level_offsets.size() - 1;
+        }
+
+        // Find a pseudo-peripheral vertex of the component of start (George-Liu heuristic).
+        inline std::size_t pseudo_peripheral_vertex(const DOFAdjacencyGraph& graph,
+                                                    std::size_t start,
+                                                    const std::vector<std::size_t>& subset,
+                                                    std::size_t stamp,
+                                                    std::vector<std::size_t>& visited,
+                                                    std::size_t& visit_stamp)
+        {
+          std::vector<std::size_t> queue;
+          std::vector<std::size_t> level_offsets;
+          std::size_t levels = bfs_levels(graph,start,subset,stamp,visited,++visit_stamp,queue,level_offsets,false);
+          for (int iteration = 0; iteration < 8; ++iteration)
+            {
+              // vertex of minimum degree in the last level
+              std::size_t candidate = queue[level_offsets[levels - 1]];
+              for (std::size_t i = level_offsets[levels - 1]; i < level_offsets[levels]; ++i)
+                if (graph.degree(queue[i]) < graph.degree(candidate))
+                  candidate = queue[i];
+              queue.clear();
+              const std::size_t candidate_levels =
+                bfs_levels(graph,candidate,subset,stamp,visited,++visit_stamp,queue,level_offsets,false);
+              if (candidate_levels <= levels)
+                return candidate;
+              start = candidate;
+              levels = candidate_levels;
+            }
+          return start;
+        }
+
+        // Interleave the bits of the coordinates, most significant bits first.
+        template<typename Coordinates>
+        std::uint64_t interleave_bits(const Coordinates& x, std::size_t dim, std::size_t bits)
+        {
+          std::uint64_t key = 0;
+          for (std::size_t j = bits; j-- > 0;)
+            for (std::size_t i = 0; i < dim; ++i)
+              key = (key << 1) | ((x[i] >> j) & 1);
+          return key;
+        }
+
+        // Transform integer coordinates into the transposed Hilbert index (J. Skilling, 2004).
+        template<typename Coordinates>
+        void hilbert_transpose(Coordinates& x, std::size_t dim, std::size_t bits)
+        {
+          const std::uint64_t m = std::uint64_t(1) << (bits - 1);
+          // inverse undo
+          for (std::uint64_t q = m; q > 1; q >>= 1)
+            {
+              const std::uint64_t p = q - 1;
+              for (std::size_t i = 0; i < dim; ++i)
+                if (x[i] & q)
+                  x[0] ^= p;
+                else
+                  {
+                    const std::uint64_t t = (x[0] ^ x[i]) & p;
+                    x[0] ^= t;
+                    x[i] ^= t;
+                  }
+            }
+          // Gray encode
+          for (std::size_t i = 1; i < dim; ++i)
+            x[i] ^= x[i-1];
+          std::uint64_t t = 0;
+          for (std::uint64_t q = m; q > 1; q >>= 1)
+            if (x[dim-1] & q)
+              t ^= q - 1;
+          for (std::size_t i = 0; i < dim; ++i)
+            x[i] ^= t;
+        }
+
+      } // namespace permuted
+
+#endif // DOXYGEN
+
+
+      //! Compute a reverse Cuthill-McKee ordering of the graph.
+      /**
+       * On return, order[k] is the vertex placed at position k. Each connected component is started
+       * from a pseudo-peripheral vertex.
+       */
+      inline void reverse_cuthill_mckee(const DOFAdjacencyGraph& graph, std::vector<std::size_t>& order)
+      {
+        const std::size_t n = graph.size();
+        const std::vector<std::size_t> subset(n,0);
+        std::vector<std::size_t> visited(n,0);
+        std::vector<std::size_t> placed(n,0);
+        std::vector<std::size_t> level_offsets;
+        std::size_t visit_stamp = 0;
+
+        // start components at vertices of low degree
+        std::vector<std::size_t> candidates(n);
+        std::iota(candidates.begin(),candidates.end(),0);
+        std::stable_sort(candidates.begin(),candidates.end(),
+                         [&graph](std::size_t a, std::size_t b) {
+                           return graph.degree(a) < graph.degree(b);
+                         });
+
+        order.clear();
+        order.reserve(n);
+        for (std::size_t candidate : candidates)
+          {
+            if (placed[candidate])
+              continue;
+            const std::size_t start = permuted::pseudo_peripheral_vertex(graph,candidate,subset,0,visited,visit_stamp);
+            const std::size_t component_begin = order.size();
+            permuted::bfs_levels(graph,start,subset,0,visited,++visit_stamp,order,level_offsets,true);
+            for (std::size_t i = component_begin; i < order.size(); ++i)
+              placed[order[i]] = 1;
+          }
+        std::reverse(order.begin(),order.end());
+      }
+
+
+      //! Compute a nested dissection ordering of the graph.
+      /**
+       * The graph is bisected recursively at the middle level of a breadth first search from a
+       * pseudo-peripheral vertex. Both halves are ordered before their separator. Subgraphs with at
+       * most leaf_size vertices are kept in breadth first order. On return, order[k] is the vertex
+       * placed at position k.
+       */
+      inline void nested_dissection(const DOFAdjacencyGraph& graph, std::vector<std::size_t>& order,
+                                    std::size_t leaf_size = 64)
+      {
+        const std::size_t n = graph.size();
+        std::vector<std::size_t> subset(n,0);
+        std::vector<std::size_t> visited(n,0);
+        std::vector<std::size_t> queue;
+        std::vector<std::size_t> level_offsets;
+        std::size_t stamp = 0;
+        std::size_t visit_stamp = 0;
+
+        // work items: a set of vertices to dissect, or a separator to emit
+        struct Task
+        {
+          std::vector<std::size_t> vertices;
+          bool emit;
+        };
+        std::vector<Task> tasks;
+        tasks.push_back(Task());
+        tasks.back().vertices.resize(n);
+        std::iota(tasks.back().vertices.begin(),tasks.back().vertices.end(),0);
+        tasks.back().emit = false;
+
+        order.clear();
+        order.reserve(n);
+        while (!tasks.empty())
+          {
+            Task task(std::move(tasks.back()));
+            tasks.pop_back();
+            if (task.emit)
+              {
+                order.insert(order.end(),task.vertices.begin(),task.vertices.end());
+                continue;
+              }
+
+            ++stamp;
+            for (std::size_t v : task.vertices)
+              subset[v] = stamp;
+
+            // split into connected components
+            std::vector<std::vector<std::size_t> > components;
+            ++visit_stamp;
+            for (std::size_t v : task.vertices)
+              if (visited[v] != visit_stamp)
+                {
+                  components.push_back(std::vector<std::size_t>());
+                  permuted::bfs_levels(graph,v,subset,stamp,visited,visit_stamp,components.back(),level_offsets,false);
+                }
+
+            if (components.size() > 1)
+              {
+                for (std::size_t c = components.size(); c-- > 0;)
+                  {
+                    tasks.push_back(Task());
+                    tasks.back().vertices.swap(components[c]);
+                    tasks.back().emit = false;
+                  }
+                continue;
+              }
+
+            if (task.vertices.size() <= leaf_size)
+              {
+                order.insert(order.end(),components[0].begin(),components[0].end());
+                continue;
+              }
+
+            // level structure rooted at a pseudo-peripheral vertex
+            const std::size_t start = permuted::pseudo_peripheral_vertex(graph,task.vertices[0],subset,stamp,visited,visit_stamp);
+            queue.clear();
+            const std::size_t levels = permuted::bfs_levels(graph,start,subset,stamp,visited,++visit_stamp,queue,level_offsets,false);
+            if (levels < 3)
+              {
+                order.insert(order.end(),queue.begin(),queue.end());
+                continue;
+              }
+
+            // separate at the level that splits the vertices most evenly
+            std::size_t separator = 1;
+            while (separator + 2 < levels && 2 * level_offsets[separator + 1] < queue.size())
+              ++separator;
+
+            Task first, second, middle;
+            first.vertices.assign(queue.begin(),queue.begin() + level_offsets[separator]);
+            middle.vertices.assign(queue.begin() + level_offsets[separator],queue.begin() + level_offsets[separator + 1]);
+            second.vertices.assign(queue.begin() + level_offsets[separator + 1],queue.end());
+            first.emit = second.emit = false;
+            middle.emit = true;
+            tasks.push_back(std::move(middle));
+            tasks.push_back(std::move(second));
+            tasks.push_back(std::move(first));
+          }
+      }
+
+
+      //! Sort points along a space filling curve.
+      /**
+       * The points are mapped to an integer lattice within their bounding box and sorted by their
+       * Hilbert or Morton index. On return, order[k] is the index of the point placed at position k.
+       *
+       * \tparam Point A FieldVector-like coordinate type.
+       */
+      template<typename Point>
+      void space_filling_curve(const std::vector<Point>& points, bool hilbert, std::vector<std::size_t>& order)
+      {
+        const std::size_t n = points.size();
+        order.resize(n);
+        std::iota(order.begin(),order.end(),0);
+        if (n == 0)
+          return;
+
+        const std::size_t dim = points[0].size();
+        if (dim == 0 || dim > 64)
+          DUNE_THROW(Exception,"cannot compute space filling curve in " << dim << " dimensions");
+        const std::size_t bits = std::min(std::size_t(31),64 / dim);
+
+        Point lower(points[0]), upper(points[0]);
+        for (const Point& p : points)
+          for (std::size_t i = 0; i < dim; ++i)
+            {
+              lower[i] = std::min(lower[i],p[i]);
+              upper[i] = std::max(upper[i],p[i]);
+            }
+
+        std::vector<std::uint64_t> keys(n);
+        std::vector<std::uint64_t> x(dim);
+        const double cells = double((std::uint64_t(1) << bits) - 1);
+        for (std::size_t k = 0; k < n; ++k)
+          {
+            for (std::size_t i = 0; i < dim; ++i)
+              {
+                const double extent = upper[i] - lower[i];
+                x[i] = extent > 0 ? std::uint64_t((points[k][i] - lower[i]) / extent * cells) : 0;
+              }
+            if (hilbert)
+              permuted::hilbert_transpose(x,dim,bits);
+            keys[k] = permuted::interleave_bits(x,dim,bits);
+          }
+
+        std::stable_sort(order.begin(),order.end(),
+                         [&keys](std::size_t a, std::size_t b) {
+                           return keys[a] < keys[b];
+                         });
+      }
+
+    } // namespace ordering
+
+    //! \} group Ordering
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_ORDERING_PERMUTATIONALGORITHMS_HH
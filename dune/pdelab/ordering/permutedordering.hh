@@ -4,11 +4,16 @@
 #ifndef DUNE_PDELAB_ORDERING_PERMUTEDORDERING_HH
 #define DUNE_PDELAB_ORDERING_PERMUTEDORDERING_HH
 
+#include <vector>
+
 #include <dune/typetree/typetree.hh>
 
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
 #include <dune/pdelab/ordering/utility.hh>
 #include <dune/pdelab/ordering/orderingbase.hh>
 #include <dune/pdelab/ordering/decorator.hh>
+#include <dune/pdelab/ordering/permutationalgorithms.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -22,6 +27,10 @@ namespace Dune {
         struct tag_base
         {
 
+          tag_base()
+            : _algorithm(PermutationAlgorithm::user)
+          {}
+
           std::vector<std::size_t>& permutation()
           {
             return _permutation;
@@ -32,9 +41,20 @@ namespace Dune {
             return _permutation;
           }
 
+          PermutationAlgorithm::type algorithm() const
+          {
+            return _algorithm;
+          }
+
+          void setAlgorithm(PermutationAlgorithm::type algorithm)
+          {
+            _algorithm = algorithm;
+          }
+
         private:
 
           std::vector<std::size_t> _permutation;
+          PermutationAlgorithm::type _algorithm;
 
         };
 
@@ -55,7 +75,10 @@ namespace Dune {
        * with this OrderingTag were the topmost space, but you cannot perform any reordering within those
        * individual blocks.
        *
-       *
+       * Instead of supplying the permutation, you can select a PermutationAlgorithm. The permutation
+       * is then computed from the DOF graph or the DOF locations whenever the root
+       * GridFunctionSpace is updated. This is only supported for the outermost Permuted tag of the
+       * root space.
        *
        * \tparam OrderingTag  The tag describing the Ordering that will be permuted.
        */
@@ -76,6 +99,12 @@ namespace Dune {
           : decorated_ordering_tag<Permuted<OrderingTag>,OrderingTag>(std::move(tag))
         {}
 
+        //! Compute the permutation with the given algorithm.
+        explicit Permuted(PermutationAlgorithm::type algorithm)
+        {
+          this->template permuted<Permuted::level>().setAlgorithm(algorithm);
+        }
+
         template<std::size_t i>
         const permuted::base_holder<i>& permuted() const
         {
@@ -188,7 +217,9 @@ namespace Dune {
       {
         ordering().update();
         BaseT::update();
-        if (!_tag.permutation().empty() && _tag.permutation().size() != this->blockCount())
+        // automatic permutations are recomputed by the GridFunctionSpace after the update
+        if (_tag.algorithm() == ordering::PermutationAlgorithm::user &&
+            !_tag.permutation().empty() && _tag.permutation().size() != this->blockCount())
           DUNE_THROW(PermutedOrderingSizeError,
                      "Size of permutation array does not match block count of ordering: "
                      << _tag.permutation().size()
@@ -244,6 +275,89 @@ namespace Dune {
     } // namespace ordering
 
 
+    namespace ordering {
+
+      //! Compute the automatic permutation of a Permuted ordering from the updated GridFunctionSpace.
+      /**
+       * This is called by GridFunctionSpaceBase::update() after the ordering has been updated with
+       * an identity permutation. The DOF blocks of each element are read through the space itself;
+       * they determine the DOF graph, and the element centers determine the location of each block.
+       */
+      template<typename GFS, typename OrderingTag>
+      void update_ordering_tag(const GFS& gfs, Permuted<OrderingTag>& tag)
+      {
+        auto& permuted_tag = tag.template permuted<Permuted<OrderingTag>::level>();
+        const PermutationAlgorithm::type algorithm = permuted_tag.algorithm();
+        if (algorithm == PermutationAlgorithm::user)
+          return;
+
+        typedef LocalFunctionSpace<GFS> LFS;
+        typedef LFSIndexCache<LFS> LFSCache;
+        typedef typename GFS::Traits::GridViewType::template Codim<0>::Geometry::GlobalCoordinate Point;
+
+        const bool curve = algorithm == PermutationAlgorithm::hilbertCurve
+          || algorithm == PermutationAlgorithm::mortonCurve;
+
+        LFS lfs(gfs);
+        LFSCache lfs_cache(lfs);
+
+        const std::size_t blocks = gfs.blockCount();
+        std::vector<std::size_t> element_offsets(1,0);
+        std::vector<std::size_t> element_blocks;
+        element_offsets.reserve(gfs.gridView().size(0) + 1);
+        element_blocks.reserve(gfs.gridView().size(0) * gfs.maxLocalSize());
+        std::vector<Point> locations(curve ? blocks : 0,Point(0.0));
+        std::vector<std::size_t> location_counts(curve ? blocks : 0,0);
+
+        for (const auto& cell : elements(gfs.gridView()))
+          {
+            lfs.bind(cell);
+            lfs_cache.update();
+            const std::size_t begin = element_blocks.size();
+            for (std::size_t i = 0; i < lfs_cache.size(); ++i)
+              element_blocks.push_back(lfs_cache.containerIndex(i).back());
+            std::sort(element_blocks.begin() + begin,element_blocks.end());
+            element_blocks.erase(std::unique(element_blocks.begin() + begin,element_blocks.end()),element_blocks.end());
+            element_offsets.push_back(element_blocks.size());
+
+            if (curve)
+              {
+                const Point center = cell.geometry().center();
+                for (std::size_t i = begin; i < element_blocks.size(); ++i)
+                  {
+                    locations[element_blocks[i]] += center;
+                    ++location_counts[element_blocks[i]];
+                  }
+              }
+          }
+
+        std::vector<std::size_t> order;
+        if (curve)
+          {
+            for (std::size_t b = 0; b < blocks; ++b)
+              if (location_counts[b] > 0)
+                locations[b] /= location_counts[b];
+            space_filling_curve(locations,algorithm == PermutationAlgorithm::hilbertCurve,order);
+          }
+        else
+          {
+            DOFAdjacencyGraph graph(blocks,element_offsets,element_blocks);
+            if (algorithm == PermutationAlgorithm::reverseCuthillMcKee)
+              reverse_cuthill_mckee(graph,order);
+            else
+              nested_dissection(graph,order);
+          }
+
+        // the permutation maps old block indices to new ones
+        std::vector<std::size_t>& permutation = permuted_tag.permutation();
+        permutation.resize(blocks);
+        for (std::size_t k = 0; k < blocks; ++k)
+          permutation[order[k]] = k;
+      }
+
+    } // namespace ordering
+
+
     template<typename GFS, typename Transformation, typename U>
     struct power_gfs_to_local_ordering_descriptor<GFS,Transformation,ordering::Permuted<U> >
       : public power_gfs_to_local_ordering_descriptor<GFS,Transformation,U>
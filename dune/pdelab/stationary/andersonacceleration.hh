@@ -0,0 +1,383 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_STATIONARY_ANDERSONACCELERATION_HH
+#define DUNE_PDELAB_STATIONARY_ANDERSONACCELERATION_HH
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/ios_state.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/timer.hh>
+
+#include <dune/pdelab/backend/solver.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! Exception thrown by AndersonAcceleration
+    class AndersonAccelerationError : public Exception {};
+    //! Thrown if AndersonAcceleration does not converge within the maximum number of iterations
+    class AndersonAccelerationNotConverged : public AndersonAccelerationError {};
+
+    // Status information of the Anderson accelerated fixed point iteration
+    template<class RFType>
+    struct AndersonAccelerationResult : LinearSolverResult<RFType>
+    {
+      RFType first_defect;       // the first defect
+      RFType defect;             // the final defect
+      unsigned int restarts;     // number of times the history was discarded
+
+      AndersonAccelerationResult()
+        : first_defect(0.0)
+        , defect(0.0)
+        , restarts(0)
+      {}
+    };
+
+    //! Anderson acceleration (Anderson mixing) of a fixed point iteration.
+    /**
+     * Accelerates a fixed point map \f$x \mapsto G(x)\f$, typically a Picard
+     * step of a coupled problem, by combining the last \f$m\f$ iterates:
+     * with \f$f_k = G(x_k) - x_k\f$ the coefficients \f$\gamma\f$ minimize
+     * \f$\| f_k - \sum_j \gamma_j \Delta f_j \|\f$ and the new iterate is
+     *
+     * \f[ x_{k+1} = G(x_k) - \sum_j \gamma_j \Delta G_j
+     *             - (1-\beta) \Big(f_k - \sum_j \gamma_j \Delta f_j\Big). \f]
+     *
+     * For linear problems this is equivalent to GMRes on the fixed point
+     * residual, which is why the method is also known as nonlinear GMRes.
+     *
+     * The fixed point map is any object providing `apply(V& x)`, which
+     * replaces x by G(x), e.g. a StationaryLinearProblemSolver set up for the
+     * linearization of a nonlinear problem. Convergence is measured by the
+     * residual of the grid operator GO.
+     *
+     * The differences \f$\Delta f_j, \Delta G_j\f$ are kept in a ring buffer of
+     * preallocated vectors together with their Gram matrix, so an iteration
+     * needs only \f$O(m)\f$ inner products and no allocations. The vectors are
+     * kept across calls to apply() and are only reallocated if the size of the
+     * trial space changes.
+     *
+     * Inner products are the local dot products summed over the communicator of
+     * the grid view. On overlapping decompositions this weights overlap DOFs
+     * multiply, which still yields an inner product, so all ranks compute the
+     * same coefficients.
+     *
+     * \tparam GO grid operator defining the residual
+     * \tparam FP fixed point map
+     * \tparam V  vector type of the solution
+     */
+    template<typename GO, typename FP, typename V>
+    class AndersonAcceleration
+    {
+      typedef typename V::ElementType Real;
+      typedef typename GO::Traits::Range W;
+      typedef Dune::DynamicMatrix<Real> DenseMatrix;
+      typedef Dune::DynamicVector<Real> DenseVector;
+
+    public:
+      typedef AndersonAccelerationResult<Real> Result;
+
+      AndersonAcceleration(const GO& go, FP& fixed_point, unsigned int depth = 5)
+        : _go(go)
+        , _fixed_point(fixed_point)
+        , _depth(depth)
+        , _maxit(40)
+        , _reduction(1e-8)
+        , _abs_limit(1e-12)
+        , _damping(1.0)
+        , _regularization(1e-14)
+        , _verbose(1)
+      {
+        if (_go.trialGridFunctionSpace().gridView().comm().rank() > 0)
+          _verbose = 0;
+      }
+
+      //! Set the number of previous iterates used for mixing (0 disables the acceleration).
+      void setDepth(unsigned int depth)
+      {
+        if (depth != _depth)
+          {
+            _depth = depth;
+            _dF.clear();
+            _dG.clear();
+          }
+      }
+
+      void setMaxIterations(unsigned int maxit)
+      {
+        _maxit = maxit;
+      }
+
+      void setReduction(Real reduction)
+      {
+        _reduction = reduction;
+      }
+
+      void setAbsoluteLimit(Real abs_limit)
+      {
+        _abs_limit = abs_limit;
+      }
+
+      //! Set the mixing parameter \f$\beta \in (0,1]\f$.
+      void setDampingFactor(Real damping)
+      {
+        _damping = damping;
+      }
+
+      //! Set the relative Tikhonov regularization of the least squares problem.
+      void setRegularization(Real regularization)
+      {
+        _regularization = regularization;
+      }
+
+      void setVerbosityLevel(int verbose)
+      {
+        if (_go.trialGridFunctionSpace().gridView().comm().rank() > 0)
+          _verbose = 0;
+        else
+          _verbose = verbose;
+      }
+
+      //! interpret a parameter tree as a set of options
+      /**
+       * Understands the keys Depth, MaxIterations, Reduction, AbsoluteLimit,
+       * DampingFactor, Regularization and VerbosityLevel.
+       */
+      void setParameters(const Dune::ParameterTree& param)
+      {
+        if (param.hasKey("Depth"))
+          setDepth(param.get<unsigned int>("Depth"));
+        if (param.hasKey("MaxIterations"))
+          setMaxIterations(param.get<unsigned int>("MaxIterations"));
+        if (param.hasKey("Reduction"))
+          setReduction(param.get<Real>("Reduction"));
+        if (param.hasKey("AbsoluteLimit"))
+          setAbsoluteLimit(param.get<Real>("AbsoluteLimit"));
+        if (param.hasKey("DampingFactor"))
+          setDampingFactor(param.get<Real>("DampingFactor"));
+        if (param.hasKey("Regularization"))
+          setRegularization(param.get<Real>("Regularization"));
+        if (param.hasKey("VerbosityLevel"))
+          setVerbosityLevel(param.get<int>("VerbosityLevel"));
+      }
+
+      const Result& result() const
+      {
+        return _res;
+      }
+
+      void apply(V& x)
+      {
+        Dune::Timer watch;
+        ios_base_all_saver restorer(std::cout);
+
+        allocate(x);
+
+        _res = Result();
+        _history = 0;
+        _head = 0;
+
+        _res.first_defect = _res.defect = defect(x);
+        if (_verbose >= 2)
+          std::cout << "  Anderson initial defect: "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << _res.defect << std::endl;
+
+        while (!converged())
+          {
+            if (_res.iterations >= _maxit)
+              {
+                _res.elapsed = watch.elapsed();
+                DUNE_THROW(AndersonAccelerationNotConverged,
+                           "AndersonAcceleration::apply(): Maximum iteration count reached");
+              }
+
+            // g = G(x), f = g - x
+            *_g = x;
+            _fixed_point.apply(*_g);
+            *_f = *_g;
+            *_f -= x;
+
+            if (_res.iterations > 0 && _depth > 0)
+              pushDifferences();
+
+            // x = g - (1-beta) f, then subtract the mixing of the history
+            x = *_g;
+            x.axpy(_damping - 1.0, *_f);
+            if (_history > 0)
+              mix(x);
+
+            std::swap(_f, _f_prev);
+            std::swap(_g, _g_prev);
+
+            ++_res.iterations;
+            _res.defect = defect(x);
+
+            if (_verbose >= 2)
+              std::cout << "  Anderson iteration " << std::setw(2) << _res.iterations
+                        << " (depth " << _history << ").  New defect: "
+                        << std::setw(12) << std::setprecision(4) << std::scientific
+                        << _res.defect << std::endl;
+          }
+
+        _res.elapsed = watch.elapsed();
+        _res.reduction = _res.first_defect > 0 ? _res.defect/_res.first_defect : 0.0;
+        _res.conv_rate = _res.iterations > 0 ? std::pow(_res.reduction, 1.0/_res.iterations) : 0.0;
+
+        if (_verbose >= 1)
+          std::cout << "  Anderson acceleration converged after " << std::setw(2) << _res.iterations
+                    << " iterations.  Reduction: "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << _res.reduction
+                    << "   (" << std::setprecision(4) << _res.elapsed << "s)"
+                    << std::endl;
+      }
+
+    private:
+
+      bool converged()
+      {
+        _res.converged = _res.defect < _abs_limit
+          || _res.defect < _res.first_defect * _reduction;
+        return _res.converged;
+      }
+
+      Real dot(const V& a, const V& b) const
+      {
+        return _go.trialGridFunctionSpace().gridView().comm().sum(a.dot(b));
+      }
+
+      Real defect(const V& x)
+      {
+        *_r = 0.0;
+        _go.residual(x,*_r);
+        Real d = _r->two_norm();
+        d = std::sqrt(_go.testGridFunctionSpace().gridView().comm().sum(d*d));
+        if (!std::isfinite(d))
+          DUNE_THROW(AndersonAccelerationError,
+                     "AndersonAcceleration::defect(): defect is NaN or Inf");
+        return d;
+      }
+
+      //! set up the work vectors, keeping them if the space has not changed
+      void allocate(const V& x)
+      {
+        if (!_r || _r->N() != x.N())
+          {
+            _r = std::make_shared<W>(_go.testGridFunctionSpace());
+            _f = std::make_shared<V>(x);
+            _g = std::make_shared<V>(x);
+            _f_prev = std::make_shared<V>(x);
+            _g_prev = std::make_shared<V>(x);
+            _dF.clear();
+            _dG.clear();
+          }
+        if (_dF.size() != _depth)
+          {
+            _dF.clear();
+            _dG.clear();
+            for (unsigned int i = 0; i < _depth; ++i)
+              {
+                _dF.push_back(std::make_shared<V>(x));
+                _dG.push_back(std::make_shared<V>(x));
+              }
+            _gram.resize(_depth,_depth);
+          }
+      }
+
+      //! store f - f_prev and g - g_prev in the oldest slot and update the Gram matrix
+      void pushDifferences()
+      {
+        V& dF = *_dF[_head];
+        V& dG = *_dG[_head];
+        dF = *_f;
+        dF -= *_f_prev;
+        dG = *_g;
+        dG -= *_g_prev;
+
+        if (_history < _depth)
+          ++_history;
+        for (unsigned int j = 0; j < _history; ++j)
+          _gram[_head][j] = _gram[j][_head] = dot(dF,*_dF[j]);
+
+        _head = (_head + 1) % _depth;
+      }
+
+      //! solve the least squares problem and subtract the mixed differences from x
+      void mix(V& x)
+      {
+        DenseMatrix A(_history,_history);
+        DenseVector b(_history);
+        DenseVector gamma(_history);
+        Real scale = 0.0;
+        for (unsigned int i = 0; i < _history; ++i)
+          scale = std::max(scale,_gram[i][i]);
+        for (unsigned int i = 0; i < _history; ++i)
+          {
+            for (unsigned int j = 0; j < _history; ++j)
+              A[i][j] = _gram[i][j];
+            A[i][i] += _regularization * scale;
+            b[i] = dot(*_dF[i],*_f);
+          }
+
+        try
+          {
+            A.solve(gamma,b);
+          }
+        catch (Dune::FMatrixError&)
+          {
+            // the differences have become linearly dependent, start over
+            if (_verbose >= 3)
+              std::cout << "      Anderson history is singular - restarting" << std::endl;
+            _history = 0;
+            _head = 0;
+            ++_res.restarts;
+            return;
+          }
+
+        for (unsigned int j = 0; j < _history; ++j)
+          {
+            x.axpy(-gamma[j],*_dG[j]);
+            x.axpy((1.0 - _damping) * gamma[j],*_dF[j]);
+          }
+      }
+
+      const GO& _go;
+      FP& _fixed_point;
+      unsigned int _depth;
+      unsigned int _maxit;
+      Real _reduction;
+      Real _abs_limit;
+      Real _damping;
+      Real _regularization;
+      int _verbose;
+      Result _res;
+
+      // work vectors, allocated once
+      std::shared_ptr<W> _r;
+      std::shared_ptr<V> _f;
+      std::shared_ptr<V> _g;
+      std::shared_ptr<V> _f_prev;
+      std::shared_ptr<V> _g_prev;
+
+      // ring buffer of differences
+      std::vector<std::shared_ptr<V> > _dF;
+      std::vector<std::shared_ptr<V> > _dG;
+      DenseMatrix _gram;
+      unsigned int _history;
+      unsigned int _head;
+    };
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_STATIONARY_ANDERSONACCELERATION_HH
@@ -186,8 +186,10 @@ namespace Dune {
         // assemble matrix; optional: assemble only on demand!
         watch.reset();
 
+        // a freshly allocated matrix always has to be assembled
         if (!_jacobian)
           {
+            reuse_matrix = false;
             _jacobian = std::make_shared<M>(_go);
             timing = watch.elapsed();
             if (_go.trialGridFunctionSpace().gridView().comm().rank()==0 && _verbose>=1)
@@ -243,7 +245,13 @@ namespace Dune {
         typename V::ElementType red = std::max(_reduction,_min_defect/defect);
         if (_go.trialGridFunctionSpace().gridView().comm().rank()==0)
           std::cout << "=== solving (reduction: " << red << ") ";
+        // an unchanged matrix allows to keep the preconditioner as well
+        bool old_reuse = false;
+        if (reuse_matrix)
+          old_reuse = setLinearSolverReuse(_ls,true);
         _ls.apply(*_jacobian,z,r,red); // solver makes right hand side consistent
+        if (reuse_matrix)
+          setLinearSolverReuse(_ls,old_reuse);
         _linear_solver_result = _ls.result();
         timing = watch.elapsed();
         // timing = gos.trialGridFunctionSpace().gridView().comm().max(timing);
@@ -0,0 +1,204 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/adaptivity/adaptivity.hh>
+#include <dune/pdelab/backend/backendselector.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+
+// number of elements in the smallest set of the largest indicators, closed
+// under ties, that carries at least the given fraction
+std::size_t referenceRefine(std::vector<double> values, double fraction, bool weighted)
+{
+  std::sort(values.begin(),values.end(),std::greater<double>());
+  if (fraction <= 0.0 || values.empty() || values[0] <= 0.0)
+    return 0;
+  double total = 0.0;
+  for (const auto& v : values)
+    total += weighted ? v : 1.0;
+  double sum = 0.0;
+  for (std::size_t i = 0; i < values.size(); ++i)
+    {
+      sum += weighted ? values[i] : 1.0;
+      if (sum >= fraction*total)
+        {
+          while (i+1 < values.size() && values[i+1] == values[i])
+            ++i;
+          return i+1;
+        }
+    }
+  return values.size();
+}
+
+// number of elements in the largest set of the smallest indicators, closed
+// under ties, that carries at most the given fraction
+std::size_t referenceCoarsen(std::vector<double> values, double fraction, bool weighted)
+{
+  std::sort(values.begin(),values.end());
+  double total = 0.0;
+  for (const auto& v : values)
+    total += weighted ? v : 1.0;
+  double sum = 0.0;
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < values.size(); )
+    {
+      std::size_t j = i;
+      for (; j < values.size() && values[j] == values[i]; ++j)
+        sum += weighted ? values[j] : 1.0;
+      if (sum > fraction*total)
+        break;
+      count = j;
+      i = j;
+    }
+  return count;
+}
+
+std::size_t countAtLeast(const std::vector<double>& values, double eta)
+{
+  return std::count_if(values.begin(),values.end(),[eta](double v){ return v >= eta; });
+}
+
+std::size_t countBelow(const std::vector<double>& values, double eta)
+{
+  return std::count_if(values.begin(),values.end(),[eta](double v){ return v < eta; });
+}
+
+// compares the thresholds of all marking strategies with the sorted reference
+template<typename V>
+int check(const std::string& name, V& x, const std::vector<double>& values)
+{
+  std::copy(values.begin(),values.end(),x.begin());
+
+  int errors = 0;
+  const double fractions[] = {0.0, 0.1, 0.3, 0.5, 0.75, 0.9, 1.0};
+  for (const double fraction : fractions)
+    {
+      double eta_alpha, eta_beta;
+
+      Dune::PDELab::error_fraction(x,fraction,fraction,eta_alpha,eta_beta);
+      if (countAtLeast(values,eta_alpha) != referenceRefine(values,fraction,true))
+        {
+          std::cerr << name << ": error_fraction() refines " << countAtLeast(values,eta_alpha)
+                    << " instead of " << referenceRefine(values,fraction,true)
+                    << " elements for alpha=" << fraction << std::endl;
+          ++errors;
+        }
+      if (countBelow(values,eta_beta) != referenceCoarsen(values,fraction,true))
+        {
+          std::cerr << name << ": error_fraction() coarsens " << countBelow(values,eta_beta)
+                    << " instead of " << referenceCoarsen(values,fraction,true)
+                    << " elements for beta=" << fraction << std::endl;
+          ++errors;
+        }
+
+      Dune::PDELab::element_fraction(x,fraction,fraction,eta_alpha,eta_beta);
+      if (countAtLeast(values,eta_alpha) != referenceRefine(values,fraction,false))
+        {
+          std::cerr << name << ": element_fraction() refines " << countAtLeast(values,eta_alpha)
+                    << " instead of " << referenceRefine(values,fraction,false)
+                    << " elements for alpha=" << fraction << std::endl;
+          ++errors;
+        }
+      if (countBelow(values,eta_beta) != referenceCoarsen(values,fraction,false))
+        {
+          std::cerr << name << ": element_fraction() coarsens " << countBelow(values,eta_beta)
+                    << " instead of " << referenceCoarsen(values,fraction,false)
+                    << " elements for beta=" << fraction << std::endl;
+          ++errors;
+        }
+
+      const double maximum = *std::max_element(values.begin(),values.end());
+      Dune::PDELab::max_fraction(x,fraction,fraction,eta_alpha,eta_beta);
+      if (eta_alpha != fraction*maximum || eta_beta != fraction*maximum)
+        {
+          std::cerr << name << ": max_fraction() yields " << eta_alpha << " and " << eta_beta
+                    << " instead of " << fraction*maximum << std::endl;
+          ++errors;
+        }
+    }
+  return errors;
+}
+
+// The thresholds of the distributed selection have to mark the same elements
+// as thresholds taken from the sorted indicators, also with ties and zeros.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(16));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    GV gv = grid.leafGridView();
+
+    Dune::GeometryType gt;
+    gt.makeCube(2);
+    typedef Dune::PDELab::P0LocalFiniteElementMap<double,double,2> FEM;
+    FEM fem(gt);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef Dune::PDELab::BackendVectorSelector<GFS,double>::Type V;
+    V x(gfs,0.0);
+    const std::size_t n = gv.size(0);
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> level(0,16);
+    std::uniform_real_distribution<double> uniform(0.0,1.0);
+    std::vector<double> values(n);
+
+    int errors = 0;
+
+    // few distinct values, so most of them are tied; all of them are exact in the keys
+    for (auto& v : values)
+      v = level(generator)/16.0;
+    values[n/2] = 1.0;
+    errors += check("ties",x,values);
+
+    // random values, a fifth of them zero and some repeated
+    for (std::size_t i = 0; i < n; ++i)
+      {
+        const double r = uniform(generator);
+        if (r < 0.2)
+          values[i] = 0.0;
+        else if (r < 0.3 && i > 0)
+          values[i] = values[i-1];
+        else
+          values[i] = uniform(generator);
+      }
+    errors += check("random",x,values);
+
+    // no error at all
+    std::fill(values.begin(),values.end(),0.0);
+    errors += check("zero",x,values);
+
+    return errors > 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,175 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/defaultimp.hh>
+#include <dune/pdelab/localoperator/laplacedirichletccfv.hh>
+#include <dune/pdelab/stationary/andersonacceleration.hh>
+
+// Dirichlet boundary value
+template<typename GV, typename RF>
+class G
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  G<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,G<GV,RF> > BaseT;
+
+  G (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.3);
+    center -= x;
+    y = 1.0 + std::exp(-10.0*center.two_norm2());
+  }
+};
+
+// the finite volume Laplacian with the nonlinear reaction term u^3
+template<typename GF>
+class Reaction
+  : public Dune::PDELab::LaplaceDirichletCCFV<GF>,
+    public Dune::PDELab::NumericalJacobianApplyVolume<Reaction<GF> >,
+    public Dune::PDELab::NumericalJacobianVolume<Reaction<GF> >
+{
+public:
+  enum { doAlphaVolume = true };
+
+  Reaction (const GF& g) : Dune::PDELab::LaplaceDirichletCCFV<GF>(g) {}
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    const double u = x(lfsu,0);
+    r.accumulate(lfsv,0,u*u*u*eg.geometry().volume());
+  }
+};
+
+// the damped Richardson iteration x <- x - omega F(x) as a cheap fixed point map
+template<typename GO, typename V>
+class Richardson
+{
+public:
+  Richardson (const GO& go_, double omega_)
+    : go(go_), omega(omega_), r(go_.testGridFunctionSpace())
+  {}
+
+  void apply (V& x)
+  {
+    r = 0.0;
+    go.residual(x,r);
+    x.axpy(-omega,r);
+  }
+
+private:
+  const GO& go;
+  double omega;
+  V r;
+};
+
+// Anderson acceleration has to reach the solution of the plain fixed point
+// iteration in considerably fewer iterations, i.e. residual evaluations.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(8));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    GV gv = grid.leafGridView();
+
+    Dune::GeometryType gt;
+    gt.makeCube(2);
+    typedef Dune::PDELab::P0LocalFiniteElementMap<double,double,2> FEM;
+    FEM fem(gt);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef G<GV,double> GType;
+    GType g(gv);
+    typedef Reaction<GType> LOP;
+    LOP lop(g);
+    typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+    MBE mbe(5);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,double,double,double> GO;
+    GO go(gfs,gfs,lop,mbe);
+    typedef GO::Traits::Domain V;
+
+    // the diagonal of the Laplacian is at most 6, so omega = 1/6 yields a contraction
+    typedef Richardson<GO,V> FixedPoint;
+    FixedPoint richardson(go,1.0/6.0);
+
+    int result = 0;
+
+    // without history, the iteration is the plain fixed point iteration
+    Dune::PDELab::AndersonAcceleration<GO,FixedPoint,V> picard(go,richardson,0);
+    picard.setVerbosityLevel(0);
+    picard.setMaxIterations(2000);
+    V xpicard(gfs,1.0);
+    picard.apply(xpicard);
+
+    Dune::PDELab::AndersonAcceleration<GO,FixedPoint,V> anderson(go,richardson,5);
+    anderson.setVerbosityLevel(0);
+    anderson.setMaxIterations(2000);
+    V x(gfs,1.0);
+    anderson.apply(x);
+
+    std::cout << "fixed point iteration: " << picard.result().iterations << " iterations, "
+              << "Anderson acceleration: " << anderson.result().iterations << " iterations" << std::endl;
+    if (2*anderson.result().iterations > picard.result().iterations)
+      {
+        std::cerr << "Anderson acceleration did not halve the number of iterations" << std::endl;
+        result = 1;
+      }
+
+    V difference(x);
+    difference -= xpicard;
+    if (difference.infinity_norm() > 1e-6)
+      {
+        std::cerr << "Anderson acceleration converged to a different solution" << std::endl;
+        result = 1;
+      }
+
+    // the work vectors are kept, a second solve from the same start repeats the iteration
+    const unsigned int iterations = anderson.result().iterations;
+    V y(gfs,1.0);
+    anderson.apply(y);
+    y -= x;
+    if (anderson.result().iterations != iterations || y.infinity_norm() != 0.0)
+      {
+        std::cerr << "second solve with the same object differs from the first one" << std::endl;
+        result = 1;
+      }
+
+    return result;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,282 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/io/file/vtk/vtkwriter.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/backendselector.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/common/vtkexport.hh>
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/gridfunctionspace/asyncvtkwriter.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspaceutilities.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/gridfunctionspace/vtk.hh>
+
+typedef std::map<std::string,std::vector<double> > Arrays;
+
+template<typename GV, typename RF>
+class F
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  F<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,F<GV,RF> > BaseT;
+
+  F (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    y = std::sin(3.0*x[0]) * std::exp(x[1]);
+  }
+};
+
+std::string readFile(const std::string& filename)
+{
+  std::ifstream file(filename.c_str(),std::ios::binary);
+  if (!file)
+    DUNE_THROW(Dune::IOError,"could not open " << filename);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+std::string attribute(const std::string& tag, const std::string& name)
+{
+  const std::string key = " " + name + "=\"";
+  const std::size_t begin = tag.find(key);
+  if (begin == std::string::npos)
+    return std::string();
+  const std::size_t end = tag.find('"',begin + key.size());
+  return tag.substr(begin + key.size(),end - begin - key.size());
+}
+
+// the data arrays of a file written by Dune::VTKWriter in ascii format
+Arrays readAscii(const std::string& filename)
+{
+  const std::string s = readFile(filename);
+  Arrays arrays;
+  std::size_t pos = 0;
+  while ((pos = s.find("<DataArray",pos)) != std::string::npos)
+    {
+      const std::size_t end = s.find('>',pos);
+      const std::size_t close = s.find("</DataArray>",end);
+      std::vector<double>& array = arrays[attribute(s.substr(pos,end - pos),"Name")];
+      std::istringstream values(s.substr(end + 1,close - end - 1));
+      double v;
+      while (values >> v)
+        array.push_back(v);
+      pos = close;
+    }
+  return arrays;
+}
+
+template<typename T>
+void convert(const std::vector<char>& bytes, std::vector<double>& values)
+{
+  for (std::size_t i = 0; i + sizeof(T) <= bytes.size(); i += sizeof(T))
+    {
+      T v;
+      std::memcpy(&v,bytes.data() + i,sizeof(T));
+      values.push_back(v);
+    }
+}
+
+std::uint64_t readHeader(const std::string& s, std::size_t pos)
+{
+  std::uint64_t v;
+  std::memcpy(&v,s.data() + pos,sizeof(v));
+  return v;
+}
+
+// the bytes of an appended array, see AsyncVTKWriter::compressArray() for the compressed layout
+std::vector<char> appendedBytes(const std::string& s, std::size_t pos, bool compressed)
+{
+  std::vector<char> bytes;
+  if (!compressed)
+    {
+      const std::uint64_t size = readHeader(s,pos);
+      bytes.assign(s.begin() + pos + sizeof(std::uint64_t),s.begin() + pos + sizeof(std::uint64_t) + size);
+      return bytes;
+    }
+#if HAVE_ZLIB
+  const std::uint64_t blocks = readHeader(s,pos);
+  const std::uint64_t block_size = readHeader(s,pos + 8);
+  const std::uint64_t last_size = readHeader(s,pos + 16);
+  std::size_t data = pos + (3 + blocks) * sizeof(std::uint64_t);
+  for (std::uint64_t b = 0; b < blocks; ++b)
+    {
+      const std::uint64_t compressed_size = readHeader(s,pos + (3 + b) * sizeof(std::uint64_t));
+      uLongf size = (b + 1 == blocks && last_size > 0) ? last_size : block_size;
+      std::vector<Bytef> block(size);
+      if (uncompress(block.data(),&size,reinterpret_cast<const Bytef*>(s.data() + data),compressed_size) != Z_OK)
+        DUNE_THROW(Dune::IOError,"zlib failed to uncompress a data array");
+      bytes.insert(bytes.end(),block.begin(),block.begin() + size);
+      data += compressed_size;
+    }
+#else
+  DUNE_THROW(Dune::IOError,"compressed data array without zlib");
+#endif
+  return bytes;
+}
+
+// the data arrays of a file written by AsyncVTKWriter
+Arrays readAppended(const std::string& filename, bool& compressed)
+{
+  const std::string s = readFile(filename);
+  const std::size_t appended = s.find("<AppendedData encoding=\"raw\">");
+  const std::size_t base = s.find('_',appended) + 1;
+  compressed = s.find("compressor=\"vtkZLibDataCompressor\"") < appended;
+  Arrays arrays;
+  std::size_t pos = 0;
+  while ((pos = s.find("<DataArray",pos)) < appended)
+    {
+      const std::string tag = s.substr(pos,s.find('>',pos) - pos);
+      const std::string type = attribute(tag,"type");
+      const std::vector<char> bytes = appendedBytes(s,base + std::stoull(attribute(tag,"offset")),compressed);
+      std::vector<double>& array = arrays[attribute(tag,"Name")];
+      if (type == "Float32")
+        convert<float>(bytes,array);
+      else if (type == "Float64")
+        convert<double>(bytes,array);
+      else if (type == "Int64")
+        convert<std::int64_t>(bytes,array);
+      else if (type == "UInt8")
+        convert<std::uint8_t>(bytes,array);
+      else
+        DUNE_THROW(Dune::IOError,"unexpected data array type " << type);
+      ++pos;
+    }
+  return arrays;
+}
+
+// every array of the reference has to be present with the same values
+int compare(const std::string& name, const Arrays& reference, const Arrays& arrays)
+{
+  int errors = 0;
+  for (const auto& entry : reference)
+    {
+      const auto it = arrays.find(entry.first);
+      if (it == arrays.end() || it->second.size() != entry.second.size())
+        {
+          std::cerr << name << ": data array " << entry.first << " is missing or has the wrong size" << std::endl;
+          ++errors;
+          continue;
+        }
+      // the ascii output is written with the precision of Float32
+      for (std::size_t i = 0; i < entry.second.size(); ++i)
+        if (std::abs(it->second[i] - entry.second[i]) > 1e-5 * (1.0 + std::abs(entry.second[i])))
+          {
+            std::cerr << name << ": entry " << i << " of " << entry.first << " is " << it->second[i]
+                      << " instead of " << entry.second[i] << std::endl;
+            ++errors;
+            break;
+          }
+    }
+  return errors;
+}
+
+// AsyncVTKWriter has to write the same mesh and data as the synchronous
+// nonconforming VTKWriter, with and without compression, and the snapshot
+// must not change when the solution is modified during the output.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(8));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    GV gv = grid.leafGridView();
+
+    typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+    FEM fem(gv);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+    gfs.name("u");
+
+    typedef Dune::PDELab::BackendVectorSelector<GFS,double>::Type V;
+    V x(gfs,0.0);
+    F<GV,double> f(gv);
+    Dune::PDELab::interpolate(f,gfs,x);
+
+    typedef Dune::PDELab::DiscreteGridFunction<GFS,V> DGF;
+    DGF dgf(gfs,x);
+    typedef Dune::PDELab::VTKGridFunctionAdapter<DGF> Adapter;
+    std::shared_ptr<Adapter> celldata = std::make_shared<Adapter>(dgf,"cell");
+
+    Dune::VTKWriter<GV> vtkwriter(gv,Dune::VTK::nonconforming);
+    Dune::PDELab::addSolutionToVTKWriter(vtkwriter,gfs,x);
+    vtkwriter.addCellData(celldata);
+    vtkwriter.write("asyncvtk_reference",Dune::VTK::ascii);
+    const Arrays reference = readAscii("asyncvtk_reference.vtu");
+
+    int errors = 0;
+    const bool settings[] = {false, true};
+    for (const bool compress : settings)
+      {
+        const std::string name = compress ? "asyncvtk_compressed" : "asyncvtk_raw";
+        Dune::PDELab::AsyncVTKWriter<GV> writer(gv,false);
+        Dune::PDELab::addSolutionToVTKWriter(writer,gfs,x);
+        writer.addCellData(celldata);
+        writer.setCompression(compress);
+        writer.write(name);
+
+        // the values have been collected, changing them does not affect the pending output
+        x *= 2.0;
+        writer.wait();
+        x *= 0.5;
+
+        bool compressed;
+        const Arrays arrays = readAppended(name + ".vtu",compressed);
+        if (compressed != writer.compression())
+          {
+            std::cerr << name << ": compression is " << (compressed ? "on" : "off") << std::endl;
+            ++errors;
+          }
+        errors += compare(name,reference,arrays);
+      }
+#if HAVE_ZLIB
+    std::cout << "compared the raw and the compressed output" << std::endl;
+#else
+    std::cout << "compared the raw output, compression is not available without zlib" << std::endl;
+#endif
+
+    return errors > 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
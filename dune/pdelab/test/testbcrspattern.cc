@@ -0,0 +1,166 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/array.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/pdelab/backend/istl/bcrspattern.hh>
+
+// the part of the ordering interface used by BCRSPattern
+struct Ordering
+{
+  struct Traits
+  {
+    typedef std::size_t size_type;
+  };
+
+  explicit Ordering(std::size_t blocks)
+    : _blocks(blocks)
+  {}
+
+  std::size_t blockCount() const
+  {
+    return _blocks;
+  }
+
+  std::size_t _blocks;
+};
+
+typedef Dune::PDELab::istl::BCRSPattern<Ordering,Ordering> Pattern;
+typedef Dune::array<std::size_t,1> Index;
+
+// The links of biquadratic elements on a structured n x n grid. Neighbouring
+// elements share nodes, so most links are added several times, and there are
+// enough links to fill several batches of the link collection.
+void fillPattern(Pattern& pattern, int n)
+{
+  const int nodes_per_direction = 2*n+1;
+  for (int ey = 0; ey < n; ++ey)
+    for (int ex = 0; ex < n; ++ex)
+      {
+        std::vector<std::size_t> dofs;
+        for (int y = 0; y < 3; ++y)
+          for (int x = 0; x < 3; ++x)
+            dofs.push_back((2*ey+y)*nodes_per_direction + 2*ex+x);
+        for (std::size_t i = 0; i < dofs.size(); ++i)
+          for (std::size_t j = 0; j < dofs.size(); ++j)
+            {
+              Index ri = {{dofs[i]}};
+              Index ci = {{dofs[j]}};
+              pattern.add_link(ri,ci);
+            }
+      }
+}
+
+// the sorted column indices of all rows
+std::vector<std::vector<std::size_t> > columns(const Pattern& pattern, std::size_t rows)
+{
+  std::vector<std::vector<std::size_t> > result(rows);
+  for (std::size_t i = 0; i < rows; ++i)
+    {
+      for (Pattern::iterator it = pattern.begin(i); it != pattern.end(i); ++it)
+        result[i].push_back(*it);
+      std::sort(result[i].begin(),result[i].end());
+    }
+  return result;
+}
+
+int compare(const char* name, const Pattern& reference, const Pattern& pattern, std::size_t rows)
+{
+  if (reference.sizes() != pattern.sizes())
+    {
+      std::cerr << name << ": row sizes differ from the fixed estimate" << std::endl;
+      return 1;
+    }
+  if (columns(reference,rows) != columns(pattern,rows))
+    {
+      std::cerr << name << ": columns differ from the fixed estimate" << std::endl;
+      return 1;
+    }
+  if (pattern.overflowCount() > 0)
+    {
+      std::cerr << name << ": " << pattern.overflowCount() << " links in the overflow area" << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    const int n = 60;
+    const std::size_t rows = (2*n+1)*(2*n+1);
+    Ordering ordering(rows);
+
+    // reference: a low estimate, so that many links end up in the overflow area
+    Pattern reference(ordering,ordering,5);
+    fillPattern(reference,n);
+    if (reference.overflowCount() == 0)
+      {
+        std::cerr << "the reference pattern does not use the overflow area" << std::endl;
+        return 1;
+      }
+
+    int result = 0;
+
+    Pattern counted(ordering,ordering,0);
+    counted.beginRowCounting();
+    fillPattern(counted,n);
+    counted.endRowCounting();
+    fillPattern(counted,n);
+    result += compare("countedRows",reference,counted,rows);
+
+    // the counts include duplicates, compacting releases the padding
+    const std::size_t counted_entries = counted.entriesPerRow();
+    counted.compact();
+    result += compare("countedRows after compact()",reference,counted,rows);
+    if (counted.entriesPerRow() >= counted_entries)
+      {
+        std::cerr << "compact() did not release the padding of the counted rows" << std::endl;
+        result = 1;
+      }
+
+    Pattern sorted(ordering,ordering,0);
+    sorted.beginLinkCollection();
+    fillPattern(sorted,n);
+    sorted.endLinkCollection();
+    result += compare("sortedLinks",reference,sorted,rows);
+
+    // the sorted rows are stored without padding
+    const std::vector<std::size_t> sizes = sorted.sizes();
+    std::size_t entries = 0;
+    for (std::size_t i = 0; i < rows; ++i)
+      entries += sizes[i];
+    if (sorted.entriesPerRow() != (entries + rows - 1) / rows)
+      {
+        std::cerr << "sortedLinks reserved more entries than needed" << std::endl;
+        result = 1;
+      }
+    if (counted.entriesPerRow() != sorted.entriesPerRow())
+      {
+        std::cerr << "compact() kept more entries than needed" << std::endl;
+        result = 1;
+      }
+
+    return result > 0 ? 1 : 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,186 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/common/boundingboxtree.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/common/functionutilities.hh>
+
+// a smooth function, so the value does not depend on the element a point is found in
+template<typename GV, typename RF>
+class F
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  F<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,F<GV,RF> > BaseT;
+
+  F (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    y = std::sin(3.0*x[0]) * std::exp(x[1]);
+  }
+};
+
+// interior points, points on faces and vertices of the 4x4 grid, on the
+// boundary, and outside of the unit square
+template<typename Domain>
+std::vector<Domain> probePoints()
+{
+  const double coordinates[][2] = {
+    {0.3, 0.6}, {0.9, 0.1},
+    {0.25, 0.6}, {0.3, 0.5},
+    {0.5, 0.5}, {0.25, 0.75},
+    {0.0, 0.3}, {0.0, 0.0}, {1.0, 1.0},
+    {1.5, 0.5}, {-0.1, 0.2}, {0.5, 1.001}
+  };
+  std::vector<Domain> points;
+  for (const auto& c : coordinates)
+    {
+      Domain x;
+      x[0] = c[0];
+      x[1] = c[1];
+      points.push_back(x);
+    }
+  return points;
+}
+
+// compares the tree, the probes and the probe set with the hierarchic search
+template<typename GF, typename Tree>
+int check(const char* name, const GF& f, const Tree& tree,
+          const Dune::PDELab::GridFunctionProbeSet<GF>& set)
+{
+  typedef typename GF::Traits::DomainType Domain;
+  typedef typename GF::Traits::RangeType Range;
+
+  int errors = 0;
+  std::vector<Range> values;
+  set.eval_all(values);
+  for (std::size_t i = 0; i < set.size(); ++i)
+    {
+      const Domain& x = set.points()[i];
+      Range reference, probed;
+      Dune::PDELab::GridFunctionProbe<GF>(f,x).eval_all(reference);
+      Dune::PDELab::GridFunctionProbe<GF>(f,x,tree).eval_all(probed);
+      const bool inside = !std::isnan(reference[0]);
+
+      typename Tree::Entity entity;
+      typename Tree::LocalCoordinate local;
+      const bool found = tree.findEntity(x,entity,local);
+      if (found != inside)
+        {
+          std::cerr << name << ": point (" << x << ") is " << (found ? "" : "not ")
+                    << "found by the tree, but " << (inside ? "" : "not ")
+                    << "by the hierarchic search" << std::endl;
+          ++errors;
+          continue;
+        }
+
+      if (!inside)
+        {
+          if (!std::isnan(probed[0]) || !std::isnan(values[i][0]))
+            {
+              std::cerr << name << ": point (" << x << ") outside the grid has a value" << std::endl;
+              ++errors;
+            }
+          continue;
+        }
+
+      Domain distance = entity.geometry().global(local);
+      distance -= x;
+      if (distance.two_norm() > 1e-12)
+        {
+          std::cerr << name << ": element found for (" << x << ") does not contain it" << std::endl;
+          ++errors;
+        }
+      if (std::abs(probed[0] - reference[0]) > 1e-12 || std::abs(values[i][0] - reference[0]) > 1e-12)
+        {
+          std::cerr << name << ": value at (" << x << ") is " << probed[0] << " and "
+                    << values[i][0] << " instead of " << reference[0] << std::endl;
+          ++errors;
+        }
+    }
+  return errors;
+}
+
+// Point location with the bounding box tree has to agree with the hierarchic
+// search, also on faces and vertices, and the tree has to be rebuilt after
+// the grid has been refined.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(4));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    GV gv = grid.leafGridView();
+
+    typedef F<GV,double> GF;
+    GF f(gv);
+    typedef Dune::PDELab::GridFunctionProbeSet<GF> ProbeSet;
+    typedef ProbeSet::Tree Tree;
+    const std::vector<GF::Traits::DomainType> points = probePoints<GF::Traits::DomainType>();
+
+    int errors = 0;
+
+    // one element per leaf and the default leaf size
+    Tree single(gv,1);
+    ProbeSet own(f,points);
+    errors += check("leaf size 1",f,single,own);
+
+    std::shared_ptr<Tree> tree(new Tree(gv));
+    ProbeSet shared(f,points,tree);
+    errors += check("leaf size 8",f,*tree,shared);
+
+    // refining invalidates the tree, relocating the points rebuilds it
+    grid.globalRefine(1);
+    if (tree->valid())
+      {
+        std::cerr << "tree is still valid after refinement" << std::endl;
+        ++errors;
+      }
+    try {
+      Tree::Entity entity;
+      Tree::LocalCoordinate local;
+      tree->findEntity(points[0],entity,local);
+      std::cerr << "outdated tree has been queried without an exception" << std::endl;
+      ++errors;
+    }
+    catch (Dune::InvalidStateException&) {}
+
+    shared.relocate();
+    if (!tree->valid() || tree->size() != std::size_t(gv.size(0)))
+      {
+        std::cerr << "relocate() did not rebuild the shared tree" << std::endl;
+        ++errors;
+      }
+    errors += check("refined",f,*tree,shared);
+
+    return errors > 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
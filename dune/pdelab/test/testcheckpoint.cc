@@ -0,0 +1,121 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/backendselector.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/gridfunctionspace/checkpoint.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+
+// a reader must reject a record on all ranks with an InvalidStateException
+template<typename Reader, typename GFS, typename V>
+int expectRejection(const char* what, Reader& reader, const std::string& name, const GFS& gfs, V& x)
+{
+  try {
+    reader.read(name,gfs,x);
+  }
+  catch (Dune::InvalidStateException&)
+    {
+      return 0;
+    }
+  std::cerr << what << " was not rejected" << std::endl;
+  return 1;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(4));
+    Dune::YaspGrid<2> grid(L,N);
+    grid.globalRefine(1);
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    GV gv = grid.leafGridView();
+
+    typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> Q1FEM;
+    Q1FEM q1fem(gv);
+    typedef Dune::PDELab::GridFunctionSpace<GV,Q1FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > Q1GFS;
+    Q1GFS q1gfs(gv,q1fem);
+    typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> Q2FEM;
+    Q2FEM q2fem(gv);
+    typedef Dune::PDELab::GridFunctionSpace<GV,Q2FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > Q2GFS;
+    Q2GFS q2gfs(gv,q2fem);
+
+    typedef Dune::PDELab::BackendVectorSelector<Q1GFS,double>::Type V1;
+    typedef Dune::PDELab::BackendVectorSelector<Q2GFS,double>::Type V2;
+    V1 x(q1gfs);
+    double value = 0.5;
+    for (auto it = x.begin(); it != x.end(); ++it, value += 1.0)
+      *it = value;
+    std::vector<std::int32_t> steps(3);
+    steps[0] = 1; steps[1] = 2; steps[2] = 3;
+
+    {
+      Dune::PDELab::CheckpointWriter<GV> writer(gv,"testcheckpoint");
+      writer.write("solution",q1gfs,x);
+      writer.write("time",1.25);
+      writer.write("steps",steps);
+      writer.close();
+    }
+
+    int result = 0;
+    Dune::PDELab::CheckpointReader<GV> reader(gv,"testcheckpoint");
+
+    // round trip
+    V1 y(q1gfs,0.0);
+    reader.read("solution",q1gfs,y);
+    V1 difference(y);
+    difference -= x;
+    if (difference.infinity_norm() != 0.0)
+      {
+        std::cerr << "restored vector differs from the stored one" << std::endl;
+        result = 1;
+      }
+    double time = 0.0;
+    reader.read("time",time);
+    std::vector<std::int32_t> restored_steps;
+    reader.read("steps",restored_steps);
+    if (time != 1.25 || restored_steps != steps)
+      {
+        std::cerr << "restored scalar state differs from the stored one" << std::endl;
+        result = 1;
+      }
+    if (!reader.has("solution/signature") || reader.has("velocity"))
+      {
+        std::cerr << "wrong records reported by has()" << std::endl;
+        result = 1;
+      }
+
+    // mismatching layouts and missing records
+    V2 z(q2gfs,0.0);
+    result += expectRejection("vector with a different DOF layout",reader,"solution",q2gfs,z);
+    result += expectRejection("missing vector record",reader,"velocity",q1gfs,y);
+    result += expectRejection("record that is not a vector",reader,"time",q1gfs,y);
+
+    return result > 0 ? 1 : 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,172 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/geometry/quadraturerules.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/backendselector.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspaceutilities.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+
+template<typename GV, typename RF>
+class F
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  F<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,F<GV,RF> > BaseT;
+
+  F (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    y = std::sin(3.0*x[0]) * std::exp(x[1]);
+  }
+};
+
+// Evaluates both functions at the points of a quadrature rule on every
+// element, visiting every element twice in a row and once more after its
+// neighbour, and returns the largest difference.
+template<typename GV, typename DGF>
+double maxDifference(const GV& gv, const DGF& cached, const DGF& uncached)
+{
+  typedef typename DGF::Traits::RangeType Range;
+  const auto& rule = Dune::QuadratureRules<double,GV::dimension>::rule(Dune::GeometryType(Dune::GeometryType::cube,GV::dimension),3);
+  double difference = 0.0;
+  Range y, yref;
+  std::vector<Range> ys;
+  auto previous = *elements(gv).begin();
+  for (const auto& e : elements(gv))
+    {
+      for (int pass = 0; pass < 2; ++pass)
+        for (const auto& qp : rule)
+          {
+            cached.evaluate(e,qp.position(),y);
+            uncached.evaluate(e,qp.position(),yref);
+            difference = std::max(difference,std::abs(y[0] - yref[0]));
+          }
+      for (const auto& qp : rule)
+        {
+          cached.evaluate(previous,qp.position(),y);
+          uncached.evaluate(previous,qp.position(),yref);
+          difference = std::max(difference,std::abs(y[0] - yref[0]));
+        }
+
+      // the batched evaluation binds the element once for all points
+      cached.evaluate(e,rule,ys);
+      std::size_t q = 0;
+      for (const auto& qp : rule)
+        {
+          uncached.evaluate(e,qp.position(),yref);
+          difference = std::max(difference,std::abs(ys[q++][0] - yref[0]));
+        }
+      previous = e;
+    }
+  return difference;
+}
+
+// A cached DiscreteGridFunction has to yield exactly the values of an uncached
+// one, and it has to pick up changed coefficients after invalidateCache().
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(8));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    GV gv = grid.leafGridView();
+
+    typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+    FEM fem(gv);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef Dune::PDELab::BackendVectorSelector<GFS,double>::Type V;
+    V x(gfs,0.0);
+    F<GV,double> f(gv);
+    Dune::PDELab::interpolate(f,gfs,x);
+
+    typedef Dune::PDELab::DiscreteGridFunction<GFS,V> DGF;
+    DGF cached(gfs,x);
+    cached.setCaching(true);
+    DGF uncached(gfs,x);
+
+    int result = 0;
+
+    double difference = maxDifference(gv,cached,uncached);
+    if (difference != 0.0)
+      {
+        std::cerr << "cached evaluation differs by " << difference << std::endl;
+        result = 1;
+      }
+
+    // the cached function keeps the old coefficients of the last element until it is invalidated
+    const auto element = *elements(gv).begin();
+    DGF::Traits::DomainType center(0.5);
+    DGF::Traits::RangeType before, stale, after, reference;
+    cached.evaluate(element,center,before);
+    x *= 2.0;
+    cached.evaluate(element,center,stale);
+    if (stale[0] != before[0])
+      {
+        std::cerr << "the cached element was rebound without invalidateCache()" << std::endl;
+        result = 1;
+      }
+    cached.invalidateCache();
+    cached.evaluate(element,center,after);
+    uncached.evaluate(element,center,reference);
+    if (after[0] != reference[0] || std::abs(after[0] - 2.0*before[0]) > 1e-14 * std::abs(after[0]))
+      {
+        std::cerr << "invalidateCache() did not pick up the changed coefficients" << std::endl;
+        result = 1;
+      }
+
+    difference = maxDifference(gv,cached,uncached);
+    if (difference != 0.0)
+      {
+        std::cerr << "cached evaluation differs by " << difference << " after invalidateCache()" << std::endl;
+        result = 1;
+      }
+
+    // disabling the cache rebinds on every call
+    cached.setCaching(false);
+    x *= 0.5;
+    cached.evaluate(element,center,after);
+    uncached.evaluate(element,center,reference);
+    if (after[0] != reference[0])
+      {
+        std::cerr << "disabled cache still returned stale values" << std::endl;
+        result = 1;
+      }
+
+    return result;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,171 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/gridoperator/onestep.hh>
+#include <dune/pdelab/instationary/explicitblockdiagonal.hh>
+#include <dune/pdelab/instationary/onestep.hh>
+#include <dune/pdelab/localoperator/l2.hh>
+#include <dune/pdelab/localoperator/laplacedirichletccfv.hh>
+
+// initial value and Dirichlet boundary value
+template<typename GV, typename RF>
+class G
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  G<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,G<GV,RF> > BaseT;
+
+  G (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.3);
+    center -= x;
+    y = std::exp(-10.0*center.two_norm2());
+  }
+};
+
+// the finite volume Laplacian as spatial part of an instationary problem
+template<typename GF>
+class Diffusion
+  : public Dune::PDELab::LaplaceDirichletCCFV<GF>,
+    public Dune::PDELab::InstationaryLocalOperatorDefaultMethods<double>
+{
+public:
+  Diffusion (const GF& g) : Dune::PDELab::LaplaceDirichletCCFV<GF>(g) {}
+};
+
+// advances both schemes by the given number of steps from time
+template<typename Reference, typename Scheme, typename V, typename RF>
+void advance(Reference& reference, Scheme& scheme, V& xref, V& x, RF& time, RF dt, int steps)
+{
+  V xnew(x);
+  for (int i = 0; i < steps; ++i)
+    {
+      reference.apply(time,dt,xref,xnew);
+      xref = xnew;
+      scheme.apply(time,dt,x,xnew);
+      x = xnew;
+      time += dt;
+    }
+}
+
+// Applying the precomputed inverse mass blocks has to reproduce the explicit
+// scheme that solves with the assembled diagonal in every stage, also after
+// switching the method.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+    Dune::YaspGrid<2> grid(L,N);
+    grid.globalRefine(3);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    typedef double RF;
+    GV gv = grid.leafGridView();
+
+    Dune::GeometryType gt;
+    gt.makeCube(2);
+    typedef Dune::PDELab::P0LocalFiniteElementMap<double,RF,2> FEM;
+    FEM fem(gt);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef G<GV,RF> GType;
+    GType g(gv);
+
+    typedef Diffusion<GType> LOP;
+    LOP lop(g);
+    typedef Dune::PDELab::L2 TLOP;
+    TLOP tlop(2);
+
+    typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+    MBE mbe(5);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF> GO0;
+    GO0 go0(gfs,gfs,lop,mbe);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,TLOP,MBE,RF,RF,RF> GO1;
+    GO1 go1(gfs,gfs,tlop,mbe);
+    typedef Dune::PDELab::OneStepGridOperator<GO0,GO1,false> IGO;
+    IGO igo(go0,go1);
+
+    typedef IGO::Traits::Domain V;
+    V xinit(gfs);
+    Dune::PDELab::interpolate(g,gfs,xinit);
+
+    // below the stability limit 0.25 h^2 of the explicit Euler scheme
+    const RF dt = 0.002;
+    const int steps = 10;
+
+    typedef Dune::PDELab::ISTLBackend_SEQ_ExplicitDiagonal LS;
+    LS ls;
+    Dune::PDELab::Shu3Parameter<RF> shu3;
+    Dune::PDELab::ExplicitOneStepMethod<RF,IGO,LS,V,V> reference(shu3,igo,ls);
+    reference.setVerbosityLevel(0);
+    Dune::PDELab::ExplicitBlockDiagonalOneStepMethod<RF,IGO,V> blockdiagonal(shu3,igo);
+    blockdiagonal.setVerbosityLevel(0);
+
+    V xref(xinit);
+    V x(xinit);
+    RF time = 0.0;
+    advance(reference,blockdiagonal,xref,x,time,dt,steps);
+
+    // the inverse mass blocks are assembled anew after the invalidation
+    Dune::PDELab::HeunParameter<RF> heun;
+    reference.setMethod(heun);
+    blockdiagonal.setMethod(heun);
+    blockdiagonal.invalidateMassMatrix();
+    advance(reference,blockdiagonal,xref,x,time,dt,steps);
+
+    V change(xref);
+    change -= xinit;
+    V difference(x);
+    difference -= xref;
+    std::cout << "change of the solution: " << change.two_norm()
+              << ", difference between the schemes: " << difference.two_norm() << std::endl;
+    if (change.two_norm() < 1e-3*xinit.two_norm())
+      {
+        std::cerr << "solution did not evolve" << std::endl;
+        return 1;
+      }
+    if (difference.two_norm() > 1e-12*xref.two_norm())
+      {
+        std::cerr << "block diagonal scheme differs from the explicit scheme" << std::endl;
+        return 1;
+      }
+
+    return 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,229 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/laplacedirichletccfv.hh>
+
+typedef Dune::FieldVector<double,2> Point;
+
+// initial guess and Dirichlet boundary value
+template<typename GV, typename RF>
+class G
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  G<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,G<GV,RF> > BaseT;
+
+  G (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.3);
+    center -= x;
+    y = std::exp(-10.0*center.two_norm2());
+  }
+};
+
+// the finite volume Laplacian with a reaction term that records the order
+// in which the residual assembly visits the elements
+template<typename GF>
+class Recording
+  : public Dune::PDELab::LaplaceDirichletCCFV<GF>
+{
+public:
+  enum { doAlphaVolume = true };
+
+  Recording (const GF& g) : Dune::PDELab::LaplaceDirichletCCFV<GF>(g), visits(0) {}
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    if (visits)
+      visits->push_back(eg.geometry().center());
+    r.accumulate(lfsv,0,x(lfsu,0)*eg.geometry().volume());
+  }
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename M>
+  void jacobian_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, M& mat) const
+  {
+    mat.accumulate(lfsv,0,lfsu,0,eg.geometry().volume());
+  }
+
+  std::vector<Point>* visits;
+};
+
+bool lexicographic (const Point& a, const Point& b)
+{
+  return a[0] < b[0] || (a[0] == b[0] && a[1] < b[1]);
+}
+
+// every element has to be visited once, and along the Hilbert curve on the
+// uniform grid consecutive elements share a face
+int checkCurve (const std::string& name, std::vector<Point> visits, std::size_t elements, double h)
+{
+  int errors = 0;
+  for (std::size_t k = 1; k < visits.size(); ++k)
+    {
+      Point step(visits[k]);
+      step -= visits[k-1];
+      if (std::abs(step.two_norm() - h) > 1e-12)
+        {
+          std::cerr << name << ": elements " << k-1 << " and " << k << " of the traversal at ("
+                    << visits[k-1] << ") and (" << visits[k] << ") are not neighbors" << std::endl;
+          ++errors;
+          break;
+        }
+    }
+  std::sort(visits.begin(),visits.end(),lexicographic);
+  visits.erase(std::unique(visits.begin(),visits.end()),visits.end());
+  if (visits.size() != elements)
+    {
+      std::cerr << name << ": " << visits.size() << " of " << elements << " elements visited" << std::endl;
+      ++errors;
+    }
+  return errors;
+}
+
+// assembles residual and matrix with the native and the Hilbert curve
+// traversal, which have to agree up to round-off
+template<typename GO, typename LOP, typename V>
+int compare (const std::string& name, GO& go, LOP& lop, const V& x, double h)
+{
+  typedef typename GO::Assembler Assembler;
+  typedef typename GO::Traits::Jacobian M;
+
+  int errors = 0;
+  std::vector<Point> visits;
+  lop.visits = &visits;
+
+  go.assembler().setTraversal(Assembler::Traversal::native);
+  V r(go.testGridFunctionSpace(),0.0);
+  go.residual(x,r);
+  M m(go);
+  m = 0.0;
+  go.jacobian(x,m);
+  if (visits.size() != std::size_t(x.N()))
+    {
+      std::cerr << name << ": native traversal visited " << visits.size() << " elements" << std::endl;
+      ++errors;
+    }
+
+  visits.clear();
+  go.assembler().setTraversal(Assembler::Traversal::hilbertCurve);
+  V rh(go.testGridFunctionSpace(),0.0);
+  go.residual(x,rh);
+  M mh(go);
+  mh = 0.0;
+  go.jacobian(x,mh);
+  errors += checkCurve(name,visits,x.N(),h);
+
+  rh -= r;
+  if (rh.infinity_norm() > 1e-12*r.infinity_norm())
+    {
+      std::cerr << name << ": residuals differ by " << rh.infinity_norm() << std::endl;
+      ++errors;
+    }
+  mh.base() -= m.base();
+  if (mh.base().infinity_norm() > 1e-12*m.base().infinity_norm())
+    {
+      std::cerr << name << ": matrices differ by " << mh.base().infinity_norm() << std::endl;
+      ++errors;
+    }
+
+  lop.visits = 0;
+  return errors;
+}
+
+// Assembling along the Hilbert curve has to visit every element once in the
+// order of the curve and give the same residual and matrix as the native
+// traversal, also after the grid has been refined.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+    Dune::YaspGrid<2> grid(L,N);
+    grid.globalRefine(3);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    GV gv = grid.leafGridView();
+
+    Dune::GeometryType gt;
+    gt.makeCube(2);
+    typedef Dune::PDELab::P0LocalFiniteElementMap<double,double,2> FEM;
+    FEM fem(gt);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef G<GV,double> GType;
+    GType g(gv);
+    typedef Recording<GType> LOP;
+    LOP lop(g);
+    typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+    MBE mbe(5);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,double,double,double> GO;
+    GO go(gfs,gfs,lop,mbe);
+    typedef GO::Traits::Domain V;
+
+    int errors = 0;
+    {
+      V x(gfs);
+      Dune::PDELab::interpolate(g,gfs,x);
+      errors += compare("8x8",go,lop,x,1.0/8.0);
+    }
+
+    // the stored order no longer matches the number of elements and is recomputed
+    grid.globalRefine(1);
+    gfs.update();
+    {
+      V x(gfs);
+      Dune::PDELab::interpolate(g,gfs,x);
+      std::vector<Point> visits;
+      lop.visits = &visits;
+      V r(gfs,0.0);
+      go.residual(x,r);
+      lop.visits = 0;
+      errors += checkCurve("refined",visits,x.N(),1.0/16.0);
+
+      // the grid operator is updated as after grid adaptation
+      go.update();
+      errors += compare("16x16",go,lop,x,1.0/16.0);
+    }
+
+    return errors > 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
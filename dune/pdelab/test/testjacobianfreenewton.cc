@@ -0,0 +1,268 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/gridoperator/onestep.hh>
+#include <dune/pdelab/instationary/onestep.hh>
+#include <dune/pdelab/localoperator/defaultimp.hh>
+#include <dune/pdelab/localoperator/l2.hh>
+#include <dune/pdelab/localoperator/laplacedirichletccfv.hh>
+#include <dune/pdelab/newton/jacobianfree.hh>
+#include <dune/pdelab/newton/newton.hh>
+
+// initial guess and Dirichlet boundary value
+template<typename GV, typename RF>
+class G
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  G<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,G<GV,RF> > BaseT;
+
+  G (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.3);
+    center -= x;
+    y = 1.0 + std::exp(-10.0*center.two_norm2());
+  }
+};
+
+// the finite volume Laplacian as spatial part of an instationary problem
+template<typename GF>
+class Diffusion
+  : public Dune::PDELab::LaplaceDirichletCCFV<GF>,
+    public Dune::PDELab::InstationaryLocalOperatorDefaultMethods<double>
+{
+public:
+  Diffusion (const GF& g) : Dune::PDELab::LaplaceDirichletCCFV<GF>(g) {}
+};
+
+// the finite volume Laplacian with the nonlinear reaction term u^3
+template<typename GF>
+class Reaction
+  : public Dune::PDELab::LaplaceDirichletCCFV<GF>,
+    public Dune::PDELab::NumericalJacobianApplyVolume<Reaction<GF> >,
+    public Dune::PDELab::NumericalJacobianVolume<Reaction<GF> >
+{
+public:
+  enum { doAlphaVolume = true };
+
+  Reaction (const GF& g) : Dune::PDELab::LaplaceDirichletCCFV<GF>(g) {}
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    const double u = x(lfsu,0);
+    r.accumulate(lfsv,0,u*u*u*eg.geometry().volume());
+  }
+};
+
+template<typename V>
+double difference(const V& x, const V& y)
+{
+  V d(x);
+  d -= y;
+  return d.infinity_norm();
+}
+
+// the Jacobian-free solver reproduces Newton with the assembled Jacobian
+template<typename GO, typename V, typename GF>
+int testStationary(const char* name, GO& go, const GF& g, bool linear)
+{
+  typedef typename GO::Traits::TrialGridFunctionSpace GFS;
+  const GFS& gfs = go.trialGridFunctionSpace();
+  int result = 0;
+
+  typedef Dune::PDELab::ISTLBackend_SEQ_BCGS_SSOR LS;
+  LS ls(5000,0);
+  V reference(gfs);
+  Dune::PDELab::interpolate(g,gfs,reference);
+  Dune::PDELab::Newton<GO,LS,V> newton(go,reference,ls);
+  newton.setVerbosityLevel(0);
+  newton.setReduction(1e-10);
+  newton.apply();
+
+  typedef Dune::PDELab::ISTLBackend_SEQ_JacobianFree_GMRES_SSOR JFLS;
+  JFLS jfls(100,5000,0);
+  for (int use_jacobian_apply = 0; use_jacobian_apply < 2; ++use_jacobian_apply)
+    {
+      V x(gfs);
+      Dune::PDELab::interpolate(g,gfs,x);
+      Dune::PDELab::JacobianFreeNewton<GO,JFLS,V> jfnewton(go,x,jfls);
+      jfnewton.setVerbosityLevel(0);
+      jfnewton.setReduction(1e-10);
+      jfnewton.setUseJacobianApply(use_jacobian_apply);
+      try {
+        jfnewton.apply();
+      }
+      catch (Dune::PDELab::NewtonJacobianApplyError&)
+        {
+          if (linear || !use_jacobian_apply)
+            {
+              std::cerr << name << ": jacobian_apply() was rejected for a linear problem" << std::endl;
+              result = 1;
+            }
+          continue;
+        }
+      if (!linear && use_jacobian_apply)
+        {
+          std::cerr << name << ": jacobian_apply() was accepted for a nonlinear problem" << std::endl;
+          result = 1;
+        }
+      else if (difference(x,reference) > 1e-6)
+        {
+          std::cerr << name << ": solution differs by " << difference(x,reference)
+                    << " from Newton with the assembled Jacobian" << std::endl;
+          result = 1;
+        }
+    }
+  return result;
+}
+
+// the one step grid operator has no jacobian_apply(), so only finite differences work
+template<typename IGO, typename V, typename GF>
+int testInstationary(IGO& igo, const GF& g)
+{
+  typedef typename IGO::Traits::TrialGridFunctionSpace GFS;
+  const GFS& gfs = igo.trialGridFunctionSpace();
+  int result = 0;
+
+  V xinit(gfs);
+  Dune::PDELab::interpolate(g,gfs,xinit);
+  Dune::PDELab::ImplicitEulerParameter<double> method;
+  const double dt = 0.01;
+  const int steps = 5;
+
+  typedef Dune::PDELab::ISTLBackend_SEQ_BCGS_SSOR LS;
+  LS ls(5000,0);
+  typedef Dune::PDELab::Newton<IGO,LS,V> Solver;
+  Solver newton(igo,ls);
+  newton.setVerbosityLevel(0);
+  newton.setReduction(1e-10);
+  Dune::PDELab::OneStepMethod<double,IGO,Solver,V,V> reference(method,igo,newton);
+  reference.setVerbosityLevel(0);
+
+  typedef Dune::PDELab::ISTLBackend_SEQ_JacobianFree_GMRES_SSOR JFLS;
+  JFLS jfls(100,5000,0);
+  typedef Dune::PDELab::JacobianFreeNewton<IGO,JFLS,V> JFSolver;
+  JFSolver jfnewton(igo,jfls);
+  jfnewton.setVerbosityLevel(0);
+  jfnewton.setReduction(1e-10);
+  Dune::PDELab::OneStepMethod<double,IGO,JFSolver,V,V> jacobianfree(method,igo,jfnewton);
+  jacobianfree.setVerbosityLevel(0);
+
+  V xref(xinit), xrefnew(gfs), x(xinit), xnew(gfs);
+  double time = 0.0;
+  for (int i = 0; i < steps; ++i, time += dt)
+    {
+      reference.apply(time,dt,xref,xrefnew);
+      xref = xrefnew;
+      jacobianfree.apply(time,dt,x,xnew);
+      x = xnew;
+    }
+  if (difference(x,xref) > 1e-6)
+    {
+      std::cerr << "one step: solution differs by " << difference(x,xref)
+                << " from Newton with the assembled Jacobian" << std::endl;
+      result = 1;
+    }
+
+  bool thrown = false;
+  try {
+    jfnewton.setUseJacobianApply(true);
+  }
+  catch (Dune::NotImplemented&)
+    {
+      thrown = true;
+    }
+  if (!thrown)
+    {
+      std::cerr << "one step: jacobian_apply() was enabled without being available" << std::endl;
+      result = 1;
+    }
+  return result;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+    Dune::YaspGrid<2> grid(L,N);
+    grid.globalRefine(4);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    typedef double RF;
+    GV gv = grid.leafGridView();
+
+    Dune::GeometryType gt;
+    gt.makeCube(2);
+    typedef Dune::PDELab::P0LocalFiniteElementMap<double,RF,2> FEM;
+    FEM fem(gt);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef G<GV,RF> GType;
+    GType g(gv);
+
+    typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+    MBE mbe(5);
+
+    int result = 0;
+
+    typedef Diffusion<GType> LOP;
+    LOP lop(g);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF> GO0;
+    GO0 go0(gfs,gfs,lop,mbe);
+    typedef GO0::Traits::Domain V;
+    result += testStationary<GO0,V>("linear",go0,g,true);
+
+    typedef Reaction<GType> NLOP;
+    NLOP nlop(g);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,NLOP,MBE,RF,RF,RF> NGO;
+    NGO ngo(gfs,gfs,nlop,mbe);
+    result += testStationary<NGO,V>("nonlinear",ngo,g,false);
+
+    typedef Dune::PDELab::L2 TLOP;
+    TLOP tlop(2);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,TLOP,MBE,RF,RF,RF> GO1;
+    GO1 go1(gfs,gfs,tlop,mbe);
+    typedef Dune::PDELab::OneStepGridOperator<GO0,GO1> IGO;
+    IGO igo(go0,go1);
+    result += testInstationary<IGO,V>(igo,g);
+
+    return result > 0 ? 1 : 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,220 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/gridoperator/onestep.hh>
+#include <dune/pdelab/instationary/onestep.hh>
+#include <dune/pdelab/localoperator/defaultimp.hh>
+#include <dune/pdelab/localoperator/flags.hh>
+#include <dune/pdelab/localoperator/l2.hh>
+#include <dune/pdelab/localoperator/laplacedirichletccfv.hh>
+#include <dune/pdelab/localoperator/pattern.hh>
+#include <dune/pdelab/stationary/linearproblem.hh>
+
+// initial value and Dirichlet boundary value
+template<typename GV, typename RF>
+class G
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  G<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,G<GV,RF> > BaseT;
+
+  G (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.3);
+    center -= x;
+    y = std::exp(-10.0*center.two_norm2());
+  }
+};
+
+// the finite volume Laplacian as spatial part of an instationary problem
+template<typename GF>
+class Diffusion
+  : public Dune::PDELab::LaplaceDirichletCCFV<GF>,
+    public Dune::PDELab::InstationaryLocalOperatorDefaultMethods<double>
+{
+public:
+  Diffusion (const GF& g) : Dune::PDELab::LaplaceDirichletCCFV<GF>(g) {}
+};
+
+// a linear reaction with a cubic flux between the cells: for constant
+// vectors the flux vanishes and the residual is affine
+class CubicFlux
+  : public Dune::PDELab::NumericalJacobianApplySkeleton<CubicFlux>,
+    public Dune::PDELab::NumericalJacobianApplyVolume<CubicFlux>,
+    public Dune::PDELab::NumericalJacobianSkeleton<CubicFlux>,
+    public Dune::PDELab::NumericalJacobianVolume<CubicFlux>,
+    public Dune::PDELab::FullSkeletonPattern,
+    public Dune::PDELab::FullVolumePattern,
+    public Dune::PDELab::LocalOperatorDefaultFlags,
+    public Dune::PDELab::InstationaryLocalOperatorDefaultMethods<double>
+{
+public:
+  enum { doPatternVolume = true };
+  enum { doPatternSkeleton = true };
+  enum { doAlphaVolume = true };
+  enum { doAlphaSkeleton = true };
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    r.accumulate(lfsv,0,x(lfsu,0)*eg.geometry().volume());
+  }
+
+  template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_skeleton (const IG& ig,
+                       const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+                       const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+                       R& r_s, R& r_n) const
+  {
+    auto distance = ig.inside()->geometry().center();
+    distance -= ig.outside()->geometry().center();
+    const double u = x_s(lfsu_s,0) - x_n(lfsu_n,0);
+    const double flux = u*u*u*ig.geometry().volume()/distance.two_norm();
+    r_s.accumulate(lfsv_s,0,flux);
+    r_n.accumulate(lfsv_n,0,-flux);
+  }
+};
+
+// runs the given number of steps of the two stage SDIRK scheme
+template<typename IGO, typename V>
+void solve (IGO& igo, V& x, double dt, int steps)
+{
+  typedef Dune::PDELab::ISTLBackend_SEQ_BCGS_SSOR LS;
+  LS ls(5000,0);
+  typedef Dune::PDELab::StationaryLinearProblemSolver<IGO,LS,V> Solver;
+  Solver solver(igo,ls,x,1e-12,1e-99,0);
+  Dune::PDELab::Alexander2Parameter<double> alexander2;
+  Dune::PDELab::OneStepMethod<double,IGO,Solver,V,V> osm(alexander2,igo,solver);
+  osm.setVerbosityLevel(0);
+  V xnew(x);
+  double time = 0.0;
+  for (int i = 0; i < steps; ++i, time += dt)
+    {
+      osm.apply(time,dt,x,xnew);
+      x = xnew;
+    }
+}
+
+// With stored matrices, the one step grid operator has to reproduce the
+// assembled stage systems of a linear problem, and it has to reject an
+// operator that is only affine along the constant vectors.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+    Dune::YaspGrid<2> grid(L,N);
+    grid.globalRefine(3);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    typedef double RF;
+    GV gv = grid.leafGridView();
+
+    Dune::GeometryType gt;
+    gt.makeCube(2);
+    typedef Dune::PDELab::P0LocalFiniteElementMap<double,RF,2> FEM;
+    FEM fem(gt);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef G<GV,RF> GType;
+    GType g(gv);
+
+    typedef Diffusion<GType> LOP;
+    LOP lop(g);
+    typedef Dune::PDELab::L2 TLOP;
+    TLOP tlop(2);
+
+    typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+    MBE mbe(5);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF> GO0;
+    GO0 go0(gfs,gfs,lop,mbe);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,TLOP,MBE,RF,RF,RF> GO1;
+    GO1 go1(gfs,gfs,tlop,mbe);
+    typedef Dune::PDELab::OneStepGridOperator<GO0,GO1> IGO;
+    IGO igo(go0,go1);
+
+    typedef IGO::Traits::Domain V;
+    V xinit(gfs);
+    Dune::PDELab::interpolate(g,gfs,xinit);
+
+    const double dt = 0.01;
+    const int steps = 5;
+    int result = 0;
+
+    V xref(xinit);
+    solve(igo,xref,dt,steps);
+
+    IGO linear(go0,go1);
+    linear.setLinearInstationaryMode(true);
+    linear.setTimeDependentSource(false,false);
+    V x(xinit);
+    solve(linear,x,dt,steps);
+
+    V difference(x);
+    difference -= xref;
+    if (difference.two_norm() > 1e-8*xref.two_norm())
+      {
+        std::cerr << "solution with stored matrices differs by " << difference.two_norm() << std::endl;
+        result = 1;
+      }
+
+    CubicFlux cubic;
+    typedef Dune::PDELab::GridOperator<GFS,GFS,CubicFlux,MBE,RF,RF,RF> NGO0;
+    NGO0 ngo0(gfs,gfs,cubic,mbe);
+    typedef Dune::PDELab::OneStepGridOperator<NGO0,GO1> NIGO;
+    NIGO nonlinear(ngo0,go1);
+    nonlinear.setLinearInstationaryMode(true);
+    bool rejected = false;
+    try {
+      V y(xinit);
+      solve(nonlinear,y,dt,1);
+    }
+    catch (Dune::Exception& e)
+      {
+        rejected = std::string(e.what()).find("affine") != std::string::npos;
+      }
+    if (!rejected)
+      {
+        std::cerr << "the nonlinear operator has not been rejected" << std::endl;
+        result = 1;
+      }
+
+    return result;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,216 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/adaptivity/adaptivity.hh>
+#include <dune/pdelab/backend/backendselector.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+
+// a bilinear function, which the Q1 space represents exactly on every level
+template<typename GV, typename RF>
+class F
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  F<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,F<GV,RF> > BaseT;
+
+  F (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    y = 1.0 + x[0] + 2.0*x[1] + 3.0*x[0]*x[1];
+  }
+};
+
+typedef Dune::PDELab::LocalCoefficientArena<int,double> Arena;
+
+// appends a block and fills it with the given values
+void append(Arena& arena, int id, const std::vector<double>& values)
+{
+  Arena::Block block = arena.block(arena.append(id,values.size()));
+  for (std::size_t i = 0; i < values.size(); ++i)
+    block[i] = values[i];
+}
+
+// looks up a block and compares it with the expected values
+int expect(const Arena& arena, int id, const std::vector<double>& values)
+{
+  Arena::ConstBlock block;
+  if (!arena.find(id,block))
+    {
+      std::cerr << "arena: no block for ID " << id << std::endl;
+      return 1;
+    }
+  if (block.size() != values.size())
+    {
+      std::cerr << "arena: block of ID " << id << " has " << block.size()
+                << " instead of " << values.size() << " coefficients" << std::endl;
+      return 1;
+    }
+  for (std::size_t i = 0; i < values.size(); ++i)
+    if (block[i] != values[i])
+      {
+        std::cerr << "arena: coefficient " << i << " of ID " << id << " is " << block[i]
+                  << " instead of " << values[i] << std::endl;
+        return 1;
+      }
+  return 0;
+}
+
+int expectMissing(const Arena& arena, int id)
+{
+  Arena::ConstBlock block;
+  if (arena.find(id,block))
+    {
+      std::cerr << "arena: found a block for the missing ID " << id << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+// blocks appended out of order, with duplicates and empty blocks, have to
+// be found by ID after finalize(), also after the arena has been cleared
+int checkArena()
+{
+  const std::vector<double> a = {1.0, 2.0};
+  const std::vector<double> b = {3.0, 4.0, 5.0};
+  const std::vector<double> c = {6.0};
+  const std::vector<double> empty;
+
+  int errors = 0;
+  Arena arena;
+  arena.reserve(2,4);
+  append(arena,7,a);
+  append(arena,3,b);
+  append(arena,7,a);
+  append(arena,5,empty);
+  append(arena,-2,c);
+  arena.finalize();
+
+  if (arena.size() != 4)
+    {
+      std::cerr << "arena: " << arena.size() << " instead of 4 blocks after finalize()" << std::endl;
+      ++errors;
+    }
+  errors += expect(arena,7,a);
+  errors += expect(arena,3,b);
+  errors += expect(arena,5,empty);
+  errors += expect(arena,-2,c);
+  errors += expectMissing(arena,4);
+  errors += expectMissing(arena,-3);
+  errors += expectMissing(arena,8);
+
+  arena.clear();
+  if (arena.size() != 0 || arena.coefficients() != 0)
+    {
+      std::cerr << "arena: not empty after clear()" << std::endl;
+      ++errors;
+    }
+  errors += expectMissing(arena,7);
+  append(arena,4,c);
+  arena.finalize();
+  errors += expect(arena,4,c);
+  errors += expectMissing(arena,3);
+  return errors;
+}
+
+template<typename GFS, typename GF>
+int compare(const std::string& name, const GFS& gfs, const GF& f,
+            const typename Dune::PDELab::BackendVectorSelector<GFS,double>::Type& x)
+{
+  typedef typename Dune::PDELab::BackendVectorSelector<GFS,double>::Type V;
+  V reference(gfs);
+  Dune::PDELab::interpolate(f,gfs,reference);
+  reference -= x;
+  if (reference.infinity_norm() > 1e-12)
+    {
+      std::cerr << name << ": transferred solution differs by " << reference.infinity_norm() << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+// The arena has to store and find the local coefficients by ID, replaying a
+// backup on the unchanged grid has to restore the solution, and the solution
+// transfer to refined grids has to reproduce a function from the space.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    int errors = checkArena();
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(4));
+    typedef Dune::YaspGrid<2> Grid;
+    Grid grid(L,N);
+
+    typedef Grid::LeafGridView GV;
+    GV gv = grid.leafGridView();
+
+    typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+    FEM fem(gv);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef Dune::PDELab::BackendVectorSelector<GFS,double>::Type V;
+    V x(gfs);
+    F<GV,double> f(gv);
+    Dune::PDELab::interpolate(f,gfs,x);
+
+    // the backup holds one block per element, the replay copies them back
+    typedef Dune::PDELab::L2Projection<GFS,V> Projection;
+    Projection projection(gfs,2);
+    typedef Dune::PDELab::GridAdaptor<Grid,GFS,V,Projection> Adaptor;
+    Adaptor adaptor(gfs);
+    Adaptor::MapType transfer_map;
+    adaptor.backupData(grid,gfs,projection,x,transfer_map);
+    if (transfer_map.size() != std::size_t(gv.size(0)))
+      {
+        std::cerr << "backup holds " << transfer_map.size() << " blocks for "
+                  << gv.size(0) << " elements" << std::endl;
+        ++errors;
+      }
+    V y(gfs,0.0);
+    adaptor.replayData(grid,gfs,projection,y,transfer_map);
+    errors += compare("unchanged grid",gfs,f,y);
+
+    // the new elements are interpolated from the blocks of their fathers
+    for (int level = 1; level <= 2; ++level)
+      {
+        for (const auto& cell : elements(gv))
+          grid.mark(1,cell);
+        Dune::PDELab::adapt_grid(grid,gfs,x,2);
+        errors += compare("refinement " + std::to_string(level),gfs,f,x);
+      }
+
+    return errors > 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
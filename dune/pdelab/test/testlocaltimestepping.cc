@@ -0,0 +1,195 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/gridoperator/onestep.hh>
+#include <dune/pdelab/instationary/explicitblockdiagonal.hh>
+#include <dune/pdelab/instationary/localtimestepping.hh>
+#include <dune/pdelab/localoperator/l2.hh>
+#include <dune/pdelab/localoperator/laplacedirichletccfv.hh>
+#include <dune/pdelab/localoperator/localtimestepping.hh>
+
+// initial value and Dirichlet boundary value
+template<typename GV, typename RF>
+class G
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  G<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,G<GV,RF> > BaseT;
+
+  G (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.3);
+    center -= x;
+    y = std::exp(-10.0*center.two_norm2());
+  }
+};
+
+// the finite volume Laplacian as spatial part of an instationary problem
+template<typename GF>
+class Diffusion
+  : public Dune::PDELab::LaplaceDirichletCCFV<GF>,
+    public Dune::PDELab::InstationaryLocalOperatorDefaultMethods<double>
+{
+public:
+  Diffusion (const GF& g) : Dune::PDELab::LaplaceDirichletCCFV<GF>(g) {}
+};
+
+// the admissible time step is the same on all elements
+struct UniformTimestep
+{
+  template<typename Element>
+  double operator() (const Element& e) const
+  {
+    return 0.002;
+  }
+};
+
+// With a single level, local time stepping takes one explicit Euler step
+// per macro step and has to reproduce the single-rate scheme up to round-off.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+    Dune::YaspGrid<2> grid(L,N);
+    grid.globalRefine(3);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    typedef double RF;
+    GV gv = grid.leafGridView();
+
+    Dune::GeometryType gt;
+    gt.makeCube(2);
+    typedef Dune::PDELab::P0LocalFiniteElementMap<double,RF,2> FEM;
+    FEM fem(gt);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef G<GV,RF> GType;
+    GType g(gv);
+
+    typedef Diffusion<GType> LOP;
+    LOP lop(g);
+    typedef Dune::PDELab::L2 TLOP;
+    TLOP tlop(2);
+
+    typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+    MBE mbe(5);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF> GO0;
+    GO0 go0(gfs,gfs,lop,mbe);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,TLOP,MBE,RF,RF,RF> GO1;
+    GO1 go1(gfs,gfs,tlop,mbe);
+    typedef Dune::PDELab::OneStepGridOperator<GO0,GO1,false> IGO;
+    IGO igo(go0,go1);
+
+    typedef Dune::PDELab::LocalTimeSteppingLevels<GV,RF> Levels;
+    Levels levels(gv,3);
+    levels.update(UniformTimestep());
+    if (levels.maxLevel() != 0 || levels.substeps() != 1)
+      {
+        std::cerr << "uniform time steps yield " << levels.maxLevel()+1 << " levels" << std::endl;
+        return 1;
+      }
+
+    typedef Dune::PDELab::LocalTimeSteppingLocalOperator<LOP,Levels,RF> LTSLOP;
+    LTSLOP ltslop(lop,levels);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,LTSLOP,MBE,RF,RF,RF> LTSGO0;
+    LTSGO0 ltsgo0(gfs,gfs,ltslop,mbe);
+    typedef Dune::PDELab::OneStepGridOperator<LTSGO0,GO1,false> LTSIGO;
+    LTSIGO ltsigo(ltsgo0,go1);
+
+    typedef IGO::Traits::Domain V;
+    V xinit(gfs);
+    Dune::PDELab::interpolate(g,gfs,xinit);
+
+    const RF dt = levels.macroTimestep();
+    const int steps = 10;
+
+    // reference: explicit Euler with the same block diagonal mass matrix
+    Dune::PDELab::ExplicitEulerParameter<RF> euler;
+    Dune::PDELab::ExplicitBlockDiagonalOneStepMethod<RF,IGO,V> reference(euler,igo);
+    reference.setVerbosityLevel(0);
+    V xref(xinit);
+    V xrefnew(gfs);
+    RF time = 0.0;
+    for (int i = 0; i < steps; ++i)
+      {
+        reference.apply(time,dt,xref,xrefnew);
+        xref = xrefnew;
+        time += dt;
+      }
+
+    Dune::PDELab::LocalTimeSteppingOneStepMethod<RF,LTSIGO,Levels,V> lts(ltsigo,levels);
+    lts.setVerbosityLevel(0);
+    V x(xinit);
+    V xnew(gfs);
+    time = 0.0;
+    for (int i = 0; i < steps; ++i)
+      {
+        lts.apply(time,dt,x,xnew);
+        x = xnew;
+        time += dt;
+      }
+
+    int result = 0;
+
+    V change(xref);
+    change -= xinit;
+    V difference(x);
+    difference -= xref;
+    std::cout << "change of the solution: " << change.two_norm()
+              << ", difference between the schemes: " << difference.two_norm() << std::endl;
+    if (change.two_norm() < 1e-3*xinit.two_norm())
+      {
+        std::cerr << "solution did not evolve" << std::endl;
+        result = 1;
+      }
+    if (difference.two_norm() > 1e-12*xref.two_norm())
+      {
+        std::cerr << "local time stepping differs from the single-rate scheme" << std::endl;
+        result = 1;
+      }
+
+    // the assembler is left as it was before the macro steps
+    if (ltsigo.assembler().getTraversal() != LTSIGO::Assembler::Traversal::native)
+      {
+        std::cerr << "local time stepping did not restore the traversal of the assembler" << std::endl;
+        result = 1;
+      }
+
+    return result;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
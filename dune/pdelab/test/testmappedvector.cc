@@ -0,0 +1,139 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/pdelab/backend/simple/mappedvector.hh>
+
+typedef Dune::PDELab::simple::MappedVector<double> Vector;
+
+// the lowest free file descriptor, which open() is required to return
+int freeDescriptor()
+{
+  const int fd = ::open("/dev/null",O_RDONLY);
+  ::close(fd);
+  return fd;
+}
+
+// resizing keeps the data and zero initializes new entries
+int testResize()
+{
+  Vector v(10,1.0);
+  v.resize(1000);
+  for (std::size_t i = 0; i < v.size(); ++i)
+    if (v[i] != (i < 10 ? 1.0 : 0.0))
+      {
+        std::cerr << "wrong entry " << v[i] << " at " << i << " after growing" << std::endl;
+        return 1;
+      }
+  v[5] = 2.0;
+  v.resize(6);
+  if (v.size() != 6 || v[5] != 2.0 || v[0] != 1.0)
+    {
+      std::cerr << "wrong data after shrinking" << std::endl;
+      return 1;
+    }
+  Vector w(v);
+  w[0] = 3.0;
+  if (v[0] != 1.0 || w.size() != 6 || w[5] != 2.0)
+    {
+      std::cerr << "copy shares the storage of its source" << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+// evicted data is read back from the file, also after reopening it
+int testEvict(const std::string& filename)
+{
+  {
+    Vector v(filename,Vector::Mode::create);
+    v.resize(100000);
+    for (std::size_t i = 0; i < v.size(); ++i)
+      v[i] = i;
+    v.evict();
+    for (std::size_t i = 0; i < v.size(); ++i)
+      if (v[i] != i)
+        {
+          std::cerr << "wrong entry " << v[i] << " at " << i << " after evict()" << std::endl;
+          return 1;
+        }
+  }
+
+  Vector v(filename,Vector::Mode::readOnly);
+  if (v.size() != 100000 || v[99999] != 99999.0)
+    {
+      std::cerr << "reopened file has the wrong contents" << std::endl;
+      return 1;
+    }
+  try {
+    v.resize(10);
+  }
+  catch (Dune::InvalidStateException&)
+    {
+      return 0;
+    }
+  std::cerr << "read only mapping was resized" << std::endl;
+  return 1;
+}
+
+// a file that cannot be mapped is rejected without leaking its descriptor
+int testInvalidFile(const std::string& filename)
+{
+  std::FILE* file = std::fopen(filename.c_str(),"wb");
+  std::fputs("abc",file);
+  std::fclose(file);
+
+  const int fd = freeDescriptor();
+  bool thrown = false;
+  try {
+    Vector v(filename,Vector::Mode::open);
+  }
+  catch (Dune::IOError&)
+    {
+      thrown = true;
+    }
+  if (!thrown)
+    {
+      std::cerr << "file of 3 bytes was mapped as a vector of doubles" << std::endl;
+      return 1;
+    }
+  if (freeDescriptor() != fd)
+    {
+      std::cerr << "file descriptor leaked by the failed constructor" << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    int result = 0;
+    result += testResize();
+    result += testEvict("testmappedvector.dat");
+    result += testInvalidFile("testmappedvector-invalid.dat");
+    return result > 0 ? 1 : 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
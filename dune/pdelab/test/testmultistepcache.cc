@@ -0,0 +1,215 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/pdelab/multistep/cache.hh>
+
+// a container with a known memory footprint
+struct Vector
+{
+  explicit Vector(std::size_t n) : data(n) {}
+  std::vector<double> data;
+};
+
+std::size_t multiStepCacheBytes(const Vector& v)
+{
+  return v.data.size() * sizeof(double);
+}
+
+// a container without an overload of multiStepCacheBytes(), like the PETSc ones
+struct Opaque
+{
+  explicit Opaque(std::size_t n) : data(n) {}
+  std::vector<double> data;
+};
+
+typedef Dune::PDELab::MultiStepCache<Vector,Vector,Vector> Cache;
+typedef Dune::PDELab::MemoryBoundedMultiStepCachePolicy<> BoundedPolicy;
+
+// a memory bounded policy that allows to reuse Jacobians of other steps
+struct ReusingPolicy : public BoundedPolicy
+{
+  explicit ReusingPolicy(std::size_t budget) : BoundedPolicy(budget) {}
+  virtual bool canReuseJacobian(std::size_t order, int requested, int available) const
+  { return true; }
+};
+
+const std::size_t n = 100;
+const std::size_t bytes = n * sizeof(double);
+
+bool inCache(Cache& cache, std::size_t order, int step)
+{
+  try {
+    cache.getResidualValue(order,step);
+  }
+  catch (Dune::PDELab::NotInCache&)
+    {
+      return false;
+    }
+  return true;
+}
+
+// the least recently used items are evicted when the budget is exceeded
+int testEviction()
+{
+  std::shared_ptr<BoundedPolicy> policy(new BoundedPolicy(3*bytes));
+  Cache cache(policy);
+  int result = 0;
+
+  for (int step = 1; step <= 3; ++step)
+    cache.setResidualValue(0,step,std::make_shared<const Vector>(n));
+  if (policy->bytesUsed() != 3*bytes || !inCache(cache,0,1))
+    {
+      std::cerr << "items within the budget were evicted" << std::endl;
+      result = 1;
+    }
+
+  // step 1 has just been accessed, so step 2 is the least recently used one
+  cache.setResidualValue(0,4,std::make_shared<const Vector>(n));
+  if (policy->bytesUsed() != 3*bytes || inCache(cache,0,2)
+      || !inCache(cache,0,1) || !inCache(cache,0,3) || !inCache(cache,0,4))
+    {
+      std::cerr << "the least recently used item was not evicted" << std::endl;
+      result = 1;
+    }
+
+  // the vectors of unknowns are accounted, but never evicted
+  for (int step = 0; step < 4; ++step)
+    cache.setUnknowns(step,std::make_shared<const Vector>(n));
+  if (policy->bytesUsed() != 4*bytes || inCache(cache,0,1))
+    {
+      std::cerr << "wrong eviction with vectors of unknowns beyond the budget" << std::endl;
+      result = 1;
+    }
+  for (int step = 0; step < 4; ++step)
+    cache.getUnknowns(step);
+
+  // a smaller budget takes effect when the next item is stored
+  policy->setBudget(0);
+  cache.setUnknowns(4,std::make_shared<const Vector>(n));
+  if (policy->bytesUsed() != 5*bytes)
+    {
+      std::cerr << "cached values were kept beyond an empty budget" << std::endl;
+      result = 1;
+    }
+  return result;
+}
+
+// items sharing the storage of another step are accounted once
+int testSharedStorage()
+{
+  std::shared_ptr<ReusingPolicy> policy(new ReusingPolicy(10*bytes));
+  Cache cache(policy);
+  int result = 0;
+
+  cache.setJacobian(0,1,std::make_shared<const Vector>(2*n));
+  std::shared_ptr<const Vector> reused = cache.getJacobian(0,2);
+  if (reused != cache.getJacobian(0,1) || policy->bytesUsed() != 2*bytes)
+    {
+      std::cerr << "reused Jacobian was accounted twice" << std::endl;
+      result = 1;
+    }
+
+  cache.flushAll();
+  if (policy->bytesUsed() != 0)
+    {
+      std::cerr << policy->bytesUsed() << " bytes accounted after flushing the cache" << std::endl;
+      result = 1;
+    }
+  return result;
+}
+
+// evicted vectors of unknowns are recycled if nobody else references them
+int testRecycling()
+{
+  Cache cache;
+  int result = 0;
+
+  std::shared_ptr<Vector> u0 = cache.makeUnknowns(n);
+  const Vector* storage = u0.get();
+  cache.setUnknowns(0,u0);
+  u0.reset();
+  std::shared_ptr<Vector> u1 = cache.makeUnknowns(n);
+  cache.setUnknowns(1,u1);
+  cache.setUnknowns(2,std::make_shared<const Vector>(n));
+
+  // u_0 and u_1 are stale for a one step scheme computing u_3, only u_0 is
+  // not referenced anymore, and u_2 was not created by the cache
+  cache.preStep(3,1,3.0,1.0);
+  if (cache.pooledUnknowns() != 1)
+    {
+      std::cerr << cache.pooledUnknowns() << " instead of 1 vectors kept for recycling" << std::endl;
+      result = 1;
+    }
+  if (cache.makeUnknowns(n).get() != storage)
+    {
+      std::cerr << "evicted vector was not recycled" << std::endl;
+      result = 1;
+    }
+
+  cache.setPoolCapacity(0);
+  cache.setUnknowns(3,cache.makeUnknowns(n));
+  cache.preStep(5,1,5.0,1.0);
+  if (cache.pooledUnknowns() != 0)
+    {
+      std::cerr << "vectors kept beyond the pool capacity" << std::endl;
+      result = 1;
+    }
+  return result;
+}
+
+// containers without a footprint only work with policies that do not need it
+int testOpaque()
+{
+  typedef Dune::PDELab::MultiStepCache<Opaque,Opaque,Opaque> OpaqueCache;
+  int result = 0;
+
+  OpaqueCache cache;
+  cache.setResidualValue(0,1,std::make_shared<const Opaque>(n));
+  cache.setUnknowns(0,cache.makeUnknowns(n));
+  cache.getResidualValue(0,1);
+
+  OpaqueCache bounded(std::make_shared<BoundedPolicy>(bytes));
+  try {
+    bounded.setResidualValue(0,1,std::make_shared<const Opaque>(n));
+  }
+  catch (Dune::PDELab::CacheError&)
+    {
+      return result;
+    }
+  std::cerr << "memory bounded policy accepted a container without footprint" << std::endl;
+  return 1;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    int result = 0;
+    result += testEviction();
+    result += testSharedStorage();
+    result += testRecycling();
+    result += testOpaque();
+    return result > 0 ? 1 : 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,138 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/flags.hh>
+#include <dune/pdelab/localoperator/pattern.hh>
+#include <dune/pdelab/newton/newton.hh>
+
+// atan(u-1) = 0 on every element. Full Newton steps diverge for |u-1| > 1.39,
+// so the Newton iteration only converges with a line search.
+class Arctan
+  : public Dune::PDELab::FullVolumePattern,
+    public Dune::PDELab::LocalOperatorDefaultFlags
+{
+public:
+  enum { doPatternVolume = true };
+  enum { doAlphaVolume = true };
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    r.accumulate(lfsv,0,std::atan(x(lfsu,0)-1.0)*eg.geometry().volume());
+  }
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename M>
+  void jacobian_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, M& mat) const
+  {
+    const double d = x(lfsu,0)-1.0;
+    mat.accumulate(lfsv,0,lfsu,0,eg.geometry().volume()/(1.0+d*d));
+  }
+};
+
+// solves the problem from u = 5 and returns the number of Newton iterations, 0 on failure
+template<typename GO, typename V>
+unsigned int solve(const char* name, GO& go,
+                   typename Dune::PDELab::Newton<GO,Dune::PDELab::ISTLBackend_SEQ_BCGS_SSOR,V>::Backtracking backtracking,
+                   double reassemble_threshold)
+{
+  typedef Dune::PDELab::ISTLBackend_SEQ_BCGS_SSOR LS;
+  LS ls(5000,0);
+  V x(go.trialGridFunctionSpace(),5.0);
+  Dune::PDELab::Newton<GO,LS,V> newton(go,x,ls);
+  newton.setVerbosityLevel(0);
+  newton.setReduction(1e-10);
+  newton.setLineSearchBacktracking(backtracking);
+  newton.setReassembleThreshold(reassemble_threshold);
+  try {
+    newton.apply();
+  }
+  catch (Dune::PDELab::NewtonError& e)
+    {
+      std::cerr << name << ": " << e.what() << std::endl;
+      return 0;
+    }
+  V error(go.trialGridFunctionSpace(),1.0);
+  error -= x;
+  if (error.infinity_norm() > 1e-8)
+    {
+      std::cerr << name << ": converged to a wrong solution" << std::endl;
+      return 0;
+    }
+  std::cout << name << ": " << newton.result().iterations << " iterations" << std::endl;
+  return newton.result().iterations;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(4));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    GV gv = grid.leafGridView();
+
+    Dune::GeometryType gt;
+    gt.makeCube(2);
+    typedef Dune::PDELab::P0LocalFiniteElementMap<double,double,2> FEM;
+    FEM fem(gt);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    Arctan lop;
+    typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+    MBE mbe(1);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,Arctan,MBE,double,double,double> GO;
+    GO go(gfs,gfs,lop,mbe);
+    typedef GO::Traits::Domain V;
+    typedef Dune::PDELab::Newton<GO,Dune::PDELab::ISTLBackend_SEQ_BCGS_SSOR,V> Solver;
+
+    int result = 0;
+
+    // the interpolating backtracking needs at most as many iterations as halving
+    const unsigned int damped = solve<GO,V>("damped",go,Solver::damped,0.0);
+    const unsigned int quadratic = solve<GO,V>("quadratic",go,Solver::quadratic,0.0);
+    const unsigned int cubic = solve<GO,V>("cubic",go,Solver::cubic,0.0);
+    if (damped == 0 || quadratic == 0 || cubic == 0)
+      result = 1;
+    else if (quadratic > damped || cubic > damped)
+      {
+        std::cerr << "interpolating backtracking needed more iterations than halving" << std::endl;
+        result = 1;
+      }
+
+    // with an outdated Jacobian the slope model does not hold, halving still converges
+    if (solve<GO,V>("cubic, outdated Jacobian",go,Solver::cubic,0.9) == 0)
+      result = 1;
+
+    return result;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,169 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/pdelab/ordering/permutationalgorithms.hh>
+
+using namespace Dune::PDELab::ordering;
+
+// The vertices of a structured grid of nx x ny bilinear elements, numbered in random order
+struct Mesh
+{
+  Mesh(std::size_t nx, std::size_t ny)
+    : element_offsets(1,0)
+  {
+    const std::size_t n = (nx+1)*(ny+1);
+    std::vector<std::size_t> number(n);
+    std::iota(number.begin(),number.end(),0);
+    std::shuffle(number.begin(),number.end(),std::mt19937(11));
+
+    points.resize(n);
+    for (std::size_t y = 0; y <= ny; ++y)
+      for (std::size_t x = 0; x <= nx; ++x)
+        {
+          points[number[y*(nx+1)+x]][0] = x;
+          points[number[y*(nx+1)+x]][1] = y;
+        }
+    for (std::size_t y = 0; y < ny; ++y)
+      for (std::size_t x = 0; x < nx; ++x)
+        {
+          element_blocks.push_back(number[y*(nx+1)+x]);
+          element_blocks.push_back(number[y*(nx+1)+x+1]);
+          element_blocks.push_back(number[(y+1)*(nx+1)+x]);
+          element_blocks.push_back(number[(y+1)*(nx+1)+x+1]);
+          element_offsets.push_back(element_blocks.size());
+        }
+  }
+
+  std::vector<Dune::FieldVector<double,2> > points;
+  std::vector<std::size_t> element_offsets;
+  std::vector<std::size_t> element_blocks;
+};
+
+bool isPermutation(std::vector<std::size_t> order, std::size_t n)
+{
+  if (order.size() != n)
+    return false;
+  std::sort(order.begin(),order.end());
+  for (std::size_t k = 0; k < n; ++k)
+    if (order[k] != k)
+      return false;
+  return true;
+}
+
+// maximum distance of two adjacent vertices and sum of the distances of every vertex to its
+// first neighbor in the new order, where order[k] is the vertex at position k
+void bandwidth(const DOFAdjacencyGraph& graph, const std::vector<std::size_t>& order,
+               std::size_t& width, std::size_t& profile)
+{
+  std::vector<std::size_t> position(order.size());
+  for (std::size_t k = 0; k < order.size(); ++k)
+    position[order[k]] = k;
+  width = 0;
+  profile = 0;
+  for (std::size_t v = 0; v < graph.size(); ++v)
+    {
+      std::size_t first = position[v];
+      for (const std::size_t* n = graph.beginNeighbors(v); n != graph.endNeighbors(v); ++n)
+        {
+          width = std::max(width,std::size_t(std::abs(long(position[*n]) - long(position[v]))));
+          first = std::min(first,position[*n]);
+        }
+      profile += position[v] - first;
+    }
+}
+
+int check(const char* name, const DOFAdjacencyGraph& graph, const std::vector<std::size_t>& order,
+          std::size_t max_width, std::size_t max_profile)
+{
+  if (!isPermutation(order,graph.size()))
+    {
+      std::cerr << name << " is not a permutation" << std::endl;
+      return 1;
+    }
+  std::size_t width, profile;
+  bandwidth(graph,order,width,profile);
+  std::cout << name << ": bandwidth " << width << ", profile " << profile << std::endl;
+  if (width > max_width || profile > max_profile)
+    {
+      std::cerr << name << " exceeds bandwidth " << max_width << " or profile " << max_profile << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    const std::size_t nx = 60;
+    const std::size_t ny = 25;
+    Mesh mesh(nx,ny);
+    const std::size_t n = mesh.points.size();
+    DOFAdjacencyGraph graph(n,mesh.element_offsets,mesh.element_blocks);
+
+    int result = 0;
+
+    // the random numbering couples vertices all over the matrix
+    std::vector<std::size_t> identity(n);
+    std::iota(identity.begin(),identity.end(),0);
+    std::size_t random_width, random_profile;
+    bandwidth(graph,identity,random_width,random_profile);
+    std::cout << "random: bandwidth " << random_width << ", profile " << random_profile << std::endl;
+
+    // the levels grown from a corner contain at most about ny+2 vertices, which bounds the bandwidth
+    std::vector<std::size_t> order;
+    reverse_cuthill_mckee(graph,order);
+    result += check("reverse Cuthill-McKee",graph,order,2*(ny+2),2*(ny+2)*n);
+
+    // the curves and nested dissection do not bound the bandwidth, as neighbors can end up in
+    // different halves of the order, but they move most entries close to the diagonal
+    space_filling_curve(mesh.points,true,order);
+    result += check("Hilbert curve",graph,order,random_width-1,random_profile/8);
+
+    space_filling_curve(mesh.points,false,order);
+    result += check("Morton curve",graph,order,random_width-1,random_profile/8);
+
+    nested_dissection(graph,order,16);
+    result += check("nested dissection",graph,order,random_width-1,random_profile/4);
+
+    // disconnected graphs are ordered completely
+    std::vector<std::size_t> offsets(1,0), blocks;
+    for (std::size_t e = 0; e < 10; ++e)
+      {
+        blocks.push_back(2*e);
+        blocks.push_back(2*e+1);
+        offsets.push_back(blocks.size());
+      }
+    DOFAdjacencyGraph pairs(20,offsets,blocks);
+    reverse_cuthill_mckee(pairs,order);
+    result += check("reverse Cuthill-McKee of a disconnected graph",pairs,order,1,10);
+    nested_dissection(pairs,order,1);
+    result += check("nested dissection of a disconnected graph",pairs,order,1,10);
+
+    return result > 0 ? 1 : 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
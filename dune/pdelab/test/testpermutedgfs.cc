@@ -0,0 +1,161 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/backendselector.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include <dune/pdelab/ordering/permutedordering.hh>
+
+typedef Dune::PDELab::ordering::Permuted<Dune::PDELab::DefaultLeafOrderingTag> Tag;
+typedef Dune::PDELab::ordering::PermutationAlgorithm Algorithm;
+
+bool isPermutation(std::vector<std::size_t> p, std::size_t n)
+{
+  if (p.size() != n)
+    return false;
+  std::sort(p.begin(),p.end());
+  for (std::size_t k = 0; k < n; ++k)
+    if (p[k] != k)
+      return false;
+  return true;
+}
+
+// the permutation of the tag has to be a bijection of the DOF blocks which
+// differs from the identity, and the container indices of all elements have
+// to cover the vector
+template<typename GFS>
+int check(const std::string& name, const GFS& gfs, std::size_t blocks)
+{
+  int errors = 0;
+  const std::vector<std::size_t>& permutation = gfs.orderingTag().permutation();
+  if (gfs.blockCount() != blocks)
+    {
+      std::cerr << name << ": " << gfs.blockCount() << " instead of " << blocks << " blocks" << std::endl;
+      ++errors;
+    }
+  if (!isPermutation(permutation,blocks))
+    {
+      std::cerr << name << ": the permutation of size " << permutation.size()
+                << " is not a bijection of " << blocks << " blocks" << std::endl;
+      ++errors;
+    }
+  std::size_t fixed = 0;
+  for (std::size_t k = 0; k < permutation.size(); ++k)
+    fixed += permutation[k] == k;
+  if (fixed == permutation.size())
+    {
+      std::cerr << name << ": the permutation has not been computed" << std::endl;
+      ++errors;
+    }
+
+  typedef Dune::PDELab::LocalFunctionSpace<GFS> LFS;
+  LFS lfs(gfs);
+  Dune::PDELab::LFSIndexCache<LFS> cache(lfs);
+  std::vector<bool> touched(blocks,false);
+  for (const auto& cell : elements(gfs.gridView()))
+    {
+      lfs.bind(cell);
+      cache.update();
+      for (std::size_t i = 0; i < cache.size(); ++i)
+        {
+          const std::size_t index = cache.containerIndex(i).back();
+          if (index >= blocks)
+            {
+              std::cerr << name << ": container index " << index << " out of range" << std::endl;
+              return errors + 1;
+            }
+          touched[index] = true;
+        }
+    }
+  if (std::count(touched.begin(),touched.end(),false) > 0)
+    {
+      std::cerr << name << ": " << std::count(touched.begin(),touched.end(),false)
+                << " container indices are not used by any element" << std::endl;
+      ++errors;
+    }
+
+  typedef typename Dune::PDELab::BackendVectorSelector<GFS,double>::Type V;
+  V x(gfs,0.0);
+  if (x.N() != blocks)
+    {
+      std::cerr << name << ": vector of size " << x.N() << " for " << blocks << " blocks" << std::endl;
+      ++errors;
+    }
+  return errors;
+}
+
+// updates a space on an 8x8 grid, refines the grid and updates it again
+int run(Algorithm::type algorithm, const std::string& name)
+{
+  Dune::FieldVector<double,2> L(1.0);
+  Dune::array<int,2> N(Dune::fill_array<int,2>(8));
+  Dune::YaspGrid<2> grid(L,N);
+
+  typedef Dune::YaspGrid<2>::LeafGridView GV;
+  GV gv = grid.leafGridView();
+
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+  FEM fem(gv);
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                          Dune::PDELab::ISTLVectorBackend<>,Tag> GFS;
+  GFS gfs(gv,fem,Dune::PDELab::NoConstraints(),Dune::PDELab::ISTLVectorBackend<>(),Tag(algorithm));
+  gfs.update();
+
+  int errors = check(name,gfs,gv.size(2));
+
+  grid.globalRefine(1);
+  gfs.update();
+  errors += check(name + ", refined",gfs,gv.size(2));
+
+  GFS fresh(gv,fem,Dune::PDELab::NoConstraints(),Dune::PDELab::ISTLVectorBackend<>(),Tag(algorithm));
+  fresh.update();
+  if (fresh.orderingTag().permutation() != gfs.orderingTag().permutation())
+    {
+      std::cerr << name << ": the updated permutation differs from the one of a new space" << std::endl;
+      ++errors;
+    }
+  return errors;
+}
+
+// A grid function space with an automatically permuted ordering has to
+// compute a bijective permutation on update(), and after refining the grid
+// the next update() has to recompute it for the new DOF blocks, exactly as
+// for a space constructed on the refined grid.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    int errors = 0;
+    errors += run(Algorithm::reverseCuthillMcKee,"reverse Cuthill-McKee");
+    errors += run(Algorithm::hilbertCurve,"Hilbert curve");
+    errors += run(Algorithm::mortonCurve,"Morton curve");
+    errors += run(Algorithm::nestedDissection,"nested dissection");
+
+    return errors > 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
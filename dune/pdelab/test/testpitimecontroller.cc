@@ -0,0 +1,181 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <iostream>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/pdelab/instationary/onestep.hh>
+
+typedef Dune::PDELab::PITimeController<double> Controller;
+
+// report failures to the controller until it gives up, returns the number of retries
+unsigned int retryUntilRefused(Controller& controller, double& dt)
+{
+  unsigned int retries = 0;
+  while (true)
+    {
+      try {
+        controller.failedStep(dt);
+      }
+      catch (Dune::PDELab::TimeStepControlError&)
+        {
+          return retries;
+        }
+      dt = controller.suggestTimestep(0.0,dt);
+      ++retries;
+    }
+}
+
+// a step with an error below the tolerance is accepted and enlarges the next step
+int testAccept()
+{
+  Controller controller(1e-3);
+  const double dt = 0.1;
+  if (!controller.acceptStep(dt,0.5,2))
+    {
+      std::cerr << "step with scaled error 0.5 was rejected" << std::endl;
+      return 1;
+    }
+  const double next = controller.suggestTimestep(0.0,dt);
+  if (next <= dt || next > 5.0*dt)
+    {
+      std::cerr << "unexpected time step " << next << " after accepted step" << std::endl;
+      return 1;
+    }
+  return controller.acceptedSteps() == 1 && controller.rejectedSteps() == 0 ? 0 : 1;
+}
+
+// a step with a too large error is rejected, the retry does not enlarge the step again
+int testReject()
+{
+  Controller controller(1e-3);
+  const double dt = 0.1;
+  if (controller.acceptStep(dt,4.0,2))
+    {
+      std::cerr << "step with scaled error 4 was accepted" << std::endl;
+      return 1;
+    }
+  const double retry = controller.suggestTimestep(0.0,dt);
+  if (retry >= dt || retry < 0.2*dt)
+    {
+      std::cerr << "unexpected time step " << retry << " after rejected step" << std::endl;
+      return 1;
+    }
+  if (!controller.acceptStep(retry,1e-6,2) || controller.suggestTimestep(0.0,retry) > retry)
+    {
+      std::cerr << "time step increased right after a rejection" << std::endl;
+      return 1;
+    }
+  return controller.rejectedSteps() == 1 ? 0 : 1;
+}
+
+// a solver failure that does not depend on the time step must not be retried forever
+int testFailure()
+{
+  int result = 0;
+
+  // the default minimum time step is relative to the first time step
+  {
+    Controller controller(1e-3);
+    controller.setMaxRejections(1000);
+    double dt = 1.0;
+    const unsigned int retries = retryUntilRefused(controller,dt);
+    if (dt < controller.minimumTimestep() || dt*0.2 >= controller.minimumTimestep() || retries > 20)
+      {
+        std::cerr << "failing step gave up at time step " << dt << " after " << retries << " retries" << std::endl;
+        result = 1;
+      }
+  }
+
+  // the number of consecutive rejections is limited
+  {
+    Controller controller(1e-3);
+    controller.setMaxRejections(3);
+    controller.setTimestepLimits(1e-300,1e100);
+    double dt = 1.0;
+    const unsigned int retries = retryUntilRefused(controller,dt);
+    if (retries != 3)
+      {
+        std::cerr << "failing step was retried " << retries << " instead of 3 times" << std::endl;
+        result = 1;
+      }
+
+    // rejections by the error estimate are subject to the same limit and fail the same way
+    bool thrown = false;
+    try {
+      controller.acceptStep(dt,10.0,2);
+    }
+    catch (Dune::PDELab::TimeStepControlError&)
+      {
+        thrown = true;
+      }
+    if (!thrown)
+      {
+        std::cerr << "rejection beyond the limit did not throw" << std::endl;
+        result = 1;
+      }
+
+    // an accepted step resets the count
+    controller.acceptStep(dt,0.5,2);
+    if (retryUntilRefused(controller,dt) != 3)
+      {
+        std::cerr << "accepted step did not reset the rejection count" << std::endl;
+        result = 1;
+      }
+  }
+
+  return result;
+}
+
+// the time step passed by the caller is only used until the controller proposes one
+int testProposal()
+{
+  Controller controller(1e-3);
+  if (controller.suggestTimestep(0.0,0.1) != 0.1)
+    {
+      std::cerr << "initial time step was not taken from the caller" << std::endl;
+      return 1;
+    }
+  controller.acceptStep(0.1,0.5,2);
+  const double proposed = controller.suggestTimestep(0.0,0.1);
+  if (controller.suggestTimestep(0.1,1e-6) != proposed)
+    {
+      std::cerr << "time step of the caller overrode the proposal of the controller" << std::endl;
+      return 1;
+    }
+  controller.reset();
+  if (controller.suggestTimestep(0.1,0.05) != 0.05)
+    {
+      std::cerr << "reset() did not discard the proposal" << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    int result = 0;
+    result += testAccept();
+    result += testReject();
+    result += testFailure();
+    result += testProposal();
+    return result > 0 ? 1 : 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
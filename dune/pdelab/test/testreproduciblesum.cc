@@ -0,0 +1,165 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/pdelab/common/reproduciblesum.hh>
+
+using Dune::PDELab::ReproducibleSum;
+
+template<typename It>
+double sum(It begin, It end)
+{
+  ReproducibleSum s;
+  for (; begin != end; ++begin)
+    s += *begin;
+  return s.value();
+}
+
+int check(const char* what, double result, double expected)
+{
+  if (result == expected)
+    return 0;
+  std::cerr.precision(17);
+  std::cerr << what << ": got " << result << " instead of " << expected << std::endl;
+  return 1;
+}
+
+// summands of very different magnitude and sign
+std::vector<double> summands()
+{
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> fraction(-1.0,1.0);
+  std::uniform_int_distribution<int> exponent(-60,60);
+  std::vector<double> values(10000);
+  for (auto& v : values)
+    v = std::ldexp(fraction(generator),exponent(generator));
+  return values;
+}
+
+// the result does not depend on the order of the summands or on how they are split
+int testOrder(const Dune::MPIHelper& helper)
+{
+  std::vector<double> values = summands();
+  const double reference = sum(values.begin(),values.end());
+  int result = 0;
+
+  result += check("reversed order",sum(values.rbegin(),values.rend()),reference);
+  std::shuffle(values.begin(),values.end(),std::mt19937(7));
+  result += check("shuffled order",sum(values.begin(),values.end()),reference);
+  std::sort(values.begin(),values.end());
+  result += check("sorted order",sum(values.begin(),values.end()),reference);
+
+  // partial sums, e.g. of several threads, in any order
+  std::vector<ReproducibleSum> parts(7);
+  for (std::size_t i = 0; i < values.size(); ++i)
+    parts[(i * 13) % parts.size()] += values[i];
+  ReproducibleSum combined;
+  for (std::size_t p = parts.size(); p > 0; --p)
+    combined += parts[p-1];
+  result += check("combined partial sums",combined.value(),reference);
+
+  // partial sums of all ranks
+  const auto& comm = helper.getCollectiveCommunication();
+  ReproducibleSum distributed;
+  for (std::size_t i = comm.rank(); i < values.size(); i += comm.size())
+    distributed += values[i];
+  distributed.allreduce(comm);
+  result += check("distributed sum",distributed.value(),reference);
+
+  return result;
+}
+
+// cancellation does not lose the small summands
+int testCancellation()
+{
+  int result = 0;
+
+  std::vector<double> values;
+  values.push_back(1e100);
+  values.push_back(1.0);
+  values.push_back(-1e100);
+  result += check("1e100 + 1 - 1e100",sum(values.begin(),values.end()),1.0);
+
+  values = summands();
+  const std::size_t n = values.size();
+  for (std::size_t i = 0; i < n; ++i)
+    values.push_back(-values[i]);
+  values.push_back(std::ldexp(1.0,-70));
+  std::shuffle(values.begin(),values.end(),std::mt19937(3));
+  result += check("cancelling summands",sum(values.begin(),values.end()),std::ldexp(1.0,-70));
+
+  // the exact sum of 0.1 + 0.2 - 0.3 is not zero, as none of them is representable
+  values.clear();
+  values.push_back(0.1);
+  values.push_back(0.2);
+  values.push_back(-0.3);
+  result += check("0.1 + 0.2 - 0.3",sum(values.begin(),values.end()),std::ldexp(1.0,-55));
+
+  const double max = std::numeric_limits<double>::max();
+  values.clear();
+  values.push_back(max);
+  values.push_back(max);
+  values.push_back(-max);
+  result += check("intermediate result above the range of double",sum(values.begin(),values.end()),max);
+
+  return result;
+}
+
+// subnormal numbers are summed exactly
+int testSubnormals()
+{
+  int result = 0;
+  const double tiny = std::numeric_limits<double>::denorm_min();
+  const double min = std::numeric_limits<double>::min();
+
+  std::vector<double> values(1000,tiny);
+  result += check("sum of subnormals",sum(values.begin(),values.end()),1000 * tiny);
+
+  values.assign(1,min);
+  values.push_back(-tiny);
+  result += check("smallest normal number minus a subnormal",sum(values.begin(),values.end()),min - tiny);
+
+  values.assign(1,1.0);
+  values.push_back(tiny);
+  values.push_back(-1.0);
+  result += check("subnormal next to 1",sum(values.begin(),values.end()),tiny);
+
+  values.assign(1,-3 * tiny);
+  result += check("negative subnormal",sum(values.begin(),values.end()),-3 * tiny);
+
+  return result;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    const Dune::MPIHelper& helper = Dune::MPIHelper::instance(argc, argv);
+
+    int result = 0;
+    result += testOrder(helper);
+    result += testCancellation();
+    result += testSubnormals();
+    return result > 0 ? 1 : 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,206 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/gridoperator/onestep.hh>
+#include <dune/pdelab/instationary/onestep.hh>
+#include <dune/pdelab/localoperator/l2.hh>
+#include <dune/pdelab/localoperator/laplacedirichletccfv.hh>
+#include <dune/pdelab/stationary/linearproblem.hh>
+
+// initial value and Dirichlet boundary value
+template<typename GV, typename RF>
+class G
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  G<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,G<GV,RF> > BaseT;
+
+  G (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.3);
+    center -= x;
+    y = std::exp(-10.0*center.two_norm2());
+  }
+};
+
+// the finite volume Laplacian as spatial part of an instationary problem
+template<typename GF>
+class Diffusion
+  : public Dune::PDELab::LaplaceDirichletCCFV<GF>,
+    public Dune::PDELab::InstationaryLocalOperatorDefaultMethods<double>
+{
+public:
+  Diffusion (const GF& g) : Dune::PDELab::LaplaceDirichletCCFV<GF>(g) {}
+};
+
+// forwards to the linear problem solver and counts the solves with a reused matrix
+template<typename Solver, typename V>
+class CountingSolver
+{
+public:
+  typedef typename Solver::Result Result;
+
+  CountingSolver (Solver& solver_) : solver(solver_), solves(0), reused(0) {}
+
+  void apply (V& x, bool reuse_matrix = false)
+  {
+    ++solves;
+    if (reuse_matrix)
+      ++reused;
+    solver.apply(x,reuse_matrix);
+  }
+
+  const Result& result () const
+  {
+    return solver.result();
+  }
+
+  Solver& solver;
+  int solves;
+  int reused;
+};
+
+// runs the given steps of the two stage SDIRK scheme and returns the number
+// of solves that reused the matrix
+template<typename IGO, typename V>
+int solve (IGO& igo, V& x, const std::vector<double>& dts, bool reuse)
+{
+  typedef Dune::PDELab::ISTLBackend_SEQ_BCGS_SSOR LS;
+  LS ls(5000,0);
+  typedef Dune::PDELab::StationaryLinearProblemSolver<IGO,LS,V> Solver;
+  Solver solver(igo,ls,x,1e-12,1e-99,0);
+  CountingSolver<Solver,V> counting(solver);
+  Dune::PDELab::Alexander2Parameter<double> alexander2;
+  Dune::PDELab::OneStepMethod<double,IGO,CountingSolver<Solver,V>,V,V> osm(alexander2,igo,counting);
+  osm.setVerbosityLevel(0);
+  osm.setStageMatrixReuse(reuse);
+  V xnew(x);
+  double time = 0.0;
+  for (const double dt : dts)
+    {
+      osm.apply(time,dt,x,xnew);
+      x = xnew;
+      time += dt;
+    }
+  return counting.reused;
+}
+
+// Reusing the stage matrix has to yield the same solution as assembling it
+// for every stage, and the matrix must be reused exactly as long as the
+// diagonal coefficient, the time step and, if declared, the time agree.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+    Dune::YaspGrid<2> grid(L,N);
+    grid.globalRefine(3);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    typedef double RF;
+    GV gv = grid.leafGridView();
+
+    Dune::GeometryType gt;
+    gt.makeCube(2);
+    typedef Dune::PDELab::P0LocalFiniteElementMap<double,RF,2> FEM;
+    FEM fem(gt);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef G<GV,RF> GType;
+    GType g(gv);
+
+    typedef Diffusion<GType> LOP;
+    LOP lop(g);
+    typedef Dune::PDELab::L2 TLOP;
+    TLOP tlop(2);
+
+    typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+    MBE mbe(5);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF> GO0;
+    GO0 go0(gfs,gfs,lop,mbe);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,TLOP,MBE,RF,RF,RF> GO1;
+    GO1 go1(gfs,gfs,tlop,mbe);
+    typedef Dune::PDELab::OneStepGridOperator<GO0,GO1> IGO;
+    IGO igo(go0,go1);
+
+    typedef IGO::Traits::Domain V;
+    V xinit(gfs);
+    Dune::PDELab::interpolate(g,gfs,xinit);
+
+    // five steps, then two steps with half the time step
+    std::vector<double> dts(5,0.01);
+    dts.push_back(0.005);
+    dts.push_back(0.005);
+
+    int result = 0;
+
+    V xref(xinit);
+    solve(igo,xref,dts,false);
+
+    // by default, the operators are time dependent and the stage times differ
+    V x(xinit);
+    int reused = solve(igo,x,dts,true);
+    if (reused != 0)
+      {
+        std::cerr << "matrix of a time dependent operator reused in " << reused << " solves" << std::endl;
+        result = 1;
+      }
+
+    // otherwise only the first solve and the first one after the change of dt assemble
+    igo.setTimeDependentJacobian(false,false);
+    x = xinit;
+    reused = solve(igo,x,dts,true);
+    if (reused != 2*int(dts.size()) - 2)
+      {
+        std::cerr << "matrix reused in " << reused << " instead of " << 2*dts.size() - 2
+                  << " solves" << std::endl;
+        result = 1;
+      }
+
+    V difference(x);
+    difference -= xref;
+    if (difference.two_norm() > 1e-8*xref.two_norm())
+      {
+        std::cerr << "solution with reused matrices differs by " << difference.two_norm() << std::endl;
+        result = 1;
+      }
+
+    return result;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
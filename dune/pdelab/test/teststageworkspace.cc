@@ -0,0 +1,249 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/backendselector.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/gridoperator/onestep.hh>
+#include <dune/pdelab/instationary/onestep.hh>
+#include <dune/pdelab/localoperator/l2.hh>
+#include <dune/pdelab/localoperator/laplacedirichletccfv.hh>
+#include <dune/pdelab/stationary/linearproblem.hh>
+
+// initial value and Dirichlet boundary value
+template<typename GV, typename RF>
+class G
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  G<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,G<GV,RF> > BaseT;
+
+  G (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.3);
+    center -= x;
+    y = std::exp(-10.0*center.two_norm2());
+  }
+};
+
+// the finite volume Laplacian as spatial part of an instationary problem
+template<typename GF>
+class Diffusion
+  : public Dune::PDELab::LaplaceDirichletCCFV<GF>,
+    public Dune::PDELab::InstationaryLocalOperatorDefaultMethods<double>
+{
+public:
+  Diffusion (const GF& g) : Dune::PDELab::LaplaceDirichletCCFV<GF>(g) {}
+};
+
+// one step of the implicit scheme with a newly constructed method and solver
+template<typename IGO, typename V>
+class FreshImplicit
+{
+public:
+  FreshImplicit (IGO& igo_) : igo(igo_) {}
+
+  void apply (const Dune::PDELab::TimeSteppingParameterInterface<double>& method,
+              double time, double dt, V& xold, V& xnew)
+  {
+    typedef Dune::PDELab::ISTLBackend_SEQ_BCGS_SSOR LS;
+    LS ls(5000,0);
+    typedef Dune::PDELab::StationaryLinearProblemSolver<IGO,LS,V> Solver;
+    Solver solver(igo,ls,xnew,1e-12,1e-99,0);
+    Dune::PDELab::OneStepMethod<double,IGO,Solver,V,V> osm(method,igo,solver);
+    osm.setVerbosityLevel(0);
+    osm.apply(time,dt,xold,xnew);
+  }
+
+private:
+  IGO& igo;
+};
+
+// one step of the explicit scheme with a newly constructed method
+template<typename IGO, typename V>
+class FreshExplicit
+{
+public:
+  FreshExplicit (IGO& igo_) : igo(igo_) {}
+
+  void apply (const Dune::PDELab::TimeSteppingParameterInterface<double>& method,
+              double time, double dt, V& xold, V& xnew)
+  {
+    Dune::PDELab::ISTLBackend_SEQ_ExplicitDiagonal ls;
+    Dune::PDELab::ExplicitOneStepMethod<double,IGO,Dune::PDELab::ISTLBackend_SEQ_ExplicitDiagonal,V,V>
+      osm(method,igo,ls);
+    osm.setVerbosityLevel(0);
+    osm.apply(time,dt,xold,xnew);
+  }
+
+private:
+  IGO& igo;
+};
+
+// runs a few steps with the given method on the kept object and with fresh
+// objects; the kept stage vectors must not change a single bit of the result
+template<typename OSM, typename Fresh, typename GFS, typename GF>
+int compare (const std::string& name, OSM& osm, Fresh& fresh, const GFS& gfs, const GF& g,
+             const Dune::PDELab::TimeSteppingParameterInterface<double>& method, double dt)
+{
+  typedef typename Dune::PDELab::BackendVectorSelector<GFS,double>::Type V;
+  V x(gfs);
+  Dune::PDELab::interpolate(g,gfs,x);
+  V xfresh(x);
+  V xinit(x);
+  V xnew(x);
+
+  osm.setMethod(method);
+  double time = 0.0;
+  for (int i = 0; i < 3; ++i)
+    {
+      xnew = x;
+      osm.apply(time,dt,x,xnew);
+      x = xnew;
+      xnew = xfresh;
+      fresh.apply(method,time,dt,xfresh,xnew);
+      xfresh = xnew;
+      time += dt;
+    }
+
+  int errors = 0;
+  xinit -= x;
+  if (xinit.two_norm() < 1e-6*x.two_norm())
+    {
+      std::cerr << name << ": solution did not evolve" << std::endl;
+      ++errors;
+    }
+  xfresh -= x;
+  if (xfresh.infinity_norm() != 0.0)
+    {
+      std::cerr << name << ": kept workspace changes the solution by "
+                << xfresh.infinity_norm() << std::endl;
+      ++errors;
+    }
+  return errors;
+}
+
+// The stage vectors kept across time steps must give the same solution as
+// newly allocated ones, also after switching to a scheme with more stages,
+// after the grid has been refined and after releasing them.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+    Dune::YaspGrid<2> grid(L,N);
+    grid.globalRefine(3);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    typedef double RF;
+    GV gv = grid.leafGridView();
+
+    Dune::GeometryType gt;
+    gt.makeCube(2);
+    typedef Dune::PDELab::P0LocalFiniteElementMap<double,RF,2> FEM;
+    FEM fem(gt);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef G<GV,RF> GType;
+    GType g(gv);
+
+    typedef Diffusion<GType> LOP;
+    LOP lop(g);
+    typedef Dune::PDELab::L2 TLOP;
+    TLOP tlop(2);
+
+    typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+    MBE mbe(5);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF> GO0;
+    GO0 go0(gfs,gfs,lop,mbe);
+    typedef Dune::PDELab::GridOperator<GFS,GFS,TLOP,MBE,RF,RF,RF> GO1;
+    GO1 go1(gfs,gfs,tlop,mbe);
+    typedef Dune::PDELab::OneStepGridOperator<GO0,GO1> IGO;
+    IGO igo(go0,go1);
+    typedef Dune::PDELab::OneStepGridOperator<GO0,GO1,false> EIGO;
+    EIGO eigo(go0,go1);
+
+    typedef IGO::Traits::Domain V;
+    V x(gfs,0.0);
+
+    typedef Dune::PDELab::ISTLBackend_SEQ_BCGS_SSOR LS;
+    LS ls(5000,0);
+    typedef Dune::PDELab::StationaryLinearProblemSolver<IGO,LS,V> Solver;
+    Solver solver(igo,ls,x,1e-12,1e-99,0);
+
+    Dune::PDELab::Alexander2Parameter<RF> alexander2;
+    Dune::PDELab::Alexander3Parameter<RF> alexander3;
+    Dune::PDELab::OneStepMethod<RF,IGO,Solver,V,V> osm(alexander2,igo,solver);
+    osm.setVerbosityLevel(0);
+    FreshImplicit<IGO,V> implicit(igo);
+
+    typedef Dune::PDELab::ISTLBackend_SEQ_ExplicitDiagonal ELS;
+    ELS els;
+    Dune::PDELab::HeunParameter<RF> heun;
+    Dune::PDELab::RK4Parameter<RF> rk4;
+    Dune::PDELab::ExplicitOneStepMethod<RF,EIGO,ELS,V,V> eosm(heun,eigo,els);
+    eosm.setVerbosityLevel(0);
+    FreshExplicit<EIGO,V> explicitly(eigo);
+
+    // below the stability limit 0.25 h^2 of the explicit Euler scheme on the refined grid
+    const RF dt = 0.01;
+    const RF edt = 0.0005;
+
+    int errors = 0;
+
+    // the workspace is allocated, reused, and grown for the schemes with more stages
+    errors += compare("implicit",osm,implicit,gfs,g,alexander2,dt);
+    errors += compare("implicit, more stages",osm,implicit,gfs,g,alexander3,dt);
+    errors += compare("implicit, fewer stages",osm,implicit,gfs,g,alexander2,dt);
+    errors += compare("explicit",eosm,explicitly,gfs,g,heun,edt);
+    errors += compare("explicit, more stages",eosm,explicitly,gfs,g,rk4,edt);
+
+    // the stage vectors no longer match the function space and are reallocated
+    grid.globalRefine(1);
+    gfs.update();
+    solver.discardMatrix();
+    errors += compare("implicit, refined",osm,implicit,gfs,g,alexander3,dt);
+    errors += compare("explicit, refined",eosm,explicitly,gfs,g,rk4,edt);
+
+    osm.releaseWorkspace();
+    eosm.releaseWorkspace();
+    errors += compare("implicit, released",osm,implicit,gfs,g,alexander3,dt);
+    errors += compare("explicit, released",eosm,explicitly,gfs,g,heun,edt);
+
+    return errors > 0;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
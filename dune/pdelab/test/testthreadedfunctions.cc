@@ -0,0 +1,124 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/backend/backendselector.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/common/functionutilities.hh>
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+
+// a smooth function that can be evaluated concurrently
+template<typename GV, typename RF>
+class F
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  F<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,F<GV,RF> > BaseT;
+
+  F (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    y = std::sin(3.0*x[0]) * std::exp(x[1]);
+  }
+};
+
+// The threaded variants have to reproduce the serial functions, with and
+// without OpenMP. The grid has more elements than one batch, so the batching
+// is exercised as well.
+int main(int argc, char** argv)
+{
+  try{
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(200));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    GV gv = grid.leafGridView();
+
+    typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+    FEM fem(gv);
+    typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+                                            Dune::PDELab::ISTLVectorBackend<> > GFS;
+    GFS gfs(gv,fem);
+
+    typedef F<GV,double> FType;
+    FType f(gv);
+
+    int result = 0;
+
+    // the coefficients are written in the element order, so they are identical
+    typedef Dune::PDELab::BackendVectorSelector<GFS,double>::Type V;
+    V serial(gfs,0.0);
+    Dune::PDELab::interpolate(f,gfs,serial);
+    V threaded(gfs,0.0);
+    Dune::PDELab::threadedInterpolate(f,gfs,threaded);
+    V difference(threaded);
+    difference -= serial;
+    if (difference.infinity_norm() != 0.0)
+      {
+        std::cerr << "threadedInterpolate() differs by " << difference.infinity_norm()
+                  << " from interpolate()" << std::endl;
+        result = 1;
+      }
+
+    // the integrals of the elements are summed up first, which only changes the rounding
+    FType::Traits::RangeType serial_integral, threaded_integral;
+    Dune::PDELab::integrateGridFunction(f,serial_integral,4);
+    Dune::PDELab::threadedIntegrateGridFunction(f,threaded_integral,4);
+    if (std::abs(threaded_integral[0] - serial_integral[0]) > 1e-12 * std::abs(serial_integral[0]))
+      {
+        std::cerr.precision(17);
+        std::cerr << "threadedIntegrateGridFunction() yields " << threaded_integral[0]
+                  << " instead of " << serial_integral[0] << std::endl;
+        result = 1;
+      }
+
+    // the result does not depend on the number of threads
+    FType::Traits::RangeType single_integral;
+#ifdef _OPENMP
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+    Dune::PDELab::threadedIntegrateGridFunction(f,single_integral,4);
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#endif
+    if (single_integral[0] != threaded_integral[0])
+      {
+        std::cerr << "threadedIntegrateGridFunction() depends on the number of threads" << std::endl;
+        result = 1;
+      }
+
+    return result;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,40 @@
+dnl DUNE_PDELAB_OPENMP
+dnl ------------------------------------------------------
+dnl Check for the compiler flags that enable OpenMP in C++, if requested
+dnl with --enable-pdelab-openmp.  The threaded code paths of dune-pdelab
+dnl (threadedInterpolate(), the bounding box tree, the sorted link
+dnl collection of BCRSPattern) are guarded by _OPENMP and fall back to
+dnl serial loops without these flags.  The flags are not added to the module
+dnl dependencies, targets that want the threaded code paths add
+dnl $(OPENMP_CXXFLAGS) to their compiler and linker flags.  The result is
+dnl recorded as follows:
+dnl
+dnl shell variables:
+dnl   ac_cv_prog_cxx_openmp
+dnl     compiler flag, "none needed" or "unsupported"
+dnl
+dnl Makefile variables:
+dnl   OPENMP_CXXFLAGS
+dnl     the compiler flag, also to be passed to the linker, empty unless
+dnl     OpenMP has been enabled
+AC_DEFUN([DUNE_PDELAB_OPENMP], [
+  AC_ARG_ENABLE([pdelab-openmp],
+    AS_HELP_STRING([--enable-pdelab-openmp],
+      [build the threaded code paths of dune-pdelab with OpenMP]),
+    [], [enable_pdelab_openmp=no])
+
+  AS_IF([test "x$enable_pdelab_openmp" = "xyes"], [
+    AC_LANG_PUSH([C++])
+    AC_OPENMP
+    AC_LANG_POP([C++])
+  ], [
+    OPENMP_CXXFLAGS=
+    AC_SUBST([OPENMP_CXXFLAGS])
+  ])
+
+  AS_IF([test "x$OPENMP_CXXFLAGS" != "x"], [
+    DUNE_ADD_SUMMARY_ENTRY([OpenMP], [yes ($OPENMP_CXXFLAGS)])
+  ], [
+    DUNE_ADD_SUMMARY_ENTRY([OpenMP], [no])
+  ])
+])
@@ -0,0 +1,58 @@
+dnl DUNE_PDELAB_STDTHREAD
+dnl ------------------------------------------------------
+dnl Check for the flags needed to compile and link programs that start a
+dnl std::thread, as AsyncVTKWriter does.  With some C++ runtimes, such
+dnl programs link without -pthread but fail when the thread is started, so
+dnl -pthread is preferred whenever the compiler accepts it.  The result is
+dnl recorded as follows:
+dnl
+dnl shell variables:
+dnl   dune_pdelab_cv_stdthread_flags
+dnl     the flag, "none needed" or "no"
+dnl
+dnl Makefile variables:
+dnl   STDTHREAD_FLAGS
+dnl     the flag, passed to the compiler and the linker
+AC_DEFUN([DUNE_PDELAB_STDTHREAD], [
+  AC_LANG_PUSH([C++])
+  AC_CACHE_CHECK(
+    [for the flags needed by std::thread],
+    [dune_pdelab_cv_stdthread_flags],
+    [
+      dune_pdelab_cv_stdthread_flags=no
+      dune_pdelab_save_CXXFLAGS="$CXXFLAGS"
+      dune_pdelab_save_LDFLAGS="$LDFLAGS"
+      for dune_pdelab_flags in -pthread "none needed"; do
+        AS_CASE(["$dune_pdelab_flags"],
+          ["none needed"], [dune_pdelab_flag=""],
+          [dune_pdelab_flag="$dune_pdelab_flags"])
+        CXXFLAGS="$dune_pdelab_save_CXXFLAGS $dune_pdelab_flag"
+        LDFLAGS="$dune_pdelab_save_LDFLAGS $dune_pdelab_flag"
+        AC_LINK_IFELSE([AC_LANG_PROGRAM([[
+#include <thread>
+void work() {}
+]], [[
+std::thread t(work);
+t.join();
+]])],
+          [dune_pdelab_cv_stdthread_flags="$dune_pdelab_flags"])
+        AS_IF([test "x$dune_pdelab_cv_stdthread_flags" != "xno"], [break])
+      done
+      CXXFLAGS="$dune_pdelab_save_CXXFLAGS"
+      LDFLAGS="$dune_pdelab_save_LDFLAGS"
+    ])
+  AC_LANG_POP([C++])
+
+  AS_CASE(["$dune_pdelab_cv_stdthread_flags"],
+    [no], [
+      AC_MSG_WARN([std::thread is not usable, AsyncVTKWriter will not work])
+      DUNE_ADD_SUMMARY_ENTRY([std::thread], [no])],
+    ["none needed"], [
+      AC_SUBST([STDTHREAD_FLAGS], [])
+      DUNE_ADD_SUMMARY_ENTRY([std::thread], [yes])],
+    [
+      AC_SUBST([STDTHREAD_FLAGS], [$dune_pdelab_cv_stdthread_flags])
+      DUNE_ADD_MODULE_DEPS([dune-pdelab], [STDTHREAD],
+        [$STDTHREAD_FLAGS], [$STDTHREAD_FLAGS], [])
+      DUNE_ADD_SUMMARY_ENTRY([std::thread], [yes ($STDTHREAD_FLAGS)])])
+])
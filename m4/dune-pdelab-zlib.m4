@@ -0,0 +1,26 @@
+dnl DUNE_PDELAB_ZLIB
+dnl ------------------------------------------------------
+dnl Check for zlib, which AsyncVTKWriter uses to compress its output.  The
+dnl result is recorded as follows:
+dnl
+dnl defines:
+dnl   HAVE_ZLIB
+dnl     undef or 1
+dnl
+dnl Makefile variables:
+dnl   ZLIB_LIBS
+dnl     -lz
+AC_DEFUN([DUNE_PDELAB_ZLIB], [
+  AC_LANG_PUSH([C])
+  dune_pdelab_zlib=no
+  AC_CHECK_HEADER([zlib.h],
+    [AC_CHECK_LIB([z], [compress2], [dune_pdelab_zlib=yes])])
+  AC_LANG_POP([C])
+
+  AS_IF([test "x$dune_pdelab_zlib" = "xyes"], [
+    AC_DEFINE([HAVE_ZLIB], [1], [Define to 1 if zlib is available.])
+    AC_SUBST([ZLIB_LIBS], [-lz])
+    DUNE_ADD_MODULE_DEPS([dune-pdelab], [ZLIB], [], [], [$ZLIB_LIBS])
+  ])
+  DUNE_ADD_SUMMARY_ENTRY([zlib], [$dune_pdelab_zlib])
+])